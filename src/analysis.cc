@@ -20,8 +20,27 @@
 
 #include "analysis.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
 namespace scram::core {
 
+double PeakMemory() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage))
+    return 0;
+#if defined(__APPLE__)
+  return usage.ru_maxrss / (1024.0 * 1024);  // Bytes.
+#else
+  return usage.ru_maxrss / 1024.0;  // Kilobytes.
+#endif
+#else
+  return 0;
+#endif
+}
+
 Analysis::Analysis(Settings settings)
     : settings_(std::move(settings)), analysis_time_(0) {}
 
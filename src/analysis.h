@@ -23,6 +23,8 @@
 #include <cassert>
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 
@@ -30,6 +32,19 @@
 
 namespace scram::core {
 
+/// Named measurement of analysis internals for performance diagnostics,
+/// e.g., graph sizes, table statistics, or throughput.
+struct Metric {
+  std::string name;  ///< The name of the measurement.
+  double value;  ///< The measured value.
+};
+
+/// Reads the peak resident memory of the process.
+///
+/// @returns The peak resident set size in megabytes.
+///          0 if the platform does not provide the information.
+double PeakMemory() noexcept;
+
 /// Base abstract class for all analysis with settings.
 class Analysis : private boost::noncopyable {
  public:
@@ -47,10 +62,24 @@ class Analysis : private boost::noncopyable {
   /// @returns Time taken by the analysis.
   double analysis_time() const { return analysis_time_; }
 
+  /// @returns Metrics of the analysis internals in the collection order.
+  const std::vector<Metric>& metrics() const { return metrics_; }
+
  protected:
   /// @returns Modifiable analysis settings.
   Settings& settings() { return settings_; }
 
+  /// @returns Modifiable metrics to collect measurements into.
+  std::vector<Metric>& metrics() { return metrics_; }
+
+  /// Records a measurement of the analysis.
+  ///
+  /// @param[in] name  The name of the measurement.
+  /// @param[in] value  The measured value.
+  void AddMetric(std::string name, double value) {
+    metrics_.push_back({std::move(name), value});
+  }
+
   /// Appends a warning message to the analysis warnings.
   /// Warnings are separated by spaces.
   ///
@@ -72,6 +101,7 @@ class Analysis : private boost::noncopyable {
   Settings settings_;  ///< All settings for analysis.
   double analysis_time_;  ///< Time taken by the analysis.
   std::string warnings_;  ///< Generated warnings in analysis.
+  std::vector<Metric> metrics_;  ///< Measurements of analysis internals.
 };
 
 }  // namespace scram::core
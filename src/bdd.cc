@@ -20,7 +20,12 @@
 
 #include "bdd.h"
 
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+
 #include <boost/multiprecision/miller_rabin.hpp>
+#include <boost/range/adaptor/reversed.hpp>
 #include <boost/range/algorithm.hpp>
 
 #include "ext/find_iterator.h"
@@ -79,8 +84,37 @@ Bdd::Bdd(const Pdag* graph, const Settings& settings)
   }
 }
 
+Bdd::Bdd(const Pdag* graph, const std::vector<GatePtr>& targets,
+         const Settings& settings)
+    : kSettings_(settings),
+      coherent_(graph->coherent()),
+      kOne_(new Terminal<Ite>(true)),
+      function_id_(2) {
+  TIMER(DEBUG3, "Converting shared PDAG into BDD");
+  root_ = {false, kOne_};
+  std::unordered_map<int, std::pair<Function, int>> gates;
+  for (const GatePtr& target : targets)
+    targets_.push_back(ConvertGraph(*target, &gates));
+  for (const Function& target : targets_)
+    TestStructure(target.vertex);
+  ClearMarks(false);
+  LOG(DEBUG4) << "# of BDD vertices created: " << function_id_ - 1;
+  LOG(DEBUG4) << "# of entries in unique table: " << unique_table_.size();
+  Freeze();
+}
+
 Bdd::~Bdd() noexcept = default;
 
+void Bdd::GatherMetrics(std::vector<Metric>* metrics) noexcept {
+  metrics->push_back({"bdd-vertices", double(function_id_ - 1)});
+  metrics->push_back({"bdd-unique-table-peak",
+                      double(unique_table_.peak_size())});
+  metrics->push_back({"bdd-compute-lookups", double(compute_stats_.lookups)});
+  metrics->push_back({"bdd-compute-hit-rate", compute_stats_.hit_rate()});
+  if (zbdd_)
+    zbdd_->GatherMetrics(metrics);
+}
+
 void Bdd::Analyze(const Pdag* graph) noexcept {
   zbdd_ = std::make_unique<Zbdd>(this, kSettings_);
   zbdd_->Analyze(graph);
@@ -133,36 +167,73 @@ ItePtr Bdd::FindOrAddVertex(const Gate& gate, const VertexPtr& high,
 }
 
 Bdd::Function Bdd::ConvertGraph(
-    const Gate& gate,
+    const Gate& root,
     std::unordered_map<int, std::pair<Function, int>>* gates) noexcept {
-  assert(!gate.constant() && "Unexpected constant gate!");
-  Function result;  // For the NRVO, due to memoization.
-  // Memoization check.
-  if (auto it_entry = ext::find(*gates, gate.index())) {
-    std::pair<Function, int>& entry = it_entry->second;
-    result = entry.first;
-    assert(entry.second < gate.parents().size());  // Processed parents.
-    if (++entry.second == gate.parents().size())
-      gates->erase(it_entry);
-    return result;
-  }
-  std::vector<Function> args;
-  for (const Gate::ConstArg<Variable>& arg : gate.args<Variable>()) {
-    args.push_back(
-        {arg.first < 0, FindOrAddVertex(arg.second.index(), kOne_, kOne_, true,
-                                        arg.second.order())});
-    index_to_order_.emplace(arg.second.index(), arg.second.order());
-  }
-  for (const Gate::ConstArg<Gate>& arg : gate.args<Gate>()) {
-    Function res = ConvertGraph(arg.second, gates);
-    if (arg.second.module()) {
-      args.push_back(
-          {arg.first < 0, FindOrAddVertex(arg.second, kOne_, kOne_, true)});
-    } else {
-      bool complement = (arg.first < 0) ^ res.complement;
-      args.push_back({complement, res.vertex});
+  // Depth-first traversal with explicit stacks
+  // so that long chains of gates do not overflow the call stack.
+  // The gates are marked for expansion after their arguments are converted.
+  std::vector<std::pair<const Gate*, bool>> todo = {{&root, false}};
+  std::vector<Function> results;  // Variables and converted gates in order.
+  while (!todo.empty()) {
+    auto [gate_ptr, expanded] = todo.back();
+    todo.pop_back();
+    const Gate& gate = *gate_ptr;
+    if (!expanded) {
+      if (gate.constant()) {  // Only in graphs without preprocessing.
+        results.push_back({*gate.args().begin() < 0, kOne_});
+        continue;
+      }
+      // Memoization check.
+      if (auto it_entry = ext::find(*gates, gate.index())) {
+        std::pair<Function, int>& entry = it_entry->second;
+        results.push_back(entry.first);
+        assert(entry.second < gate.parents().size());  // Processed parents.
+        if (++entry.second == gate.parents().size())
+          gates->erase(it_entry);
+        continue;
+      }
+      todo.emplace_back(&gate, true);
+      for (const Gate::ConstArg<Variable>& arg : gate.args<Variable>()) {
+        results.push_back(
+            {arg.first < 0, FindOrAddVertex(arg.second.index(), kOne_, kOne_,
+                                            true, arg.second.order())});
+        index_to_order_.emplace(arg.second.index(), arg.second.order());
+      }
+      for (const Gate::ConstArg<Gate>& arg :
+           boost::adaptors::reverse(gate.args<Gate>())) {
+        todo.emplace_back(&arg.second, false);
+      }
+      continue;
+    }
+    int num_variables = gate.args<Variable>().size();
+    auto it_args =
+        results.end() - num_variables - boost::size(gate.args<Gate>());
+    std::vector<Function> args(std::make_move_iterator(it_args),
+                               std::make_move_iterator(results.end()));
+    results.erase(it_args, results.end());
+    auto it_gate = args.begin() + num_variables;
+    for (const Gate::ConstArg<Gate>& arg : gate.args<Gate>()) {
+      Function& res = *it_gate++;
+      if (arg.second.module()) {
+        res = {arg.first < 0, FindOrAddVertex(arg.second, kOne_, kOne_, true)};
+      } else {
+        res.complement ^= arg.first < 0;
+      }
     }
+    Function result = ConvertGate(gate, std::move(args));
+    if (gate.module())
+      modules_.emplace(gate.index(), result);
+    if (gate.parents().size() > 1)
+      gates->insert({gate.index(), {result, 1}});
+    results.push_back(std::move(result));
   }
+  assert(results.size() == 1);
+  return results.front();
+}
+
+Bdd::Function Bdd::ConvertGate(const Gate& gate,
+                               std::vector<Function> args) noexcept {
+  Function result;
   boost::sort(args, [](const Function& lhs, const Function& rhs) {
     if (lhs.vertex->terminal())
       return true;
@@ -170,20 +241,123 @@ Bdd::Function Bdd::ConvertGraph(
       return false;
     return Ite::Ref(lhs.vertex).order() > Ite::Ref(rhs.vertex).order();
   });
-  auto it = args.cbegin();
-  for (result = *it++; it != args.cend(); ++it) {
-    result = Apply(gate.type(), result.vertex, it->vertex, result.complement,
-                   it->complement);
+  switch (gate.type()) {
+    case kAnd:
+    case kOr:
+      result = Fold(gate.type(), std::move(args));
+      break;
+    case kNand:
+    case kNor:
+      result = Fold(gate.type() == kNand ? kAnd : kOr, std::move(args));
+      result.complement = !result.complement;
+      break;
+    case kNull:
+    case kNot:
+      assert(args.size() == 1);
+      result = args.front();
+      result.complement ^= gate.type() == kNot;
+      break;
+    case kXor: {
+      assert(args.size() == 2);
+      const Function& one = args.front();
+      const Function& two = args.back();
+      Function first = Apply(kAnd, one.vertex, two.vertex, one.complement,
+                             !two.complement);
+      Function second = Apply(kAnd, one.vertex, two.vertex, !one.complement,
+                              two.complement);
+      result = Apply(kOr, first.vertex, second.vertex, first.complement,
+                     second.complement);
+      break;
+    }
+    case kAtleast: {
+      // at_least[j] is the function of at least j true args in the suffix.
+      int min_number = gate.min_number();
+      std::vector<Function> at_least(min_number + 1, {true, kOne_});
+      at_least[0] = {false, kOne_};
+      int num_suffix_args = 0;
+      for (auto it = args.crbegin(); it != args.crend(); ++it) {
+        ++num_suffix_args;
+        for (int j = std::min(min_number, num_suffix_args); j > 0; --j) {
+          const Function& rest = at_least[j - 1];
+          Function with_arg = Apply(kAnd, it->vertex, rest.vertex,
+                                    it->complement, rest.complement);
+          at_least[j] = Apply(kOr, with_arg.vertex, at_least[j].vertex,
+                              with_arg.complement, at_least[j].complement);
+        }
+      }
+      result = at_least[min_number];
+      break;
+    }
   }
-  ClearTables();
+  // Sibling gates may reuse the computations within the memory limit.
+  if (and_table_.size() + or_table_.size() > kSettings_.bdd_cache_limit())
+    ClearTables();
   assert(result.vertex);
-  if (gate.module())
-    modules_.emplace(gate.index(), result);
-  if (gate.parents().size() > 1)
-    gates->insert({gate.index(), {result, 1}});
   return result;
 }
 
+Bdd::Function Bdd::Fold(Connective type, std::vector<Function> args) noexcept {
+  assert(!args.empty());
+  switch (kSettings_.apply_schedule()) {
+    case ApplySchedule::kSequential: {
+      auto it = args.cbegin();
+      Function function = *it++;
+      for (; it != args.cend(); ++it) {
+        function = Apply(type, function.vertex, it->vertex,
+                         function.complement, it->complement);
+      }
+      return function;
+    }
+    case ApplySchedule::kBalanced:
+      while (args.size() > 1) {
+        int num_pairs = args.size() / 2;
+        for (int i = 0; i < num_pairs; ++i) {
+          const Function& one = args[2 * i];
+          const Function& two = args[2 * i + 1];
+          args[i] = Apply(type, one.vertex, two.vertex, one.complement,
+                          two.complement);
+        }
+        if (args.size() % 2)
+          args[num_pairs++] = args.back();
+        args.resize(num_pairs);
+      }
+      return args.front();
+    case ApplySchedule::kSmallestFirst: {
+      // Min-heap of {size, arrival, function} for deterministic ties.
+      using Entry = std::tuple<int, int, Function>;
+      auto greater = [](const Entry& lhs, const Entry& rhs) {
+        return std::tie(std::get<0>(lhs), std::get<1>(lhs)) >
+               std::tie(std::get<0>(rhs), std::get<1>(rhs));
+      };
+      std::vector<Entry> heap;
+      int arrival = 0;
+      auto push = [this, &heap, &arrival, &greater](const Function& function) {
+        int size = CountVertices(function.vertex);
+        ClearMarks(function.vertex, false);
+        heap.emplace_back(size, arrival++, function);
+        std::push_heap(heap.begin(), heap.end(), greater);
+      };
+      auto pop = [&heap, &greater] {
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        Function function = std::get<2>(heap.back());
+        heap.pop_back();
+        return function;
+      };
+      for (const Function& arg : args)
+        push(arg);
+      while (heap.size() > 1) {
+        Function one = pop();
+        Function two = pop();
+        push(Apply(type, one.vertex, two.vertex, one.complement,
+                   two.complement));
+      }
+      return std::get<2>(heap.front());
+    }
+  }
+  assert(false && "Unknown Apply schedule.");
+  return args.front();
+}
+
 std::pair<int, int> Bdd::GetMinMaxId(const VertexPtr& arg_one,
                                      const VertexPtr& arg_two,
                                      bool complement_one,
@@ -198,101 +372,113 @@ std::pair<int, int> Bdd::GetMinMaxId(const VertexPtr& arg_one,
   return {min_id, max_id};
 }
 
-/// Specialization of Apply for AND connective with BDD vertices.
-template <>
-Bdd::Function Bdd::Apply<kAnd>(const VertexPtr& arg_one,
-                               const VertexPtr& arg_two, bool complement_one,
-                               bool complement_two) noexcept {
+template <Connective Type>
+bool Bdd::FindResult(const VertexPtr& arg_one, const VertexPtr& arg_two,
+                     bool complement_one, bool complement_two,
+                     Function* result, std::pair<int, int>* key) noexcept {
+  static_assert(Type == kAnd || Type == kOr, "Unsupported connective.");
   assert(arg_one->id() && arg_two->id());  // Both are reduced function graphs.
+  // The terminal value that dominates the connective.
+  constexpr bool kDominant = Type == kOr;
   if (arg_one->terminal()) {
-    if (complement_one)
-      return {true, kOne_};
-    return {complement_two, arg_two};
+    if (complement_one ^ kDominant)
+      *result = {!kDominant, kOne_};
+    else
+      *result = {complement_two, arg_two};
+    return true;
   }
   if (arg_two->terminal()) {
-    if (complement_two)
-      return {true, kOne_};
-    return {complement_one, arg_one};
+    if (complement_two ^ kDominant)
+      *result = {!kDominant, kOne_};
+    else
+      *result = {complement_one, arg_one};
+    return true;
   }
   if (arg_one->id() == arg_two->id()) {  // Reduction detection.
     if (complement_one ^ complement_two)
-      return {true, kOne_};
-    return {complement_one, arg_one};
+      *result = {!kDominant, kOne_};
+    else
+      *result = {complement_one, arg_one};
+    return true;
   }
-  std::pair<int, int> min_max_id =
-      GetMinMaxId(arg_one, arg_two, complement_one, complement_two);
-  if (auto it = ext::find(and_table_, min_max_id))
-    return it->second;
-  Function result = Apply<kAnd>(Ite::Ptr(arg_one), Ite::Ptr(arg_two),
-                                complement_one, complement_two);
-  and_table_.emplace(min_max_id, result);
-  return result;
-}
-
-/// Specialization of Apply for OR connective with BDD vertices.
-template <>
-Bdd::Function Bdd::Apply<kOr>(const VertexPtr& arg_one,
-                              const VertexPtr& arg_two, bool complement_one,
-                              bool complement_two) noexcept {
-  assert(arg_one->id() && arg_two->id());  // Both are reduced function graphs.
-  if (arg_one->terminal()) {
-    if (!complement_one)
-      return {false, kOne_};
-    return {complement_two, arg_two};
+  *key = GetMinMaxId(arg_one, arg_two, complement_one, complement_two);
+  ++compute_stats_.lookups;
+  ComputeTable& table = Type == kAnd ? and_table_ : or_table_;
+  if (auto it = ext::find(table, *key)) {
+    ++compute_stats_.hits;
+    *result = it->second;
+    return true;
   }
-  if (arg_two->terminal()) {
-    if (!complement_two)
-      return {false, kOne_};
-    return {complement_one, arg_one};
-  }
-  if (arg_one->id() == arg_two->id()) {  // Reduction detection.
-    if (complement_one ^ complement_two)
-      return {false, kOne_};
-    return {complement_one, arg_one};
-  }
-  std::pair<int, int> min_max_id =
-      GetMinMaxId(arg_one, arg_two, complement_one, complement_two);
-  if (auto it = ext::find(or_table_, min_max_id))
-    return it->second;
-  Function result = Apply<kOr>(Ite::Ptr(arg_one), Ite::Ptr(arg_two),
-                               complement_one, complement_two);
-  or_table_.emplace(min_max_id, result);
-  return result;
+  return false;
 }
 
-template <Connective Type>
-Bdd::Function Bdd::Apply(ItePtr ite_one, ItePtr ite_two, bool complement_one,
-                         bool complement_two) noexcept {
+void Bdd::PushApply(ItePtr ite_one, ItePtr ite_two, bool complement_one,
+                    bool complement_two, const std::pair<int, int>& key) {
   if (ite_one->order() > ite_two->order()) {
     ite_one.swap(ite_two);
     std::swap(complement_one, complement_two);
   }
+  apply_stack_.push_back({std::move(ite_one), std::move(ite_two),
+                          complement_one, complement_two, key, {}, {}});
+}
 
-  Function high;
-  Function low;
-  if (ite_one->order() == ite_two->order()) {  // The same variable.
-    assert(ite_one->index() == ite_two->index());
-    high = Apply<Type>(ite_one->high(), ite_two->high(), complement_one,
-                       complement_two);
-    low = Apply<Type>(ite_one->low(), ite_two->low(),
-                      complement_one ^ ite_one->complement_edge(),
-                      complement_two ^ ite_two->complement_edge());
-  } else {
-    assert(ite_one->order() < ite_two->order());
-    high =
-        Apply<Type>(ite_one->high(), ite_two, complement_one, complement_two);
-    low = Apply<Type>(ite_one->low(), ite_two,
-                      complement_one ^ ite_one->complement_edge(),
-                      complement_two);
+template <Connective Type>
+Bdd::Function Bdd::Apply(const VertexPtr& arg_one, const VertexPtr& arg_two,
+                         bool complement_one, bool complement_two) noexcept {
+  Function result;
+  std::pair<int, int> key;
+  if (FindResult<Type>(arg_one, arg_two, complement_one, complement_two,
+                       &result, &key)) {
+    return result;
   }
-
-  bool complement_edge = high.complement ^ low.complement;
-  if (complement_edge || (high.vertex->id() != low.vertex->id())) {
-    high.vertex =
-        FindOrAddVertex(ite_one, high.vertex, low.vertex, complement_edge);
+  assert(apply_stack_.empty() && "Apply is not reentrant.");
+  PushApply(Ite::Ptr(arg_one), Ite::Ptr(arg_two), complement_one,
+            complement_two, key);
+  while (true) {
+    ApplyFrame& frame = apply_stack_.back();
+    if (!frame.low) {  // Decompose the next pending branch.
+      const Ite& ite_one = *frame.ite_one;
+      const Ite& ite_two = *frame.ite_two;
+      bool same_variable = ite_one.order() == ite_two.order();
+      assert(!same_variable || ite_one.index() == ite_two.index());
+      Function* branch = &frame.high;
+      const VertexPtr* one = &ite_one.high();
+      bool complement_one_branch = frame.complement_one;
+      VertexPtr two = frame.ite_two;  // The whole function by default.
+      bool complement_two_branch = frame.complement_two;
+      if (!frame.high) {
+        if (same_variable)
+          two = ite_two.high();
+      } else {
+        branch = &frame.low;
+        one = &ite_one.low();
+        complement_one_branch ^= ite_one.complement_edge();
+        if (same_variable) {
+          two = ite_two.low();
+          complement_two_branch ^= ite_two.complement_edge();
+        }
+      }
+      if (!FindResult<Type>(*one, two, complement_one_branch,
+                            complement_two_branch, branch, &key)) {
+        PushApply(Ite::Ptr(*one), Ite::Ptr(two), complement_one_branch,
+                  complement_two_branch, key);
+      }
+      continue;
+    }
+    // Both branches are computed.
+    result = std::move(frame.high);
+    bool complement_edge = result.complement ^ frame.low.complement;
+    if (complement_edge || (result.vertex->id() != frame.low.vertex->id())) {
+      result.vertex = FindOrAddVertex(frame.ite_one, result.vertex,
+                                      frame.low.vertex, complement_edge);
+    }
+    (Type == kAnd ? and_table_ : or_table_).emplace(frame.key, result);
+    apply_stack_.pop_back();
+    if (apply_stack_.empty())
+      return result;
+    ApplyFrame& parent = apply_stack_.back();
+    (parent.high ? parent.low : parent.high) = std::move(result);
   }
-
-  return high;
 }
 
 Bdd::Function Bdd::Apply(Connective type, const VertexPtr& arg_one,
@@ -328,19 +514,41 @@ int Bdd::CountIteNodes(const VertexPtr& vertex) noexcept {
   return 1 + in_module + CountIteNodes(ite.high()) + CountIteNodes(ite.low());
 }
 
+int Bdd::CountVertices(const VertexPtr& vertex) noexcept {
+  int count = 0;
+  std::vector<const VertexPtr*> todo = {&vertex};
+  while (!todo.empty()) {
+    const VertexPtr& next = *todo.back();
+    todo.pop_back();
+    if (next->terminal())
+      continue;
+    Ite& ite = Ite::Ref(next);
+    if (ite.mark())
+      continue;
+    ite.mark(true);
+    ++count;
+    todo.push_back(&ite.low());
+    todo.push_back(&ite.high());
+  }
+  return count;
+}
+
 void Bdd::ClearMarks(const VertexPtr& vertex, bool mark) noexcept {
-  if (vertex->terminal())
-    return;
-  Ite& ite = Ite::Ref(vertex);
-  if (ite.mark() == mark)
-    return;
-  ite.mark(mark);
-  if (ite.module()) {
-    const Function& res = modules_.find(ite.index())->second;
-    ClearMarks(res.vertex, mark);
+  std::vector<const VertexPtr*> todo = {&vertex};
+  while (!todo.empty()) {
+    const VertexPtr& next = *todo.back();
+    todo.pop_back();
+    if (next->terminal())
+      continue;
+    Ite& ite = Ite::Ref(next);
+    if (ite.mark() == mark)
+      continue;
+    ite.mark(mark);
+    if (ite.module())
+      todo.push_back(&modules_.find(ite.index())->second.vertex);
+    todo.push_back(&ite.low());
+    todo.push_back(&ite.high());
   }
-  ClearMarks(ite.high(), mark);
-  ClearMarks(ite.low(), mark);
 }
 
 void Bdd::TestStructure(const VertexPtr& vertex) noexcept {
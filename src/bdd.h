@@ -21,6 +21,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 
 #include <algorithm>
 #include <forward_list>
@@ -33,6 +34,7 @@
 #include <boost/noncopyable.hpp>
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
+#include "analysis.h"
 #include "pdag.h"
 #include "settings.h"
 
@@ -407,12 +409,16 @@ class UniqueTable {
   explicit UniqueTable(int init_capacity = 1000)
       : capacity_(core::GetPrimeNumber(init_capacity)),
         size_(0),
+        peak_size_(0),
         max_load_factor_(0.75),
         table_(capacity_) {}
 
   /// @returns The current number of entries.
   int size() const { return size_; }
 
+  /// @returns The largest number of entries in the life of the table.
+  int peak_size() const { return peak_size_; }
+
   /// Erases all entries.
   void clear() {
     for (Bucket& chain : table_)
@@ -468,7 +474,8 @@ class UniqueTable {
         ++it_cur;
       }
     }
-    ++size_;
+    if (++size_ > peak_size_)
+      peak_size_ = size_;
     return *chain.emplace_after(it_prev);
   }
 
@@ -539,6 +546,7 @@ class UniqueTable {
 
   int capacity_;  ///< The total number of buckets in the table.
   int size_;  ///< The total number of elements in the table.
+  int peak_size_;  ///< The largest number of elements in the table.
   double max_load_factor_;  ///< The limit on the avg. # of elements per bucket.
 
   /// A table of unique vertices is stored with weak pointers
@@ -547,6 +555,15 @@ class UniqueTable {
   Table table_;
 };
 
+/// Lookup statistics of computation tables for performance metrics.
+struct TableStats {
+  std::int64_t lookups = 0;  ///< The number of result lookups.
+  std::int64_t hits = 0;  ///< The number of lookups with stored results.
+
+  /// @returns The fraction of lookups with stored results.
+  double hit_rate() const { return lookups ? hits / double(lookups) : 0; }
+};
+
 /// A hash table without collision resolution.
 /// Instead of resolving the collision,
 /// the existing value is purged and replaced by the new entry.
@@ -737,12 +754,30 @@ class Bdd : private boost::noncopyable {
   /// @note BDD construction may take considerable time.
   Bdd(const Pdag* graph, const Settings& settings);
 
+  /// Constructs a BDD with the functions of multiple targets
+  /// sharing the same variable ordering and unique table.
+  /// The common sub-graphs of the targets are converted only once.
+  ///
+  /// @param[in] graph  The shared PDAG of the targets.
+  /// @param[in] targets  The gates of the targets in the PDAG.
+  /// @param[in] settings  The analysis settings.
+  ///
+  /// @pre The PDAG has variable ordering.
+  ///
+  /// @post The root function is the constant True,
+  ///       and the BDD is frozen for quantitative analysis only.
+  Bdd(const Pdag* graph, const std::vector<GatePtr>& targets,
+      const Settings& settings);
+
   /// To handle incomplete ZBDD type with unique pointers.
   ~Bdd() noexcept;
 
   /// @returns The root function of the ROBDD.
   const Function& root() const { return root_; }
 
+  /// @returns The functions of the targets in the order of construction.
+  const std::vector<Function>& targets() const { return targets_; }
+
   /// @returns Mapping of PDAG modules and BDD graph vertices.
   const std::unordered_map<int, Function>& modules() const { return modules_; }
 
@@ -762,7 +797,11 @@ class Bdd : private boost::noncopyable {
   ///
   /// @warning If the graph is discontinuously and partially marked,
   ///          this function will not help with the mess.
-  void ClearMarks(bool mark) { ClearMarks(root_.vertex, mark); }
+  void ClearMarks(bool mark) {
+    ClearMarks(root_.vertex, mark);
+    for (const Function& target : targets_)
+      ClearMarks(target.vertex, mark);
+  }
 
   /// Runs the Qualitative analysis
   /// with the representation of a PDAG as ROBDD.
@@ -778,6 +817,12 @@ class Bdd : private boost::noncopyable {
     return *zbdd_;
   }
 
+  /// Appends the size and table statistics of the BDD
+  /// and the resulting ZBDD if any.
+  ///
+  /// @param[in,out] metrics  The collection of analysis metrics.
+  void GatherMetrics(std::vector<Metric>* metrics) noexcept;
+
  private:
   using IteWeakPtr = WeakIntrusivePtr<Ite>;  ///< Pointer in containers.
   using ComputeTable = CacheTable<Function>;  ///< Computation results.
@@ -831,17 +876,41 @@ class Bdd : private boost::noncopyable {
   /// Converts all gates in the PDAG
   /// into function BDD graphs.
   /// Registers processed gates.
+  /// The graph is traversed with an explicit stack;
+  /// the depth of the graph does not limit the conversion.
   ///
-  /// @param[in] gate  The root or current parent gate of the graph.
+  /// @param[in] root  The root gate of the graph.
   /// @param[in,out] gates  Processed gates with use counts.
   ///
   /// @returns The BDD function representing the gate.
   ///
   /// @pre The memoization container is not used outside of this function.
+  ///
+  /// @note Non-normalized gates and Boolean constants
+  ///       are converted directly without preprocessing.
   Function ConvertGraph(
-      const Gate& gate,
+      const Gate& root,
       std::unordered_map<int, std::pair<Function, int>>* gates) noexcept;
 
+  /// Converts a single gate with its arguments already converted.
+  ///
+  /// @param[in] gate  The gate to convert.
+  /// @param[in] args  The functions of the variable and gate arguments.
+  ///
+  /// @returns The BDD function representing the gate.
+  Function ConvertGate(const Gate& gate, std::vector<Function> args) noexcept;
+
+  /// Combines gate argument functions with a single connective
+  /// in the order of the Apply schedule from the settings.
+  ///
+  /// @param[in] type  The AND or OR connective.
+  /// @param[in] args  The argument functions sorted by the variable order.
+  ///
+  /// @returns The BDD function of the combination.
+  ///
+  /// @pre Non-terminal node marks are clear (false).
+  Function Fold(Connective type, std::vector<Function> args) noexcept;
+
   /// Computes minimum and maximum ids for keys in computation tables.
   ///
   /// @param[in] arg_one  First argument function graph.
@@ -873,23 +942,42 @@ class Bdd : private boost::noncopyable {
   /// @returns The BDD function as a result of operation.
   ///
   /// @note The order of arguments does not matter for two variable connectives.
+  /// @note The operation is iterative with an explicit stack;
+  ///       the number of variables does not limit the recursion depth.
   template <Connective Type>
   Function Apply(const VertexPtr& arg_one, const VertexPtr& arg_two,
                  bool complement_one, bool complement_two) noexcept;
 
-  /// Applies Boolean operation to BDD ITE graphs.
+  /// Finds the result of an operation
+  /// without decomposition of the arguments,
+  /// i.e., with terminal arguments, reduction rules,
+  /// or computed results in the tables.
   ///
-  /// @tparam Type  The connective enum.
+  /// @tparam Type  The AND or OR connective.
   ///
-  /// @param[in] ite_one  First argument function graph.
-  /// @param[in] ite_two  Second argument function graph.
+  /// @param[in] arg_one  First argument function graph.
+  /// @param[in] arg_two  Second argument function graph.
   /// @param[in] complement_one  Interpretation of arg_one as complement.
   /// @param[in] complement_two  Interpretation of arg_two as complement.
+  /// @param[out] result  The result if found.
+  /// @param[out] key  The computation table key if the result is not found.
   ///
-  /// @returns The BDD function as a result of operation.
+  /// @returns true if the result is found.
   template <Connective Type>
-  Function Apply(ItePtr ite_one, ItePtr ite_two, bool complement_one,
-                 bool complement_two) noexcept;
+  bool FindResult(const VertexPtr& arg_one, const VertexPtr& arg_two,
+                  bool complement_one, bool complement_two, Function* result,
+                  std::pair<int, int>* key) noexcept;
+
+  /// Schedules the Apply operation on if-then-else vertices
+  /// with the explicit stack.
+  ///
+  /// @param[in] ite_one  First argument function graph.
+  /// @param[in] ite_two  Second argument function graph.
+  /// @param[in] complement_one  Interpretation of ite_one as complement.
+  /// @param[in] complement_two  Interpretation of ite_two as complement.
+  /// @param[in] key  The computation table key for the result.
+  void PushApply(ItePtr ite_one, ItePtr ite_two, bool complement_one,
+                 bool complement_two, const std::pair<int, int>& key);
 
   /// Applies Boolean operation to BDD graphs.
   /// This is a convenience function
@@ -927,6 +1015,17 @@ class Bdd : private boost::noncopyable {
   /// @pre Non-terminal node marks are clear (false).
   int CountIteNodes(const VertexPtr& vertex) noexcept;
 
+  /// Counts the number of if-then-else nodes
+  /// without descending into module graphs.
+  ///
+  /// @param[in] vertex  The starting root vertex of BDD.
+  ///
+  /// @returns The number of ITE nodes reachable from the vertex.
+  ///
+  /// @pre Non-terminal node marks are clear (false).
+  /// @post The counted nodes are marked (true).
+  int CountVertices(const VertexPtr& vertex) noexcept;
+
   /// Clears marks of vertices in BDD graph.
   ///
   /// @param[in] vertex  The starting root vertex of the graph.
@@ -962,6 +1061,7 @@ class Bdd : private boost::noncopyable {
 
   const Settings kSettings_;  ///< Analysis settings.
   Function root_;  ///< The root function of this BDD.
+  std::vector<Function> targets_;  ///< The functions of multiple targets.
   bool coherent_;  ///< Inherited coherence from PDAG.
 
   /// Table of unique if-then-else nodes denoting function graphs.
@@ -979,6 +1079,19 @@ class Bdd : private boost::noncopyable {
   ComputeTable and_table_;
   ComputeTable or_table_;
   /// @}
+  TableStats compute_stats_;  ///< Lookups in the computation tables.
+
+  /// Pending Apply computation on if-then-else vertices.
+  struct ApplyFrame {
+    ItePtr ite_one;  ///< The argument with the top variable.
+    ItePtr ite_two;  ///< The other argument.
+    bool complement_one;  ///< Interpretation of ite_one as complement.
+    bool complement_two;  ///< Interpretation of ite_two as complement.
+    std::pair<int, int> key;  ///< The computation table key.
+    Function high;  ///< The computed high branch.
+    Function low;  ///< The computed low branch.
+  };
+  std::vector<ApplyFrame> apply_stack_;  ///< Pending Apply computations.
 
   std::unordered_map<int, Function> modules_;  ///< Module graphs.
   std::unordered_map<int, int> index_to_order_;  ///< Indices and orders.
@@ -22,10 +22,13 @@
 
 #include <cmath>
 
+#include <iterator>
+#include <numeric>
 #include <utility>
 
 #include <boost/algorithm/string/join.hpp>
 #include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/algorithm.hpp>
 
 #include "error.h"
 #include "expression/constant.h"
@@ -36,16 +39,17 @@
 
 namespace scram::mef {
 
-CcfEvent::CcfEvent(std::vector<Gate*> members, const CcfGroup* ccf_group)
+CcfEvent::CcfEvent(std::vector<BasicEvent*> members, const CcfGroup* ccf_group)
     : BasicEvent(MakeName(members), ccf_group->base_path(), ccf_group->role()),
       ccf_group_(*ccf_group),
       members_(std::move(members)) {}
 
-std::string CcfEvent::MakeName(const std::vector<Gate*>& members) {
+std::string CcfEvent::MakeName(const std::vector<BasicEvent*>& members) {
   return "[" +
          boost::join(members | boost::adaptors::transformed(
-                                   [](const Gate* gate) -> decltype(auto) {
-                                     return gate->name();
+                                   [](const BasicEvent* member)
+                                       -> decltype(auto) {
+                                     return member->name();
                                    }),
                      " ") +
          "]";
@@ -137,48 +141,51 @@ void CcfGroup::Validate() const {
 }
 
 void CcfGroup::ApplyModel() {
-  // Construct replacement proxy gates for member basic events.
-  std::vector<std::pair<Gate*, Formula::ArgSet>> proxy_gates;
-  for (BasicEvent* member : members_) {
-    auto new_gate = std::make_unique<Gate>(member->name(), member->base_path(),
-                                           member->role());
-    assert(member->id() == new_gate->id());
-    proxy_gates.push_back({new_gate.get(), {}});
-    member->ccf_gate(std::move(new_gate));
-  }
+  // The members are replaced with their CCF events
+  // directly in the analysis graph without proxy gates and formulas.
+  for (BasicEvent* member : members_)
+    member->ccf_group(this);
+  member_events_.resize(members_.size());
 
   ExpressionMap probabilities = this->CalculateProbabilities();
   assert(probabilities.size() > 1);
 
   // Generate CCF events.
+  std::vector<int> indices(members_.size());
+  std::iota(indices.begin(), indices.end(), 0);
   for (auto& [level, prob] : probabilities) {
-    using Iterator = decltype(proxy_gates)::iterator;
+    using Iterator = decltype(indices)::iterator;
     auto combination_visitor = [this, prob](Iterator it_begin,
                                             Iterator it_end) {
-      std::vector<Gate*> combination;
+      std::vector<BasicEvent*> combination;
       for (auto it = it_begin; it != it_end; ++it)
-        combination.push_back(it->first);
+        combination.push_back(members_[*it]);
 
       auto ccf_event = std::make_unique<CcfEvent>(std::move(combination), this);
 
       for (auto it = it_begin; it != it_end; ++it)
-        it->second.Add(ccf_event.get());
+        member_events_[*it].push_back(ccf_event.get());
 
       ccf_event->expression(prob);
       ccf_events_.emplace_back(std::move(ccf_event));
 
       return false;
     };
-    ext::for_each_combination(proxy_gates.begin(),
-                              std::next(proxy_gates.begin(), level),
-                              proxy_gates.end(), combination_visitor);
+    ext::for_each_combination(indices.begin(),
+                              std::next(indices.begin(), level), indices.end(),
+                              combination_visitor);
   }
+  assert(ext::all_of(member_events_, [](const std::vector<CcfEvent*>& events) {
+    return events.size() >= 2;
+  }));
+}
 
-  // Assign formulas to the proxy gates.
-  for (std::pair<Gate*, Formula::ArgSet>& gate : proxy_gates) {
-    assert(gate.second.size() >= 2);
-    gate.first->formula(std::make_unique<Formula>(kOr, std::move(gate.second)));
-  }
+const std::vector<CcfEvent*>& CcfGroup::ccf_events(
+    const BasicEvent& member) const {
+  assert(member_events_.size() == members_.size() && "CCF is not applied.");
+  auto it = boost::find(members_, &member);
+  assert(it != members_.end() && "The event is not a member.");
+  return member_events_[std::distance(members_.begin(), it)];
 }
 
 CcfGroup::ExpressionMap BetaFactorModel::CalculateProbabilities() {
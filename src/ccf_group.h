@@ -54,14 +54,14 @@ class CcfEvent : public BasicEvent {
   /// @param[in] members  The members that this CCF event
   ///                     represents as multiple failure.
   /// @param[in] ccf_group  The CCF group that created this event.
-  CcfEvent(std::vector<Gate*> members, const CcfGroup* ccf_group);
+  CcfEvent(std::vector<BasicEvent*> members, const CcfGroup* ccf_group);
 
   /// @returns The CCF group that created this CCF event.
   const CcfGroup& ccf_group() const { return ccf_group_; }
 
   /// @returns Members of this CCF event.
-  ///          The members also own this CCF event through parentship.
-  const std::vector<Gate*>& members() const { return members_; }
+  ///          The members are replaced with their CCF events in analysis.
+  const std::vector<BasicEvent*>& members() const { return members_; }
 
  private:
   /// Creates a mangled name
@@ -70,10 +70,10 @@ class CcfEvent : public BasicEvent {
   /// @param[in] members  The members that this CCF event represents.
   ///
   /// @returns The name string valid only for internal uses.
-  static std::string MakeName(const std::vector<Gate*>& members);
+  static std::string MakeName(const std::vector<BasicEvent*>& members);
 
   const CcfGroup& ccf_group_;  ///< The originating CCF group.
-  std::vector<Gate*> members_;  ///< Member parent gates of this CCF event.
+  std::vector<BasicEvent*> members_;  ///< Member basic events of the group.
 };
 
 /// Abstract base class for all common cause failure models.
@@ -145,7 +145,14 @@ class CcfGroup : public Id {
   /// @pre The CCF is validated.
   void ApplyModel();
 
- protected:
+  /// @param[in] member  The member basic event of this CCF group.
+  ///
+  /// @returns The CCF events that replace the member in analysis,
+  ///          i.e., the member fails if any of the events occurs.
+  ///
+  /// @pre The CCF model is applied.
+  const std::vector<CcfEvent*>& ccf_events(const BasicEvent& member) const;
+
   /// Mapping expressions and their application levels.
   using ExpressionMap = std::vector<std::pair<int, Expression*>>;
 
@@ -155,6 +162,7 @@ class CcfGroup : public Id {
   /// @returns CCF factors of the model.
   const ExpressionMap& factors() const { return factors_; }
 
+ protected:
   /// Registers a new expression for ownership by the group.
   /// @{
   template <class T, typename... Ts>
@@ -198,6 +206,8 @@ class CcfGroup : public Id {
   std::vector<std::unique_ptr<Expression>> expressions_;
   /// CCF events created by the group.
   std::vector<std::unique_ptr<CcfEvent>> ccf_events_;
+  /// CCF events of each member in the order of the members.
+  std::vector<std::vector<CcfEvent*>> member_events_;
 };
 
 /// Common cause failure model that assumes,
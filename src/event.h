@@ -73,7 +73,7 @@ class HouseEvent : public Event {
   bool state_ = false;
 };
 
-class Gate;
+class CcfGroup;  // CCF groups replace their member basic events.
 
 /// Representation of a basic event in a fault tree.
 class BasicEvent : public Event {
@@ -122,24 +122,25 @@ class BasicEvent : public Event {
   /// Indicates if this basic event has been set to be in a CCF group.
   ///
   /// @returns true if in a CCF group.
-  bool HasCcf() const { return ccf_gate_ != nullptr; }
+  bool HasCcf() const { return ccf_group_ != nullptr; }
 
-  /// @returns CCF group gate representing this basic event.
-  const Gate& ccf_gate() const {
-    assert(ccf_gate_);
-    return *ccf_gate_;
+  /// @returns The CCF group that can represent this basic event
+  ///          with its CCF events in analysis with common cause information.
+  const CcfGroup& ccf_group() const {
+    assert(ccf_group_);
+    return *ccf_group_;
   }
 
-  /// Sets the common cause failure group gate
-  /// that can represent this basic event
+  /// Sets the common cause failure group
+  /// that can replace this basic event with CCF events
   /// in analysis with common cause information.
   /// This information is expected to be provided by
   /// CCF group application.
   ///
-  /// @param[in] gate  CCF group gate.
-  void ccf_gate(std::unique_ptr<Gate> gate) {
-    assert(!ccf_gate_);
-    ccf_gate_ = std::move(gate);
+  /// @param[in] ccf_group  The CCF group with this basic event as a member.
+  void ccf_group(const CcfGroup* ccf_group) {
+    assert(!ccf_group_);
+    ccf_group_ = ccf_group;
   }
 
  private:
@@ -148,9 +149,9 @@ class BasicEvent : public Event {
   Expression* expression_ = nullptr;
 
   /// If this basic event is in a common cause group,
-  /// CCF gate can serve as a replacement for the basic event
-  /// for common cause analysis.
-  std::unique_ptr<Gate> ccf_gate_;
+  /// the CCF events of the group can serve as a replacement
+  /// for the basic event for common cause analysis.
+  const CcfGroup* ccf_group_ = nullptr;
 };
 
 class Formula;  // To describe a gate's formula.
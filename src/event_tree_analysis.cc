@@ -19,7 +19,10 @@
 
 #include "event_tree_analysis.h"
 
+#include <algorithm>
+
 #include "expression/numerical.h"
+#include "ext/algorithm.h"
 #include "ext/find_iterator.h"
 #include "instruction.h"
 
@@ -32,117 +35,145 @@ EventTreeAnalysis::EventTreeAnalysis(
       initiating_event_(initiating_event),
       context_(context) {}
 
-namespace {  // The model cloning functions.
-
-/// Clones the formula by applying the set-instructions.
-///
-/// @param[in] formula  The formula to be deep-cloned.
-/// @param[in] set_instructions  The set instructions to change arguments.
-/// @param[in] clones  The storage container for newly created clones.
-///
-/// @returns The deep-copy of the argument formula with new (changed) arguments.
 std::unique_ptr<mef::Formula>
-Clone(const mef::Formula& formula,
-      const std::unordered_map<std::string, bool>& set_instructions,
-      std::vector<std::unique_ptr<mef::Event>>* clones) noexcept {
+EventTreeAnalysis::Clone(const mef::Formula& formula,
+                         const SetInstructions& set_instructions,
+                         CloneCache* cache) noexcept {
+  if (set_instructions.empty())
+    return nullptr;
+
   struct {
     mef::Formula::ArgEvent operator()(mef::BasicEvent* arg) { return arg; }
     mef::Formula::ArgEvent operator()(mef::HouseEvent* arg) {
-      if (auto it = ext::find(set_house, arg->id())) {
-        if (it->second == arg->state())
-          return arg;
+      auto it = ext::find(set_house, arg->id());
+      if (!it || it->second == arg->state())
+        return arg;
+      mef::HouseEvent*& ptr = clone_cache->house_events[arg];
+      if (!ptr) {
         auto clone = std::make_unique<mef::HouseEvent>(
             arg->name(), "__clone__." + arg->id(),
             mef::RoleSpecifier::kPrivate);
         clone->state(it->second);
-        auto* ptr = clone.get();
-        event_register->emplace_back(std::move(clone));
-        return ptr;
+        ptr = clone.get();
+        analysis->events_.emplace_back(std::move(clone));
       }
-      return arg;
+      return ptr;
     }
     mef::Formula::ArgEvent operator()(mef::Gate* arg) {
-      if (set_house.empty())
-        return arg;
-      auto clone = std::make_unique<mef::Gate>(
-          arg->name(), "__clone__." + arg->id(), mef::RoleSpecifier::kPrivate);
-      clone->formula(Clone(arg->formula(), set_house, event_register));
-      auto* ptr = clone.get();
-      event_register->emplace_back(std::move(clone));
+      if (auto it = ext::find(clone_cache->gates, arg))
+        return it->second;
+      mef::Gate* ptr = arg;
+      if (auto formula = analysis->Clone(arg->formula(), set_house,
+                                         clone_cache)) {
+        auto clone = std::make_unique<mef::Gate>(
+            arg->name(), "__clone__." + arg->id(),
+            mef::RoleSpecifier::kPrivate);
+        clone->formula(std::move(formula));
+        ptr = clone.get();
+        analysis->events_.emplace_back(std::move(clone));
+      }
+      clone_cache->gates.emplace(arg, ptr);
       return ptr;
     }
 
-    const std::unordered_map<std::string, bool>& set_house;
-    std::vector<std::unique_ptr<mef::Event>>* event_register;
-  } cloner{set_instructions, clones};
+    EventTreeAnalysis* analysis;
+    const SetInstructions& set_house;
+    CloneCache* clone_cache;
+  } cloner{this, set_instructions, cache};
 
+  bool is_changed = false;
   mef::Formula::ArgSet arg_set;
-  for (const mef::Formula::Arg& arg : formula.args())
-    arg_set.Add(std::visit(cloner, arg.event), arg.complement);
+  for (const mef::Formula::Arg& arg : formula.args()) {
+    mef::Formula::ArgEvent event = std::visit(cloner, arg.event);
+    is_changed |= event != arg.event;
+    arg_set.Add(event, arg.complement);
+  }
+  if (!is_changed)
+    return nullptr;
 
   return std::make_unique<mef::Formula>(
       formula.connective(), std::move(arg_set), formula.min_number(),
       formula.max_number());
 }
 
-}  // namespace
+mef::Gate* EventTreeAnalysis::CollectFormula(
+    const mef::Formula& formula, const SetInstructions& set_instructions,
+    CloneCache* cache) noexcept {
+  mef::Gate*& gate = cache->formulas[&formula];
+  if (!gate) {
+    auto clone = Clone(formula, set_instructions, cache);
+    gate = MakeGate(clone ? std::move(clone)
+                          : std::make_unique<mef::Formula>(formula));
+  }
+  return gate;
+}
 
-EventTreeAnalysis::PathCollector::PathCollector(const PathCollector& other)
-    : expressions(other.expressions), set_instructions(other.set_instructions) {
-  for (const mef::FormulaPtr& formula : other.formulas)
-    formulas.push_back(std::make_unique<mef::Formula>(*formula));
+mef::Gate* EventTreeAnalysis::MakeGate(mef::FormulaPtr formula) noexcept {
+  std::string gate_name = "___" + initiating_event_.name() + "__formula_" +
+                          std::to_string(formula_id_++) + "__";
+  auto gate = std::make_unique<mef::Gate>(gate_name);
+  gate->formula(std::move(formula));
+  auto* address = gate.get();
+  events_.emplace_back(std::move(gate));
+  return address;
 }
 
 void EventTreeAnalysis::Analyze() noexcept {
   assert(initiating_event_.event_tree());
-  int formula_id = 0;  // Enumeration of collected formulas turned into gates.
-  // Creates an internal gate representing the formula.
-  auto make_gate = [&formula_id, this](mef::FormulaPtr formula) {
-    std::string gate_name = "___" + initiating_event_.name() + "__formula_" +
-                            std::to_string(formula_id++) + "__";
-    auto gate = std::make_unique<mef::Gate>(gate_name);
-    gate->formula(std::move(formula));
-    auto* address = gate.get();
-    events_.emplace_back(std::move(gate));
-    return address;
+  // Gathers the path data in the order of collection.
+  auto to_vector = [](const auto& path_list) {
+    std::vector<decltype(path_list->value)> data;
+    for (auto* node = path_list.get(); node; node = node->prev.get())
+      data.push_back(node->value);
+    std::reverse(data.begin(), data.end());
+    return data;
+  };
+  // Adds the gate argument only once into the connective.
+  auto add_unique = [](mef::Formula::ArgSet* arg_set, mef::Gate* gate) {
+    if (ext::none_of(arg_set->data(), [gate](const mef::Formula::Arg& arg) {
+          return arg.event == mef::Formula::ArgEvent(gate);
+        })) {
+      arg_set->Add(gate);
+    }
   };
 
   SequenceCollector collector{initiating_event_, *context_};
   CollectSequences(initiating_event_.event_tree()->initial_state(), &collector);
   for (auto& sequence : collector.sequences) {
     auto gate = std::make_unique<mef::Gate>("__" + sequence.first->name());
-    std::vector<mef::FormulaPtr> gate_formulas;
+    mef::Formula::ArgSet gate_args;
     std::vector<mef::Expression*> arg_expressions;
     for (PathCollector& path_collector : sequence.second) {
-      if (path_collector.formulas.size() == 1) {
-        gate_formulas.push_back(std::move(path_collector.formulas.front()));
-      } else if (path_collector.formulas.size() > 1) {
+      std::vector<mef::Gate*> formulas = to_vector(path_collector.formulas);
+      if (formulas.size() == 1) {
+        add_unique(&gate_args, formulas.front());
+      } else if (formulas.size() > 1) {
         mef::Formula::ArgSet arg_set;
-        for (mef::FormulaPtr& arg_formula : path_collector.formulas)
-          arg_set.Add(make_gate(std::move(arg_formula)));
+        for (mef::Gate* arg_gate : formulas)
+          add_unique(&arg_set, arg_gate);
 
-        gate_formulas.push_back(
-            std::make_unique<mef::Formula>(mef::kAnd, std::move(arg_set)));
+        add_unique(&gate_args, MakeGate(std::make_unique<mef::Formula>(
+                                   mef::kAnd, std::move(arg_set))));
       }
-      if (path_collector.expressions.size() == 1) {
-        arg_expressions.push_back(path_collector.expressions.front());
-      } else if (path_collector.expressions.size() > 1) {
+      std::vector<mef::Expression*> expressions =
+          to_vector(path_collector.expressions);
+      if (expressions.size() == 1) {
+        arg_expressions.push_back(expressions.front());
+      } else if (expressions.size() > 1) {
         expressions_.push_back(
-            std::make_unique<mef::Mul>(std::move(path_collector.expressions)));
+            std::make_unique<mef::Mul>(std::move(expressions)));
         arg_expressions.push_back(expressions_.back().get());
       }
     }
-    assert(gate_formulas.empty() || arg_expressions.empty());
+    assert(gate_args.empty() || arg_expressions.empty());
     bool is_expression_only = !arg_expressions.empty();
-    if (gate_formulas.size() == 1) {
-      gate->formula(std::move(gate_formulas.front()));
-    } else if (gate_formulas.size() > 1) {
-      mef::Formula::ArgSet arg_set;
-      for (mef::FormulaPtr& arg_formula : gate_formulas)
-        arg_set.Add(make_gate(std::move(arg_formula)));
-
+    if (gate_args.size() == 1) {
+      const mef::Formula& formula =
+          std::get<mef::Gate*>(gate_args.data().front().event)->formula();
+      gate->formula(std::make_unique<mef::Formula>(formula));
+    } else if (gate_args.size() > 1) {
       gate->formula(
-          std::make_unique<mef::Formula>(mef::kOr, std::move(arg_set)));
+          std::make_unique<mef::Formula>(mef::kOr, std::move(gate_args)));
     } else if (!arg_expressions.empty()) {
       auto event =
           std::make_unique<mef::BasicEvent>("__" + sequence.first->name());
@@ -173,8 +204,15 @@ void EventTreeAnalysis::CollectSequences(const mef::Branch& initial_state,
       explicit Visitor(Collector* collector) : collector_(*collector) {}
 
       void Visit(const mef::SetHouseEvent* house_event) override {
-        collector_.path_collector_.set_instructions[house_event->name()] =
-            house_event->state();
+        PathCollector& path = collector_.path_collector_;
+        auto it = ext::find(*path.set_instructions, house_event->name());
+        if (it && it->second == house_event->state())
+          return;
+        SetInstructions set_instructions = *path.set_instructions;
+        set_instructions[house_event->name()] = house_event->state();
+        path.set_instructions =
+            &collector_.result_->clones.try_emplace(std::move(set_instructions))
+                 .first->first;
       }
 
       void Visit(const mef::Link* link) override {
@@ -186,17 +224,19 @@ void EventTreeAnalysis::CollectSequences(const mef::Branch& initial_state,
       }
 
       void Visit(const mef::CollectFormula* collect_formula) override {
-        // clang-format off
-        collector_.path_collector_.formulas.push_back(
-            core::Clone(collect_formula->formula(),
-                        collector_.path_collector_.set_instructions,
-                        collector_.clones_));
-        // clang-format on
+        PathCollector& path = collector_.path_collector_;
+        mef::Gate* gate = collector_.analysis_->CollectFormula(
+            collect_formula->formula(), *path.set_instructions,
+            &collector_.result_->clones.find(*path.set_instructions)->second);
+        path.formulas = std::make_shared<const PathNode<mef::Gate*>>(
+            PathNode<mef::Gate*>{gate, std::move(path.formulas)});
       }
 
       void Visit(const mef::CollectExpression* collect_expression) override {
-        collector_.path_collector_.expressions.push_back(
-            &collect_expression->expression());
+        PathCollector& path = collector_.path_collector_;
+        path.expressions = std::make_shared<const PathNode<mef::Expression*>>(
+            PathNode<mef::Expression*>{&collect_expression->expression(),
+                                       std::move(path.expressions)});
       }
 
       bool is_linked() const { return is_linked_; }
@@ -237,12 +277,15 @@ void EventTreeAnalysis::CollectSequences(const mef::Branch& initial_state,
     }
 
     SequenceCollector* result_;
-    std::vector<std::unique_ptr<mef::Event>>* clones_;
+    EventTreeAnalysis* analysis_;
     PathCollector path_collector_;
   };
   context_->functional_events.clear();
   context_->initiating_event = initiating_event_.name();
-  Collector{result, &events_}(&initial_state);  // NOLINT(whitespace/braces)
+  const SetInstructions* no_instructions =
+      &result->clones.try_emplace(SetInstructions()).first->first;
+  Collector{result, this, {nullptr, nullptr, no_instructions}}(  // NOLINT
+      &initial_state);
 }
 
 }  // namespace scram::core
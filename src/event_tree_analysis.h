@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -67,13 +68,39 @@ class EventTreeAnalysis : public Analysis {
   /// @}
 
  private:
+  /// House-event state assignments by set-house-event instructions.
+  using SetInstructions = std::map<std::string, bool>;
+
+  /// Interned clones of model events and collected formulas
+  /// under a unique set of house-event assignments.
+  struct CloneCache {
+    /// The clones or the original gates if unaffected by the instructions.
+    std::unordered_map<const mef::Gate*, mef::Gate*> gates;
+    /// The house events with changed states.
+    std::unordered_map<const mef::HouseEvent*, mef::HouseEvent*> house_events;
+    /// The collected formulas turned into gates.
+    std::unordered_map<const mef::Formula*, mef::Gate*> formulas;
+  };
+
+  /// Immutable node of path data shared by paths with the common prefix.
+  template <typename T>
+  struct PathNode {
+    T value;  ///< The data collected at the node.
+    std::shared_ptr<const PathNode> prev;  ///< The preceding data in the path.
+  };
+
+  /// The path data list in the reverse order of collection.
+  template <typename T>
+  using PathList = std::shared_ptr<const PathNode<T>>;
+
   /// Expressions and formulas collected in an event tree path.
+  ///
+  /// The data is shared structurally with other paths;
+  /// copying of the collector does not copy the data.
   struct PathCollector {
-    PathCollector() = default;
-    PathCollector(const PathCollector&);  ///< Must deep copy formulas.
-    std::vector<mef::Expression*> expressions;  ///< Multiplication arguments.
-    std::vector<mef::FormulaPtr> formulas;  ///< AND connective formulas.
-    std::unordered_map<std::string, bool> set_instructions;  ///< House events.
+    PathList<mef::Expression*> expressions;  ///< Multiplication arguments.
+    PathList<mef::Gate*> formulas;  ///< AND connective arguments.
+    const SetInstructions* set_instructions;  ///< Interned house events.
   };
 
   /// Walks the event tree paths and collects sequences.
@@ -83,8 +110,41 @@ class EventTreeAnalysis : public Analysis {
     /// Sequences with collected paths.
     std::unordered_map<const mef::Sequence*, std::vector<PathCollector>>
         sequences;
+    /// The interned set-instructions with clones reused across paths.
+    std::map<SetInstructions, CloneCache> clones;
   };
 
+  /// Clones the formula by applying the set-instructions.
+  /// Only events affected by the instructions are cloned.
+  ///
+  /// @param[in] formula  The formula with arguments to be changed.
+  /// @param[in] set_instructions  The set instructions to change arguments.
+  /// @param[in,out] cache  The interned clones for the set instructions.
+  ///
+  /// @returns The clone with new (changed) arguments,
+  ///          or nullptr if the formula is unaffected by the instructions.
+  std::unique_ptr<mef::Formula> Clone(const mef::Formula& formula,
+                                      const SetInstructions& set_instructions,
+                                      CloneCache* cache) noexcept;
+
+  /// Turns the collected formula into an interned gate.
+  ///
+  /// @param[in] formula  The collected formula.
+  /// @param[in] set_instructions  The set instructions of the path.
+  /// @param[in,out] cache  The interned clones for the set instructions.
+  ///
+  /// @returns The unique gate for the formula under the instructions.
+  mef::Gate* CollectFormula(const mef::Formula& formula,
+                            const SetInstructions& set_instructions,
+                            CloneCache* cache) noexcept;
+
+  /// Creates an internal gate representing the formula.
+  ///
+  /// @param[in] formula  The gate formula.
+  ///
+  /// @returns The registered gate.
+  mef::Gate* MakeGate(mef::FormulaPtr formula) noexcept;
+
   /// Walks the branch and collects sequences with expressions if any.
   ///
   /// @param[in] initial_state  The branch to start the traversal.
@@ -100,6 +160,7 @@ class EventTreeAnalysis : public Analysis {
   std::vector<std::unique_ptr<mef::Expression>> expressions_;
   std::vector<std::unique_ptr<mef::Event>> events_;  ///< Newly created events.
   mef::Context* context_;  ///< The communication channel with test-events.
+  int formula_id_ = 0;  ///< Enumeration of collected formulas turned into gates.
 };
 
 }  // namespace scram::core
@@ -20,14 +20,19 @@
 
 #include "fault_tree_analysis.h"
 
+#include <algorithm>
 #include <iostream>
+#include <optional>
+#include <typeinfo>
 #include <utility>
 
 #include <boost/container/flat_set.hpp>
 #include <boost/range/algorithm.hpp>
 
+#include "error.h"
 #include "event.h"
 #include "logger.h"
+#include "pdag_cache.h"
 
 namespace scram::core {
 
@@ -83,10 +88,12 @@ void Print(const ProductContainer& products) {
   std::cerr << std::endl;
 }
 
-ProductContainer::ProductContainer(const Zbdd& products,
-                                   const Pdag& graph) noexcept
-    : products_(products), graph_(graph), size_(0) {
+ProductContainer::ProductContainer(const Zbdd& products, const Pdag& graph,
+                                   bool probability) noexcept
+    : products_(products), graph_(graph), size_(0), p_sum_(0) {
   Pdag::IndexMap<bool> filter(graph_.basic_events().size());
+  if (probability)
+    p_vars_.resize(graph_.basic_events().size());
   for (const std::vector<int>& product : products_) {
     int order_index = product.empty() ? 0 : product.size() - 1;
     if (distribution_.size() <= order_index)
@@ -99,13 +106,23 @@ ProductContainer::ProductContainer(const Zbdd& products,
       if (filter[i])
         continue;
       filter[i] = true;
-      product_events_.insert(graph_.basic_events()[i]);
+      const mef::BasicEvent* event = graph_.basic_events()[i];
+      product_events_.insert(event);
+      if (probability)
+        p_vars_[i] = event->p();
     }
+    if (probability)
+      p_sum_ += Product(product, graph_, &p_vars_).p();
   }
 }
 
 double Product::p() const {
   double p = 1;
+  if (p_vars_) {
+    for (int i : data_)
+      p *= i < 0 ? 1 - (*p_vars_)[-i] : (*p_vars_)[i];
+    return p;
+  }
   for (const Literal& literal : *this) {
     p *= literal.complement ? 1 - literal.event.p() : literal.event.p();
   }
@@ -119,9 +136,38 @@ FaultTreeAnalysis::FaultTreeAnalysis(const mef::Gate& root,
 
 void FaultTreeAnalysis::Analyze() noexcept {
   CLOCK(analysis_time);
-  graph_ = std::make_unique<Pdag>(top_event_,
-                                  Analysis::settings().ccf_analysis(), model_);
-  this->Preprocess(graph_.get());
+  std::optional<PdagCache> cache;
+  if (!Analysis::settings().pdag_cache().empty()) {
+    // The analyzer type identifies the preprocessing for the algorithm.
+    cache.emplace(Analysis::settings().pdag_cache(), top_event_,
+                  Analysis::settings(), model_, typeid(*this).name());
+    graph_ = cache->Load();
+  }
+  if (!graph_) {
+    graph_ = std::make_unique<Pdag>(
+        top_event_, Analysis::settings().ccf_analysis(), model_);
+    preprocessing_ = this->Preprocess(graph_.get());
+    // Partial preprocessing depends on timing and is not reproducible.
+    bool partial = std::any_of(
+        preprocessing_.begin(), preprocessing_.end(),
+        [](const PassStats& pass) { return pass.skipped || pass.aborted; });
+    if (cache && partial) {
+      LOG(DEBUG2) << "Not storing the partially preprocessed PDAG.";
+    } else if (cache) {
+      try {
+        cache->Store(*graph_);
+        LOG(DEBUG2) << "Stored the preprocessed PDAG in " << cache->snapshot();
+      } catch (const IOError& err) {
+        LOG(WARNING) << "Failed to store the preprocessed PDAG: "
+                     << err.what();
+      }
+    }
+  }
+  GraphSize size = MeasureGraph(*graph_);
+  Analysis::AddMetric("pdag-gates", size.gates);
+  Analysis::AddMetric("pdag-arguments", size.args);
+  Analysis::AddMetric("pdag-modules", size.modules);
+  Analysis::AddMetric("pdag-variables", graph_->basic_events().size());
 #ifndef NDEBUG
   if (Analysis::settings().preprocessor)
     return;  // Preprocessor only option.
@@ -133,6 +179,7 @@ void FaultTreeAnalysis::Analyze() noexcept {
   LOG(DEBUG2) << "# of products: " << products.size();
 
   Analysis::AddAnalysisTime(DUR(analysis_time));
+  Analysis::AddMetric("peak-memory", PeakMemory());
   CLOCK(store_time);
   Store(products, *graph_);
   LOG(DEBUG2) << "Stored the result for reporting in " << DUR(store_time);
@@ -146,7 +193,8 @@ void FaultTreeAnalysis::Store(const Zbdd& products,
   } else if (products.base()) {
     Analysis::AddWarning("The set is UNITY/Base.");
   }
-  products_ = std::make_unique<const ProductContainer>(products, graph);
+  products_ = std::make_unique<const ProductContainer>(
+      products, graph, Analysis::settings().probability_analysis());
 
 #ifndef NDEBUG
   for (const Product& product : *products_)
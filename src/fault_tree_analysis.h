@@ -68,8 +68,11 @@ class Product {
   ///
   /// @param[in] data  The underlying set.
   /// @param[in] graph  The graph with indices to events map.
-  Product(const std::vector<int>& data, const Pdag& graph) noexcept
-      : data_(data), graph_(graph) {}
+  /// @param[in] p_vars  The optional cache of the event probabilities
+  ///                    mapped by the event indices.
+  Product(const std::vector<int>& data, const Pdag& graph,
+          const Pdag::IndexMap<double>* p_vars = nullptr) noexcept
+      : data_(data), graph_(graph), p_vars_(p_vars) {}
 
   /// @returns true for unity product with no literals.
   bool empty() const { return data_.empty(); }
@@ -85,6 +88,9 @@ class Product {
   /// @returns The product of the literal probabilities.
   ///
   /// @pre Events are initialized with expressions.
+  ///
+  /// @note The expressions are not evaluated
+  ///       if the event probabilities are cached.
   double p() const;
 
   /// @returns A read proxy iterator that points to the first element.
@@ -102,6 +108,7 @@ class Product {
  private:
   const std::vector<int>& data_;  ///< The collection of event indices.
   const Pdag& graph_;  ///< The host graph.
+  const Pdag::IndexMap<double>* p_vars_;  ///< The cached probabilities.
 };
 
 /// A container of analysis result products with Literals.
@@ -113,17 +120,23 @@ class ProductContainer {
     ///
     /// @returns The wrapped product of Literals.
     Product operator()(const std::vector<int>& product) const {
-      return Product(product, graph);
+      return Product(product, graph, p_vars);
     }
     const Pdag& graph;  ///< The host graph.
+    const Pdag::IndexMap<double>* p_vars;  ///< The cached probabilities.
   };
 
  public:
   /// The constructor also collects basic events in products.
+  /// With the probability information,
+  /// the event probabilities are evaluated only once,
+  /// and the sum of product probabilities is gathered in the same pass.
   ///
   /// @param[in] products  Sets with indices of events from calculations.
   /// @param[in] graph  PDAG with basic event indices and pointers.
-  ProductContainer(const Zbdd& products, const Pdag& graph) noexcept;
+  /// @param[in] probability  The indication of events with expressions.
+  ProductContainer(const Zbdd& products, const Pdag& graph,
+                   bool probability = false) noexcept;
 
   /// @returns Collection of basic events that are in the products.
   const std::unordered_set<const mef::BasicEvent*>& product_events() const {
@@ -134,14 +147,19 @@ class ProductContainer {
   /// @{
   auto begin() const {
     return boost::make_transform_iterator(products_.begin(),
-                                          ProductExtractor{graph_});
+                                          ProductExtractor{graph_, p_vars()});
   }
   auto end() const {
     return boost::make_transform_iterator(products_.end(),
-                                          ProductExtractor{graph_});
+                                          ProductExtractor{graph_, p_vars()});
   }
   /// @}
 
+  /// @returns The cached event probabilities if any.
+  const Pdag::IndexMap<double>* p_vars() const {
+    return p_vars_.empty() ? nullptr : &p_vars_;
+  }
+
   /// @returns true if no products in the container.
   bool empty() const { return products_.empty(); }
 
@@ -151,6 +169,11 @@ class ProductContainer {
   /// @returns The product distribution by order.
   const std::vector<int>& distribution() const { return distribution_; }
 
+  /// @returns The sum of product probabilities.
+  ///
+  /// @pre The container is constructed with the probability information.
+  double p_sum() const { return p_sum_; }
+
  private:
   const Zbdd& products_;  ///< Container of analysis results.
   const Pdag& graph_;  ///< The analysis graph.
@@ -158,6 +181,9 @@ class ProductContainer {
   std::vector<int> distribution_;  ///< Product counts by order.
   /// The set of events in the resultant products.
   std::unordered_set<const mef::BasicEvent*> product_events_;
+  /// The probabilities of the product events mapped by the event indices.
+  Pdag::IndexMap<double> p_vars_;
+  double p_sum_;  ///< The sum of product probabilities.
 };
 
 /// Prints a collection of products to the standard error.
@@ -238,6 +264,13 @@ class FaultTreeAnalysis : public Analysis {
     return *products_;
   }
 
+  /// @returns The statistics of the preprocessing passes.
+  ///          The statistics are empty
+  ///          if the preprocessed graph is loaded from the cache.
+  const std::vector<PassStats>& preprocessing() const {
+    return preprocessing_;
+  }
+
  protected:
   /// @returns Pointer to the PDAG representing the fault tree.
   const Pdag* graph() const { return graph_.get(); }
@@ -247,8 +280,10 @@ class FaultTreeAnalysis : public Analysis {
   ///
   /// @param[in,out] graph  A valid PDAG for analysis.
   ///
+  /// @returns The statistics of the preprocessing passes.
+  ///
   /// @post The graph transformation is semantically equivalent/isomorphic.
-  virtual void Preprocess(Pdag* graph) noexcept = 0;
+  virtual std::vector<PassStats> Preprocess(Pdag* graph) noexcept = 0;
 
   /// Generates a sum of products from a preprocessed PDAG.
   ///
@@ -271,6 +306,7 @@ class FaultTreeAnalysis : public Analysis {
   const mef::Model* model_;  ///< The optional Model with substitutions.
   std::unique_ptr<Pdag> graph_;  ///< PDAG of the fault tree.
   std::unique_ptr<const ProductContainer> products_;  ///< Container of results.
+  std::vector<PassStats> preprocessing_;  ///< Preprocessing pass statistics.
 };
 
 /// Fault tree analysis facility with specific algorithms.
@@ -290,13 +326,16 @@ class FaultTreeAnalyzer : public FaultTreeAnalysis {
   /// @}
 
  private:
-  void Preprocess(Pdag* graph) noexcept override {
-    CustomPreprocessor<Algorithm>{graph}();
+  std::vector<PassStats> Preprocess(Pdag* graph) noexcept override {
+    CustomPreprocessor<Algorithm> preprocessor(graph, Analysis::settings());
+    preprocessor();
+    return preprocessor.stats();
   }
 
   const Zbdd& GenerateProducts(const Pdag* graph) noexcept override {
     algorithm_ = std::make_unique<Algorithm>(graph, Analysis::settings());
     algorithm_->Analyze(graph);
+    algorithm_->GatherMetrics(&Analysis::metrics());
     return algorithm_->products();
   }
 
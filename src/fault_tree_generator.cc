@@ -0,0 +1,358 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the synthetic fault tree generator.
+
+#include "fault_tree_generator.h"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "ccf_group.h"
+#include "error.h"
+#include "expression/constant.h"
+#include "ext/algorithm.h"
+
+namespace scram::mef {
+
+namespace {
+
+/// The connectives in the order of the generator weights.
+const Connective kConnectives[] = {kAnd, kOr, kAtleast, kNot, kXor};
+
+/// The structure of a gate with arguments as indices.
+struct GateSpec {
+  Connective connective;  ///< The gate connective.
+  int min_number;  ///< The vote number for ATLEAST gates.
+  int depth;  ///< The longest path length from the root.
+  std::vector<int> gates;  ///< The indices of argument gates.
+  std::vector<int> basic_events;  ///< The indices of argument basic events.
+};
+
+/// Generator of the index-based fault tree structure.
+class Generator {
+ public:
+  /// @param[in] factors  The validated generation factors.
+  explicit Generator(const GeneratorFactors& factors)
+      : factors_(factors),
+        rng_(factors.seed),
+        connective_dist_(factors.weights.begin(), factors.weights.end()) {}
+
+  /// @returns The gates of the fault tree with the root gate first.
+  std::vector<GateSpec> operator()() {
+    num_gates_ = factors_.num_gates ? factors_.num_gates : EstimateNumGates();
+    max_args_ = std::max(2.0, 2 * factors_.num_args - 2);
+    AddGate(0);
+    for (int i = 0; i < num_specs(); ++i)
+      InitGate(i);
+    DistributeBasicEvents();
+    return std::move(gates_);
+  }
+
+  /// @returns The number of basic events created for the structure.
+  int num_basic_events() const { return num_basic_events_; }
+
+  /// @returns A random number in [0, 1).
+  double Uniform() { return std::uniform_real_distribution<>()(rng_); }
+
+  /// @returns A random integer in [low, high].
+  int Uniform(int low, int high) {
+    return std::uniform_int_distribution<>(low, high)(rng_);
+  }
+
+  /// @returns The pseudo-random number generator.
+  std::mt19937& rng() { return rng_; }
+
+ private:
+  /// @returns The number of gates in the structure.
+  int num_specs() const { return gates_.size(); }
+
+  /// Estimates the number of gates for all basic events.
+  /// Every gate gets (num_args * non-shared-fraction) new children,
+  /// and all the new children except the root are gates or basic events.
+  int EstimateNumGates() const {
+    double new_args =
+        factors_.num_args * (1 - factors_.common_b - factors_.common_g);
+    if (new_args <= 1) {
+      SCRAM_THROW(SettingsError("The sharing factors are too large "
+                                "to grow the fault tree."));
+    }
+    return std::max(1, static_cast<int>((factors_.num_basic - 1) /
+                                        (new_args - 1)));
+  }
+
+  /// Creates a new gate with a random connective.
+  ///
+  /// @param[in] depth  The depth of the new gate.
+  ///
+  /// @returns The index of the new gate.
+  int AddGate(int depth) {
+    Connective connective = kConnectives[connective_dist_(rng_)];
+    int min_number = 0;
+    if (connective == kAtleast)
+      min_number = 2;  // Finalized with the number of arguments.
+    gates_.push_back({connective, min_number, depth, {}, {}});
+    if (static_cast<int>(level_start_.size()) == depth)
+      level_start_.push_back(num_specs() - 1);
+    return num_specs() - 1;
+  }
+
+  /// @returns A random number of arguments for the connective.
+  int GetNumArgs(Connective connective) {
+    switch (connective) {
+      case kNot:
+        return 1;
+      case kXor:
+        return 2;
+      default:
+        break;
+    }
+    int max_args = static_cast<int>(max_args_);
+    if (Uniform() < (max_args_ - max_args))
+      ++max_args;  // Dealing with the fractional part.
+    if (connective == kAtleast)
+      return Uniform(3, std::max(3, max_args));
+    return Uniform(2, max_args);
+  }
+
+  /// Fills the arguments of the gate.
+  ///
+  /// @param[in] index  The index of the gate in the structure.
+  void InitGate(int index) {
+    int num_args = GetNumArgs(gates_[index].connective);
+    int depth = gates_[index].depth;
+    bool can_grow = !factors_.max_depth || depth + 1 < factors_.max_depth;
+    bool has_child_gate = false;
+    for (int i = 0; i < num_args; ++i) {
+      int free_gates = num_gates_ - num_specs();
+      int free_events = factors_.num_basic - num_basic_events_;
+      // Prevents the early extinction of the breadth-first growth.
+      bool force = can_grow && free_gates > 0 && !has_child_gate &&
+                   i == num_args - 1 && index + 1 == num_specs();
+      double r = force ? 1 : Uniform();
+      if (r < factors_.common_g && AddSharedGate(index))
+        continue;
+      if (r < factors_.common_g + factors_.common_b && num_basic_events_ &&
+          AddSharedBasicEvent(index)) {
+        continue;
+      }
+      if (can_grow && free_gates > 0 &&
+          (!free_events || force ||
+           Uniform() * (free_gates + free_events) < free_gates)) {
+        int child = AddGate(depth + 1);
+        gates_[index].gates.push_back(child);
+        has_child_gate = true;
+      } else if (free_events) {
+        gates_[index].basic_events.push_back(num_basic_events_++);
+      } else {
+        AddSharedBasicEvent(index);
+      }
+    }
+    if (gates_[index].connective == kAtleast) {
+      int size = gates_[index].gates.size() + gates_[index].basic_events.size();
+      gates_[index].min_number = Uniform(2, size - 1);
+    }
+  }
+
+  /// Adds a random gate from deeper levels into arguments.
+  ///
+  /// @returns false if no candidate is available.
+  bool AddSharedGate(int index) {
+    int level = gates_[index].depth + 1;
+    if (level >= static_cast<int>(level_start_.size()))
+      return false;
+    int first = level_start_[level];
+    int last = num_specs() - 1;
+    if (first > last)
+      return false;
+    int candidate = Uniform(first, last);
+    if (ext::any_of(gates_[index].gates,
+                    [candidate](int arg) { return arg == candidate; })) {
+      return false;
+    }
+    gates_[index].gates.push_back(candidate);
+    return true;
+  }
+
+  /// Adds a random existing basic event into arguments.
+  /// If the random event is already an argument,
+  /// the next one not in the arguments is chosen.
+  ///
+  /// @returns false if all the existing events are already arguments.
+  bool AddSharedBasicEvent(int index) {
+    std::vector<int>& args = gates_[index].basic_events;
+    int start = Uniform(0, num_basic_events_ - 1);
+    for (int i = 0; i < num_basic_events_; ++i) {
+      int candidate = (start + i) % num_basic_events_;
+      if (std::find(args.begin(), args.end(), candidate) == args.end()) {
+        args.push_back(candidate);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Adds the unused basic events into random variadic gates.
+  void DistributeBasicEvents() {
+    std::vector<int> variadic;
+    for (int i = 0; i < num_specs(); ++i) {
+      if (gates_[i].connective != kNot && gates_[i].connective != kXor)
+        variadic.push_back(i);
+    }
+    if (variadic.empty())
+      return;
+    for (; num_basic_events_ < factors_.num_basic; ++num_basic_events_) {
+      int gate = variadic[Uniform(0, variadic.size() - 1)];
+      gates_[gate].basic_events.push_back(num_basic_events_);
+    }
+  }
+
+  const GeneratorFactors& factors_;  ///< The generation factors.
+  std::mt19937 rng_;  ///< The pseudo-random number generator.
+  std::discrete_distribution<> connective_dist_;  ///< Weighted connectives.
+  int num_gates_ = 0;  ///< The target number of gates.
+  double max_args_ = 0;  ///< The max number of args with the mean num_args.
+  int num_basic_events_ = 0;  ///< The number of created basic events.
+  std::vector<GateSpec> gates_;  ///< The gates in the breadth-first order.
+  std::vector<int> level_start_;  ///< The first gate index of each depth.
+};
+
+/// Validates the generation factors.
+///
+/// @throws SettingsError  The factors are invalid.
+void Validate(const GeneratorFactors& factors) {
+  if (factors.num_basic < 1)
+    SCRAM_THROW(SettingsError("The number of basic events must be positive."));
+  if (factors.num_gates < 0)
+    SCRAM_THROW(SettingsError("The number of gates cannot be negative."));
+  if (factors.num_args < 2)
+    SCRAM_THROW(SettingsError("The average number of arguments must be >= 2."));
+  if (factors.num_basic < 2 * factors.num_args) {
+    SCRAM_THROW(SettingsError("The number of basic events must be at least "
+                              "twice the average number of arguments."));
+  }
+  if (factors.common_b < 0 || factors.common_g < 0 ||
+      factors.common_b + factors.common_g >= 1) {
+    SCRAM_THROW(SettingsError("The sharing factors must be non-negative "
+                              "with the sum less than 1."));
+  }
+  if (ext::any_of(factors.weights, [](double w) { return w < 0; }) ||
+      ext::none_of(factors.weights, [](double w) { return w > 0; })) {
+    SCRAM_THROW(SettingsError("The connective weights must be non-negative "
+                              "with at least one positive weight."));
+  }
+  if (factors.weights[0] == 0 && factors.weights[1] == 0 &&
+      factors.weights[2] == 0) {
+    SCRAM_THROW(SettingsError("NOT and XOR connectives alone "
+                              "cannot grow the fault tree."));
+  }
+  if (factors.max_depth < 0)
+    SCRAM_THROW(SettingsError("The max depth cannot be negative."));
+  if (factors.num_ccf < 0)
+    SCRAM_THROW(SettingsError("The number of CCF groups cannot be negative."));
+  if (factors.min_prob < 0 || factors.max_prob > 1 ||
+      factors.min_prob > factors.max_prob) {
+    SCRAM_THROW(SettingsError("Invalid basic event probability range."));
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<Model> GenerateFaultTree(const GeneratorFactors& factors) {
+  Validate(factors);
+  Generator generator(factors);
+  std::vector<GateSpec> specs = generator();
+  int num_gates = specs.size();
+
+  auto model = std::make_unique<Model>();
+  auto add_expression = [&model](double value) {
+    auto expression = std::make_unique<ConstantExpression>(value);
+    Expression* address = expression.get();
+    model->Add(std::move(expression));
+    return address;
+  };
+  auto probability = [&generator, &factors] {
+    return factors.min_prob +
+           (factors.max_prob - factors.min_prob) * generator.Uniform();
+  };
+
+  std::vector<BasicEvent*> basic_events;
+  for (int i = 0; i < generator.num_basic_events(); ++i) {
+    auto basic_event =
+        std::make_unique<BasicEvent>("B" + std::to_string(i + 1));
+    basic_event->expression(add_expression(probability()));
+    basic_events.push_back(basic_event.get());
+    model->Add(std::move(basic_event));
+  }
+
+  auto fault_tree = std::make_unique<FaultTree>(factors.ft_name);
+  std::vector<Gate*> gates;
+  for (int i = 0; i < num_gates; ++i) {
+    auto gate = std::make_unique<Gate>(i ? "G" + std::to_string(i)
+                                         : factors.root);
+    gates.push_back(gate.get());
+    fault_tree->Add(gate.get());
+    model->Add(std::move(gate));
+  }
+  for (int i = 0; i < num_gates; ++i) {
+    const GateSpec& spec = specs[i];
+    Formula::ArgSet args;
+    for (int index : spec.gates)
+      args.Add(gates[index]);
+    for (int index : spec.basic_events)
+      args.Add(basic_events[index]);
+    std::optional<int> min_number;
+    if (spec.connective == kAtleast)
+      min_number = spec.min_number;
+    gates[i]->formula(std::make_unique<Formula>(spec.connective,
+                                                std::move(args), min_number));
+  }
+  model->Add(std::move(fault_tree));
+
+  // CCF groups over disjoint random sets of basic events.
+  std::shuffle(basic_events.begin(), basic_events.end(), generator.rng());
+  auto it_member = basic_events.begin();
+  int max_size = std::max(2, static_cast<int>(2 * factors.num_args - 2));
+  for (int i = 0; i < factors.num_ccf; ++i) {
+    int size = generator.Uniform(2, max_size);
+    if (std::distance(it_member, basic_events.end()) < size)
+      break;
+    auto ccf_group = std::make_unique<MglModel>("CCF" + std::to_string(i + 1));
+    for (auto it_end = it_member + size; it_member != it_end; ++it_member)
+      ccf_group->AddMember(*it_member);
+    ccf_group->AddDistribution(add_expression(probability()));
+    int levels = generator.Uniform(2, size);
+    for (int level = 2; level <= levels; ++level) {
+      ccf_group->AddFactor(add_expression(0.1 + 0.9 * generator.Uniform()),
+                           level);
+    }
+    ccf_group->Validate();
+    model->Add(std::move(ccf_group));
+  }
+
+  for (FaultTree& ft : model->table<FaultTree>())
+    ft.CollectTopEvents();
+  for (CcfGroup& group : model->table<CcfGroup>())
+    group.ApplyModel();
+  return model;
+}
+
+}  // namespace scram::mef
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Generator of synthetic fault trees directly into MEF models.
+///
+/// This is the native counterpart of scripts/fault_tree_generator.py
+/// for stress benchmarks that sweep the model size
+/// without producing and parsing XML files.
+
+#pragma once
+
+#include <cstdint>
+
+#include <array>
+#include <memory>
+#include <string>
+
+#include "model.h"
+
+namespace scram::mef {
+
+/// Factors that determine the size and complexity of generated fault trees.
+struct GeneratorFactors {
+  std::string ft_name = "Autogenerated";  ///< The name of the fault tree.
+  std::string root = "root";  ///< The name of the top gate.
+  std::uint32_t seed = 123;  ///< The seed of the pseudo-random generator.
+  int num_basic = 100;  ///< The number of basic events.
+  /// The target number of gates (0 to estimate from the other factors).
+  int num_gates = 0;
+  double num_args = 3;  ///< The average number of gate arguments.
+  double common_b = 0.1;  ///< The fraction of arguments with shared events.
+  double common_g = 0.1;  ///< The fraction of arguments with shared gates.
+  /// The weights of AND, OR, ATLEAST, NOT, XOR connectives.
+  std::array<double, 5> weights = {1, 1, 0, 0, 0};
+  int max_depth = 0;  ///< The maximum depth of gates (0 for no limit).
+  int num_ccf = 0;  ///< The number of CCF groups (MGL model).
+  double min_prob = 0.01;  ///< The minimum probability of basic events.
+  double max_prob = 0.1;  ///< The maximum probability of basic events.
+};
+
+/// Generates a single fault tree model with the given complexity factors.
+///
+/// Gates are created breadth-first from the root,
+/// and shared gates are taken only from deeper levels,
+/// so the graph is acyclic by construction,
+/// and the max depth limit holds for all paths.
+/// The number of gates is a target that may not be met
+/// if the depth limit or the sharing factors exhaust the tree growth.
+///
+/// @param[in] factors  The generation factors.
+///
+/// @returns The model fully initialized for analysis
+///          (top events collected, CCF models applied).
+///
+/// @throws SettingsError  The factors are invalid or inconsistent.
+std::unique_ptr<Model> GenerateFaultTree(const GeneratorFactors& factors);
+
+}  // namespace scram::mef
@@ -29,6 +29,22 @@
 
 namespace scram::core {
 
+ImportanceFactors CalculateImportanceFactors(int occurrence, double p_var,
+                                             double mif,
+                                             double p_total) noexcept {
+  ImportanceFactors imp{};
+  imp.occurrence = occurrence;
+  imp.mif = mif;
+  if (p_total != 0) {
+    imp.cif = p_var * imp.mif / p_total;
+    imp.raw = 1 + (1 - p_var) * imp.mif / p_total;
+    imp.dif = p_var * imp.raw;
+    if (p_total != p_var * imp.mif)
+      imp.rrw = p_total / (p_total - p_var * imp.mif);
+  }
+  return imp;
+}
+
 ImportanceAnalysis::ImportanceAnalysis(const ProbabilityAnalysis* prob_analysis)
     : Analysis(prob_analysis->settings()) {}
 
@@ -44,18 +60,9 @@ void ImportanceAnalysis::Analyze() noexcept {
     if (occurrences[i] == 0)
       continue;
     const mef::BasicEvent& event = *basic_events[i];
-    double p_var = event.p();
-    ImportanceFactors imp{};
-    imp.occurrence = occurrences[i];
-    imp.mif = this->CalculateMif(i);
-    if (p_total != 0) {
-      imp.cif = p_var * imp.mif / p_total;
-      imp.raw = 1 + (1 - p_var) * imp.mif / p_total;
-      imp.dif = p_var * imp.raw;
-      if (p_total != p_var * imp.mif)
-        imp.rrw = p_total / (p_total - p_var * imp.mif);
-    }
-    importance_.push_back({event, imp});
+    importance_.push_back(
+        {event, CalculateImportanceFactors(occurrences[i], event.p(),
+                                           this->CalculateMif(i), p_total)});
   }
   LOG(DEBUG3) << "Calculated importance factors in " << DUR(imp_time);
   Analysis::AddAnalysisTime(DUR(imp_time));
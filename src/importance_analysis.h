@@ -49,6 +49,19 @@ struct ImportanceRecord {
   const ImportanceFactors factors;  ///< The importance factors of the event.
 };
 
+/// Derives the importance factors of an event
+/// from its marginal importance factor.
+///
+/// @param[in] occurrence  The number of products with the event.
+/// @param[in] p_var  The probability of the event.
+/// @param[in] mif  The Birnbaum marginal importance factor of the event.
+/// @param[in] p_total  The total probability.
+///
+/// @returns The importance factors of the event.
+ImportanceFactors CalculateImportanceFactors(int occurrence, double p_var,
+                                             double mif,
+                                             double p_total) noexcept;
+
 class Zbdd;  // The container of products to be queries for important events.
 
 /// Analysis of importance factors of risk model variables.
@@ -20,8 +20,12 @@
 
 #include "initializer.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <functional>  // std::mem_fn
 #include <sstream>
+#include <thread>
 #include <type_traits>
 
 #include <boost/exception/errinfo_at_line.hpp>
@@ -70,6 +74,37 @@ RoleSpecifier GetRole(const std::string_view& s, RoleSpecifier parent_role) {
   return s.empty() ? parent_role : GetRole(s);
 }
 
+/// Attaches the label to the element of the analysis.
+///
+/// @param[in] label  The XML label element.
+/// @param[out] element  The object that needs the label.
+void AttachLabel(const xml::Element& label, Element* element) {
+  assert(label.name() == "label");
+  assert(element->label().empty() && "Resetting element label.");
+  element->label(std::string(label.text()));
+}
+
+/// Attaches the Open-PSA MEF arbitrary attributes to the element.
+///
+/// @param[in] attributes  The XML container of the attributes.
+/// @param[out] element  The object that needs attributes.
+///
+/// @throws ValidityError  Invalid attribute setting.
+void AttachAttributes(const xml::Element& attributes, Element* element) {
+  assert(attributes.name() == "attributes");
+  for (const xml::Element& attribute : attributes.children()) {
+    assert(attribute.name() == "attribute");
+    try {
+      element->AddAttribute({std::string(attribute.attribute("name")),
+                             std::string(attribute.attribute("value")),
+                             std::string(attribute.attribute("type"))});
+    } catch (ValidityError& err) {
+      err << boost::errinfo_at_line(attribute.line());
+      throw;
+    }
+  }
+}
+
 /// Attaches attributes and a label to the elements of the analysis.
 /// These attributes are not XML attributes
 /// but the Open-PSA format defined arbitrary attributes
@@ -81,25 +116,89 @@ RoleSpecifier GetRole(const std::string_view& s, RoleSpecifier parent_role) {
 /// @throws ValidityError  Invalid attribute setting.
 void AttachLabelAndAttributes(const xml::Element& xml_element,
                               Element* element) {
-  if (std::optional<xml::Element> label = xml_element.child("label")) {
-    assert(element->label().empty() && "Resetting element label.");
-    element->label(std::string(label->text()));
+  if (std::optional<xml::Element> label = xml_element.child("label"))
+    AttachLabel(*label, element);
+
+  if (std::optional<xml::Element> attributes = xml_element.child("attributes"))
+    AttachAttributes(*attributes, element);
+}
+
+/// Attaches the label or attributes
+/// streamed separately from the owner element.
+///
+/// @param[in] xml_node  The label or attributes XML element.
+/// @param[out] element  The owner of the label and attributes.
+///
+/// @returns false if the XML element is neither label nor attributes.
+///
+/// @throws ValidityError  Invalid attribute setting.
+bool AttachLabelOrAttributes(const xml::Element& xml_node, Element* element) {
+  if (xml_node.name() == "label") {
+    AttachLabel(xml_node, element);
+  } else if (xml_node.name() == "attributes") {
+    AttachAttributes(xml_node, element);
+  } else {
+    return false;
   }
+  return true;
+}
 
-  std::optional<xml::Element> attributes = xml_element.child("attributes");
-  if (!attributes)
-    return;
-  for (const xml::Element& attribute : attributes->children()) {
-    assert(attribute.name() == "attribute");
-    try {
-      element->AddAttribute({std::string(attribute.attribute("name")),
-                             std::string(attribute.attribute("value")),
-                             std::string(attribute.attribute("type"))});
-    } catch (ValidityError& err) {
-      err << boost::errinfo_at_line(attribute.line());
-      throw;
-    }
+/// Finds the pre-order index of the XML element in the subtree.
+///
+/// @param[in] root  The root of the subtree with index 0.
+/// @param[in] xml_node  The descendant XML element to find.
+/// @param[in,out] index  The running index of the traversal.
+///
+/// @returns true if the element is found at the resulting index.
+bool FindNode(const xml::Element& root, const xml::Element& xml_node,
+              int* index) {
+  if (root == xml_node)
+    return true;
+  for (const xml::Element& child : root.children()) {
+    ++*index;
+    if (FindNode(child, xml_node, index))
+      return true;
   }
+  return false;
+}
+
+/// Retrieves the XML element at the pre-order index in the subtree.
+///
+/// @param[in] root  The root of the subtree with index 0.
+/// @param[in,out] index  The remaining distance in the traversal.
+///
+/// @returns The XML element if found in the subtree.
+std::optional<xml::Element> GetNode(const xml::Element& root, int* index) {
+  if (*index == 0)
+    return root;
+  for (const xml::Element& child : root.children()) {
+    --*index;
+    if (std::optional<xml::Element> xml_node = GetNode(child, index))
+      return xml_node;
+  }
+  return {};
+}
+
+/// @param[in] root  The root of the subtree with index 0.
+/// @param[in] index  The pre-order index of the descendant XML element.
+///
+/// @returns The XML element at the pre-order index.
+xml::Element GetNode(const xml::Element& root, int index) {
+  std::optional<xml::Element> xml_node = GetNode(root, &index);
+  assert(xml_node && "The index is out of the subtree.");
+  return *xml_node;
+}
+
+/// Checks whether the XML element is a container of other definitions
+/// streamed without loading the whole container subtree.
+///
+/// @param[in] xml_node  The XML element visited by the reader.
+///
+/// @returns true for the containers entered by the streaming reader.
+bool IsContainer(const xml::Element& xml_node) {
+  std::string_view name = xml_node.name();
+  return name == "opsa-mef" || name == "define-fault-tree" ||
+         name == "define-component" || name == "model-data";
 }
 
 /// Constructs Element of type T from an XML element.
@@ -157,10 +256,12 @@ ConstructElement<Phase>(const xml::Element& xml_element) {
 
 Initializer::Initializer(const std::vector<std::string>& xml_files,
                          core::Settings settings, bool allow_extern,
-                         xml::Validator* extra_validator)
+                         xml::Validator* extra_validator,
+                         const std::string& model_cache)
     : settings_(std::move(settings)),
       allow_extern_(allow_extern),
-      extra_validator_(extra_validator) {
+      extra_validator_(extra_validator),
+      model_cache_(model_cache) {
   BLOG(WARNING, allow_extern_) << "Enabling external dynamic libraries";
   ProcessInputFiles(xml_files);
 }
@@ -189,39 +290,54 @@ void Initializer::CheckDuplicateFiles(
 }
 
 void Initializer::ProcessInputFiles(const std::vector<std::string>& xml_files) {
-  static xml::Validator validator(env::input_schema());
-
   CLOCK(input_time);
   LOG(DEBUG1) << "Processing input files";
   CheckFileExistence(xml_files);
   CheckDuplicateFiles(xml_files);
-  for (const auto& xml_file : xml_files) {
-    CLOCK(parse_time);
-    LOG(DEBUG3) << "Parsing " << xml_file << " ...";
-    xml::Document document(xml_file, &validator);
-    if (extra_validator_)
-      extra_validator_->validate(document);
-    documents_.emplace_back(std::move(document));
-    LOG(DEBUG3) << "Parsed " << xml_file << " in " << DUR(parse_time);
-  }
-  CLOCK(def_time);
-  for (const xml::Document& document : documents_) {
-    try {
-      ProcessInputFile(document);
-    } catch (ValidityError& err) {
-      err << boost::errinfo_file_name(document.root().filename());
-      throw;
+  // The snapshots skip the extra validation; hence, no caching with it.
+  std::optional<ModelCache> cache;
+  if (!model_cache_.empty() && !extra_validator_) {
+    cache.emplace(model_cache_, xml_files, settings_);
+    if (cache->enabled() && (model_ = cache->Load())) {
+      model_->mission_time().value(settings_.mission_time());
+      LOG(DEBUG1) << "Loaded the model snapshot " << cache->snapshot()
+                  << " in " << DUR(input_time);
     }
   }
-  ProcessTbdElements();
-  LOG(DEBUG2) << "Element definition time " << DUR(def_time);
-  LOG(DEBUG1) << "Input files are processed in " << DUR(input_time);
 
-  CLOCK(valid_time);
-  LOG(DEBUG1) << "Validating the initialization";
-  // Check if the initialization is successful.
-  ValidateInitialization();
-  LOG(DEBUG1) << "Validation is finished in " << DUR(valid_time);
+  if (!model_) {
+    // The input files are streamed without keeping their DOM in memory.
+    // The complete validation precedes any registration
+    // so that the registration works only with valid structures.
+    CLOCK(parse_time);
+    ValidateInputFiles(xml_files);
+    LOG(DEBUG2) << "Input file validation time " << DUR(parse_time);
+    CLOCK(def_time);
+    for (const auto& xml_file : xml_files) {
+      CLOCK(register_time);
+      xml_file_ = &xml_file;
+      xml::Reader reader(xml_file);
+      try {
+        ProcessInputFile(&reader);
+      } catch (ValidityError& err) {
+        err << boost::errinfo_file_name(xml_file);
+        throw;
+      }
+      LOG(DEBUG3) << "Registered " << xml_file << " in " << DUR(register_time);
+    }
+    ProcessTbdElements(xml_files);
+    LOG(DEBUG2) << "Element definition time " << DUR(def_time);
+    LOG(DEBUG1) << "Input files are processed in " << DUR(input_time);
+
+    CLOCK(valid_time);
+    LOG(DEBUG1) << "Validating the initialization";
+    // Check if the initialization is successful.
+    ValidateInitialization();
+    LOG(DEBUG1) << "Validation is finished in " << DUR(valid_time);
+
+    if (cache && cache->enabled())
+      StoreModel(*cache);
+  }
 
   CLOCK(setup_time);
   LOG(DEBUG1) << "Setting up for the analysis";
@@ -232,6 +348,56 @@ void Initializer::ProcessInputFiles(const std::vector<std::string>& xml_files) {
   LOG(DEBUG1) << "Setup time " << DUR(setup_time);
 }
 
+void Initializer::StoreModel(const ModelCache& cache) {
+  CLOCK(store_time);
+  try {
+    if (cache.Store(*model_)) {
+      LOG(DEBUG1) << "Stored the model snapshot " << cache.snapshot()
+                  << " in " << DUR(store_time);
+    } else {
+      LOG(DEBUG1) << "The model constructs are not supported by the cache";
+    }
+  } catch (IOError& err) {
+    LOG(WARNING) << "Failed to store the model snapshot: " << err.what();
+  }
+}
+
+void Initializer::ValidateInputFiles(
+    const std::vector<std::string>& xml_files) {
+  static xml::Validator validator(env::input_schema());
+
+  // The workers take the next file in order;
+  // the reported error is deterministic as if validated sequentially.
+  std::vector<std::exception_ptr> errors(xml_files.size());
+  std::atomic<std::size_t> next_file = 0;
+  auto validate = [this, &xml_files, &errors, &next_file] {
+    for (std::size_t i; (i = next_file++) < xml_files.size();) {
+      try {
+        xml::Reader(xml_files[i], &validator).Validate();
+        if (extra_validator_)
+          xml::Reader(xml_files[i], extra_validator_).Validate();
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+  std::size_t num_threads = std::min<std::size_t>(
+      xml_files.size(), std::thread::hardware_concurrency());
+  LOG(DEBUG3) << "Validating " << xml_files.size() << " files with "
+              << std::max<std::size_t>(num_threads, 1) << " threads";
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < num_threads; ++i)
+    workers.emplace_back(validate);
+  validate();  // The calling thread is one of the workers.
+  for (std::thread& worker : workers)
+    worker.join();
+
+  for (const std::exception_ptr& error : errors) {
+    if (error)
+      std::rethrow_exception(error);
+  }
+}
+
 template <class T>
 void Initializer::Register(std::unique_ptr<T> element,
                            const xml::Element& xml_element) {
@@ -254,7 +420,7 @@ Gate* Initializer::Register(const xml::Element& gate_node,
   auto* gate = ptr.get();
   Register(std::move(ptr), gate_node);
   path_gates_.insert(gate);
-  tbd_.emplace_back(gate, gate_node);
+  tbd_.emplace_back(gate, Locate(gate_node));
   return gate;
 }
 
@@ -267,7 +433,7 @@ BasicEvent* Initializer::Register(const xml::Element& event_node,
   auto* basic_event = ptr.get();
   Register(std::move(ptr), event_node);
   path_basic_events_.insert(basic_event);
-  tbd_.emplace_back(basic_event, event_node);
+  tbd_.emplace_back(basic_event, Locate(event_node));
   return basic_event;
 }
 
@@ -297,7 +463,7 @@ Parameter* Initializer::Register(const xml::Element& param_node,
   auto* parameter = ptr.get();
   Register(std::move(ptr), param_node);
   path_parameters_.insert(parameter);
-  tbd_.emplace_back(parameter, param_node);
+  tbd_.emplace_back(parameter, Locate(param_node));
 
   // Attach units.
   std::string_view unit = param_node.attribute("unit");
@@ -332,7 +498,7 @@ CcfGroup* Initializer::Register(const xml::Element& ccf_node,
 
   ProcessCcfMembers(*ccf_node.child("members"), ccf_group);
 
-  tbd_.emplace_back(ccf_group, ccf_node);
+  tbd_.emplace_back(ccf_group, Locate(ccf_node));
   return ccf_group;
 }
 
@@ -343,40 +509,55 @@ Sequence* Initializer::Register(const xml::Element& xml_node,
   std::unique_ptr<Sequence> ptr = ConstructElement<Sequence>(xml_node);
   auto* sequence = ptr.get();
   Register(std::move(ptr), xml_node);
-  tbd_.emplace_back(sequence, xml_node);
+  tbd_.emplace_back(sequence, Locate(xml_node));
   return sequence;
 }
 /// @}
 
-void Initializer::ProcessInputFile(const xml::Document& document) {
-  xml::Element root = document.root();
-  assert(root.name() == "opsa-mef");
+void Initializer::ProcessInputFile(xml::Reader* reader) {
+  std::optional<xml::Element> root = reader->NextChild();
+  assert(root && root->name() == "opsa-mef");
 
+  Model* model = nullptr;  // The label and attributes are from the first file.
   if (!model_) {  // Create only one model for multiple files.
-    model_ = ConstructElement<Model>(root);
+    model_ = std::make_unique<Model>(std::string(root->attribute("name")));
     model_->mission_time().value(settings_.mission_time());
-  }
+    model = model_.get();
+  }
+
+  reader->Enter();
+  while (std::optional<xml::Element> child = reader->NextChild()) {
+    if (IsContainer(*child)) {
+      reader->Enter();
+      if (child->name() == "define-fault-tree") {
+        DefineFaultTree(*child, reader);
+      } else {
+        assert(child->name() == "model-data");
+        ProcessModelData(reader);
+      }
+      continue;
+    }
+    xml::Element node = ExpandUnit(reader);
+    if (node.name() == "label" || node.name() == "attributes") {
+      if (model)
+        AttachLabelOrAttributes(node, model);
 
-  for (const xml::Element& node : root.children()) {
-    if (node.name() == "define-initiating-event") {
+    } else if (node.name() == "define-initiating-event") {
       std::unique_ptr<InitiatingEvent> initiating_event =
           ConstructElement<InitiatingEvent>(node);
       auto* ref_ptr = initiating_event.get();
       Register(std::move(initiating_event), node);
-      tbd_.emplace_back(ref_ptr, node);
+      tbd_.emplace_back(ref_ptr, Locate(node));
 
     } else if (node.name() == "define-rule") {
       std::unique_ptr<Rule> rule = ConstructElement<Rule>(node);
       auto* ref_ptr = rule.get();
       Register(std::move(rule), node);
-      tbd_.emplace_back(ref_ptr, node);
+      tbd_.emplace_back(ref_ptr, Locate(node));
 
     } else if (node.name() == "define-event-tree") {
       DefineEventTree(node);
 
-    } else if (node.name() == "define-fault-tree") {
-      DefineFaultTree(node);
-
     } else if (node.name() == "define-CCF-group") {
       Register<CcfGroup>(node, "", RoleSpecifier::kPublic);
 
@@ -384,17 +565,14 @@ void Initializer::ProcessInputFile(const xml::Document& document) {
       std::unique_ptr<Alignment> alignment = ConstructElement<Alignment>(node);
       auto* address = alignment.get();
       Register(std::move(alignment), node);
-      tbd_.emplace_back(address, node);
+      tbd_.emplace_back(address, Locate(node));
 
     } else if (node.name() == "define-substitution") {
       std::unique_ptr<Substitution> substitution =
           ConstructElement<Substitution>(node);
       auto* address = substitution.get();
       Register(std::move(substitution), node);
-      tbd_.emplace_back(address, node);
-
-    } else if (node.name() == "model-data") {
-      ProcessModelData(node);
+      tbd_.emplace_back(address, Locate(node));
 
     } else if (node.name() == "define-extern-library") {
       if (!allow_extern_) {
@@ -404,10 +582,27 @@ void Initializer::ProcessInputFile(const xml::Document& document) {
             << boost::errinfo_at_line(node.line());
       }
       DefineExternLibraries(node);
+
+    } else if (node.name() == "define-extern-function") {
+      has_extern_functions_ = true;  // Defined before any other elements.
     }
   }
 }
 
+xml::Element Initializer::ExpandUnit(xml::Reader* reader) {
+  ++num_units_;
+  unit_ = reader->Expand();
+  return *unit_;
+}
+
+Initializer::TbdLocation Initializer::Locate(const xml::Element& xml_node) {
+  assert(unit_ && "Undefined definition unit.");
+  int node = 0;
+  [[maybe_unused]] bool found = FindNode(*unit_, xml_node, &node);
+  assert(found && "The XML node is outside of the definition unit.");
+  return {num_units_, node};
+}
+
 /// Specializations for elements defined after registration.
 /// @{
 template <>
@@ -590,29 +785,69 @@ void Initializer::Define(const xml::Element& xml_node,
 }
 /// @}
 
-void Initializer::ProcessTbdElements() {
-  for (const xml::Document& document : documents_) {
-    xml::Element root = document.root();
-    for (const xml::Element& node : root.children("define-extern-function")) {
-      try {
-        DefineExternFunction(node);
-      } catch (ValidityError& err) {
-        err << boost::errinfo_file_name(root.filename());
-        throw;
+void Initializer::ProcessTbdElements(
+    const std::vector<std::string>& xml_files) {
+  if (has_extern_functions_) {  // Must be defined before expressions.
+    for (const auto& xml_file : xml_files) {
+      xml_file_ = &xml_file;
+      xml::Reader reader(xml_file);
+      reader.NextChild();
+      reader.Enter();
+      while (std::optional<xml::Element> node = reader.NextChild()) {
+        if (node->name() != "define-extern-function")
+          continue;
+        try {
+          DefineExternFunction(reader.Expand());
+        } catch (ValidityError& err) {
+          err << boost::errinfo_file_name(xml_file);
+          throw;
+        }
       }
     }
   }
 
-  for (const auto& [tbd_element, xml_element] : tbd_) {
+  num_units_ = 0;
+  std::size_t next = 0;
+  for (const auto& xml_file : xml_files) {
+    if (next == tbd_.size())
+      break;
+    xml_file_ = &xml_file;
+    xml::Reader reader(xml_file);
     try {
+      DefineTbdElements(&reader, &next);
+    } catch (ValidityError& err) {
+      err << boost::errinfo_file_name(xml_file);
+      throw;
+    }
+  }
+  assert(next == tbd_.size() && "Undefined late elements.");
+  unit_.reset();
+}
+
+void Initializer::DefineTbdElements(xml::Reader* reader, std::size_t* next) {
+  while (*next < tbd_.size()) {
+    std::optional<xml::Element> child = reader->NextChild();
+    if (!child)
+      return;
+    if (IsContainer(*child)) {
+      reader->Enter();
+      DefineTbdElements(reader, next);
+      continue;
+    }
+    ++num_units_;
+    if (tbd_[*next].second.unit != num_units_)
+      continue;
+    xml::Element unit = reader->Expand();
+    for (; *next < tbd_.size() && tbd_[*next].second.unit == num_units_;
+         ++*next) {
+      const auto& [tbd_element, location] = tbd_[*next];
+      xml::Element xml_node =
+          location.node ? GetNode(unit, location.node) : unit;
       std::visit(
-          [this, &xml_element](auto* tbd_construct) {
-            this->Define(xml_element, tbd_construct);
+          [this, &xml_node](auto* tbd_construct) {
+            this->Define(xml_node, tbd_construct);
           },
           tbd_element);
-    } catch (ValidityError& err) {
-      err << boost::errinfo_file_name(xml_element.filename());
-      throw;
     }
   }
 }
@@ -642,30 +877,49 @@ void Initializer::DefineEventTree(const xml::Element& et_node) {
   EventTree* tbd_element = event_tree.get();
   Register(std::move(event_tree), et_node);
   // Save only after registration.
-  tbd_.emplace_back(tbd_element, et_node);
+  tbd_.emplace_back(tbd_element, Locate(et_node));
 }
 
-void Initializer::DefineFaultTree(const xml::Element& ft_node) {
-  std::unique_ptr<FaultTree> fault_tree = ConstructElement<FaultTree>(ft_node);
-  RegisterFaultTreeData(ft_node, fault_tree->name(), fault_tree.get());
+void Initializer::DefineFaultTree(const xml::Element& ft_node,
+                                  xml::Reader* reader) {
+  auto fault_tree =
+      std::make_unique<FaultTree>(std::string(ft_node.attribute("name")));
+  RegisterFaultTreeData(reader, fault_tree->name(), fault_tree.get());
   Register(std::move(fault_tree), ft_node);
 }
 
 std::unique_ptr<Component> Initializer::DefineComponent(
-    const xml::Element& component_node, const std::string& base_path,
-    RoleSpecifier container_role) {
-  std::unique_ptr<Component> component =
-      ConstructElement<Component>(component_node, base_path, container_role);
-  RegisterFaultTreeData(component_node, base_path + "." + component->name(),
+    const xml::Element& component_node, xml::Reader* reader,
+    const std::string& base_path, RoleSpecifier container_role) {
+  auto component = std::make_unique<Component>(
+      std::string(component_node.attribute("name")), base_path,
+      GetRole(component_node.attribute("role"), container_role));
+  RegisterFaultTreeData(reader, base_path + "." + component->name(),
                         component.get());
   return component;
 }
 
-void Initializer::RegisterFaultTreeData(const xml::Element& ft_node,
+void Initializer::RegisterFaultTreeData(xml::Reader* reader,
                                         const std::string& base_path,
                                         Component* component) {
-  for (const xml::Element& node : ft_node.children()) {
-    if (node.name() == "define-basic-event") {
+  while (std::optional<xml::Element> child = reader->NextChild()) {
+    if (child->name() == "define-component") {
+      reader->Enter();
+      std::unique_ptr<Component> sub =
+          DefineComponent(*child, reader, base_path, component->role());
+      try {
+        component->Add(std::move(sub));
+      } catch (ValidityError& err) {
+        err << boost::errinfo_at_line(child->line());
+        throw;
+      }
+      continue;
+    }
+    xml::Element node = ExpandUnit(reader);
+    if (AttachLabelOrAttributes(node, component)) {
+      continue;
+
+    } else if (node.name() == "define-basic-event") {
       component->Add(Register<BasicEvent>(node, base_path, component->role()));
 
     } else if (node.name() == "define-parameter") {
@@ -679,22 +933,13 @@ void Initializer::RegisterFaultTreeData(const xml::Element& ft_node,
 
     } else if (node.name() == "define-CCF-group") {
       component->Add(Register<CcfGroup>(node, base_path, component->role()));
-
-    } else if (node.name() == "define-component") {
-      std::unique_ptr<Component> sub =
-          DefineComponent(node, base_path, component->role());
-      try {
-        component->Add(std::move(sub));
-      } catch (ValidityError& err) {
-        err << boost::errinfo_at_line(node.line());
-        throw;
-      }
     }
   }
 }
 
-void Initializer::ProcessModelData(const xml::Element& model_data) {
-  for (const xml::Element& node : model_data.children()) {
+void Initializer::ProcessModelData(xml::Reader* reader) {
+  while (reader->NextChild()) {
+    xml::Element node = ExpandUnit(reader);
     if (node.name() == "define-basic-event") {
       Register<BasicEvent>(node, "", RoleSpecifier::kPublic);
     } else if (node.name() == "define-parameter") {
@@ -1217,7 +1462,7 @@ Expression* Initializer::GetExpression(const xml::Element& expr_element,
     Expression* expression = register_expression(kExpressionExtractors_.at(
         expr_type)(expr_element.children(), base_path, this));
     // Register for late validation after ensuring no cycles.
-    expressions_.emplace_back(expression, expr_element);
+    expressions_.emplace_back(expression, xml_file_, expr_element.line());
     return expression;
   } catch (ValidityError& err) {
     err << boost::errinfo_at_line(expr_element.line());
@@ -1800,12 +2045,12 @@ void Initializer::ValidateExpressions() {
   cycle::CheckCycle<Parameter>(model_->table<Parameter>(), "parameter");
 
   // Validate expressions.
-  for (const std::pair<Expression*, xml::Element>& expression : expressions_) {
+  for (const auto& [expression, xml_file, line] : expressions_) {
     try {
-      expression.first->Validate();
+      expression->Validate();
     } catch (ValidityError& err) {
-      err << boost::errinfo_file_name(expression.second.filename())
-          << boost::errinfo_at_line(expression.second.line());
+      err << boost::errinfo_file_name(*xml_file)
+          << boost::errinfo_at_line(line);
       throw;
     }
   }
@@ -22,8 +22,10 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <variant>
@@ -44,6 +46,7 @@
 #include "fault_tree.h"
 #include "instruction.h"
 #include "model.h"
+#include "model_cache.h"
 #include "parameter.h"
 #include "settings.h"
 #include "substitution.h"
@@ -68,6 +71,8 @@ class Initializer : private boost::noncopyable {
   /// @param[in] allow_extern  Allow external libraries in the input.
   /// @param[in] extra_validator  Additional XML validator to be run
   ///                             after the MEF validator.
+  /// @param[in] model_cache  The optional directory of model snapshots
+  ///                         to skip the processing of unchanged inputs.
   ///
   /// @throws IOError  Input contains duplicate files.
   /// @throws IOError  One of the input files is not accessible.
@@ -80,7 +85,8 @@ class Initializer : private boost::noncopyable {
   ///          Enable this feature for trusted input files and libraries only.
   Initializer(const std::vector<std::string>& xml_files,
               core::Settings settings, bool allow_extern = false,
-              xml::Validator* extra_validator = nullptr);
+              xml::Validator* extra_validator = nullptr,
+              const std::string& model_cache = "");
 
   /// @returns The model built from the input files.
   std::unique_ptr<Model> model() && { return std::move(model_); }
@@ -91,10 +97,21 @@ class Initializer : private boost::noncopyable {
       const xml::Element::Range&, const std::string&, Initializer*);
   /// Map of expression names and their extractor functions.
   using ExtractorMap = std::unordered_map<std::string_view, ExtractorFunction>;
+  /// The location of a late defined construct in the input files.
+  /// The XML element is located again by re-streaming the input files
+  /// instead of keeping the whole document tree in memory.
+  struct TbdLocation {
+    /// The sequence number of the top-level definition (unit)
+    /// in the order of streaming all the input files.
+    int unit;
+    /// The pre-order index of the XML element in the unit subtree
+    /// (0 for the unit element itself).
+    int node;
+  };
   /// Container for late defined constructs.
   template <class... Ts>
   using TbdContainer =
-      std::vector<std::pair<std::variant<Ts*...>, xml::Element>>;
+      std::vector<std::pair<std::variant<Ts*...>, TbdLocation>>;
   /// Container with full paths to elements.
   ///
   /// @tparam T  The element type.
@@ -157,27 +174,71 @@ class Initializer : private boost::noncopyable {
   /// @throws IOError  Input contains duplicate files.
   void ProcessInputFiles(const std::vector<std::string>& xml_files);
 
-  /// Reads one input XML file document with the structure of analysis entities.
+  /// Validates the input files against the MEF schema
+  /// (and the optional extra schema) concurrently.
+  ///
+  /// @param[in] xml_files  The XML input files.
+  ///
+  /// @throws xml::Error  The xml files are erroneous or malformed.
+  /// @throws xml::ValidityError The xml files do not pass validation.
+  ///
+  /// @note The error of the earliest failing file is reported
+  ///       regardless of the completion order of the validations.
+  void ValidateInputFiles(const std::vector<std::string>& xml_files);
+
+  /// Stores the snapshot of the valid model into the cache.
+  /// Failures to store are reported as warnings only.
+  ///
+  /// @param[in] cache  The model cache of the input files.
+  void StoreModel(const ModelCache& cache);
+
+  /// Streams one input XML file with the structure of analysis entities.
   /// Initializes the analysis from the given document.
   /// Puts all events into their appropriate containers.
   /// This function mostly registers element definitions,
   /// but it may leave them to be defined later
   /// because of possible undefined dependencies of those elements.
   ///
-  /// @param[in] document  The XML DOM document from a model input file.
+  /// @param[in,out] reader  The reader at the start of a valid model file.
   ///
   /// @pre The document has not been passed before.
   ///
   /// @throws ValidityError  The input model contains errors.
   /// @throws IllegalOperation  Loading external libraries is disallowed.
-  void ProcessInputFile(const xml::Document& document);
+  void ProcessInputFile(xml::Reader* reader);
 
   /// Processes definitions of elements
   /// that are left to be determined later.
   /// This late definition happens primarily due to unregistered dependencies.
   ///
+  /// The input files are streamed again
+  /// to expand only the definitions with the late defined elements.
+  ///
+  /// @param[in] xml_files  The registered input files in the same order.
+  ///
+  /// @throws ValidityError  The elements contain undefined dependencies.
+  void ProcessTbdElements(const std::vector<std::string>& xml_files);
+
+  /// Defines the late elements in the streamed definition units.
+  ///
+  /// @param[in,out] reader  The reader with the current parent container.
+  /// @param[in,out] next  The index of the next late element to be defined.
+  ///
   /// @throws ValidityError  The elements contain undefined dependencies.
-  void ProcessTbdElements();
+  void DefineTbdElements(xml::Reader* reader, std::size_t* next);
+
+  /// Reads the whole subtree of the definition unit
+  /// and makes it the current unit for element locations.
+  ///
+  /// @param[in,out] reader  The reader at the start of the unit element.
+  ///
+  /// @returns The expanded XML element of the unit.
+  xml::Element ExpandUnit(xml::Reader* reader);
+
+  /// @param[in] xml_node  The XML element within the current unit.
+  ///
+  /// @returns The location to find the XML element after streaming.
+  TbdLocation Locate(const xml::Element& xml_node);
 
   /// Registers an element into the model.
   ///
@@ -228,15 +289,17 @@ class Initializer : private boost::noncopyable {
   /// Defines a fault tree for the analysis.
   ///
   /// @param[in] ft_node  XML element defining the fault tree.
+  /// @param[in,out] reader  The reader entered into the fault tree element.
   ///
   /// @throws ValidityError  There are issues with registering and defining
   ///                        the fault tree and its data
   ///                        like gates and events.
-  void DefineFaultTree(const xml::Element& ft_node);
+  void DefineFaultTree(const xml::Element& ft_node, xml::Reader* reader);
 
   /// Defines a component container.
   ///
   /// @param[in] component_node  XML element defining the component.
+  /// @param[in,out] reader  The reader entered into the component element.
   /// @param[in] base_path  Series of ancestor containers in the path with dots.
   /// @param[in] container_role  The parent container's role.
   ///
@@ -246,27 +309,27 @@ class Initializer : private boost::noncopyable {
   ///                        the component and its data
   ///                        like gates and events.
   std::unique_ptr<Component> DefineComponent(const xml::Element& component_node,
+                                             xml::Reader* reader,
                                              const std::string& base_path,
                                              RoleSpecifier container_role);
 
   /// Registers fault tree and component data
   /// like gates, events, parameters.
   ///
-  /// @param[in] ft_node  XML element defining the fault tree or component.
+  /// @param[in,out] reader  The reader entered into the container.
   /// @param[in] base_path  Series of ancestor containers in the path with dots.
   /// @param[in,out] component  The component or fault tree container
   ///                          that is the owner of the data.
   ///
   /// @throws ValidityError  There are issues with registering and defining
   ///                        the component's data like gates and events.
-  void RegisterFaultTreeData(const xml::Element& ft_node,
-                             const std::string& base_path,
+  void RegisterFaultTreeData(xml::Reader* reader, const std::string& base_path,
                              Component* component);
 
   /// Processes model data with definitions of events and analysis.
   ///
-  /// @param[in] model_data  XML node with model data description.
-  void ProcessModelData(const xml::Element& model_data);
+  /// @param[in,out] reader  The reader entered into the model data element.
+  void ProcessModelData(xml::Reader* reader);
 
   /// Creates a Boolean formula from the XML elements
   /// describing the formula with events and other nested formulas.
@@ -494,9 +557,12 @@ class Initializer : private boost::noncopyable {
   core::Settings settings_;  ///< Settings for analysis.
   bool allow_extern_;  ///< Allow processing MEF 'extern-library'.
   xml::Validator* extra_validator_;  ///< The optional extra XML validation.
+  std::string model_cache_;  ///< The optional model snapshot directory.
 
-  /// Saved XML documents to keep elements alive.
-  std::vector<xml::Document> documents_;
+  const std::string* xml_file_ = nullptr;  ///< The currently streamed file.
+  int num_units_ = 0;  ///< The number of streamed definition units.
+  std::optional<xml::Element> unit_;  ///< The current definition unit.
+  bool has_extern_functions_ = false;  ///< Indicator for the extra pass.
 
   /// Collection of elements that are defined late
   /// because of unordered registration and definition of their dependencies.
@@ -516,7 +582,8 @@ class Initializer : private boost::noncopyable {
       tbd_;
 
   /// Container of defined expressions for later validation due to cycles.
-  std::vector<std::pair<Expression*, xml::Element>> expressions_;
+  /// The expressions are saved with their files and lines.
+  std::vector<std::tuple<Expression*, const std::string*, int>> expressions_;
   /// Container for event tree links to check for cycles.
   std::vector<Link*> links_;
 
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// A minimal writer of JSON documents.
+
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+#include <charconv>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace scram {
+
+/// Writer of compact JSON documents.
+/// Members of objects and arrays are separated automatically.
+class JsonWriter {
+ public:
+  /// @param[out] out  The destination stream.
+  explicit JsonWriter(std::FILE* out) : out_(out) {}
+
+  /// Starts a nested object or array.
+  ///
+  /// @param[in] key  The member name in the enclosing object.
+  /// @{
+  JsonWriter& BeginObject(std::string_view key = {}) {
+    return Begin(key, '{');
+  }
+  JsonWriter& BeginArray(std::string_view key = {}) { return Begin(key, '['); }
+  /// @}
+
+  /// Closes the current object or array.
+  JsonWriter& End() {
+    assert(!closers_.empty() && "Unbalanced JSON document.");
+    std::fputc(closers_.back(), out_);
+    closers_.pop_back();
+    first_ = false;
+    return *this;
+  }
+
+  /// Writes a member of the current object.
+  ///
+  /// @param[in] key  The member name.
+  /// @param[in] value  The string or number value.
+  /// @{
+  JsonWriter& Put(std::string_view key, std::string_view value) {
+    Key(key);
+    String(value);
+    return *this;
+  }
+  JsonWriter& Put(std::string_view key, double value) {
+    Key(key);
+    if (!std::isfinite(value)) {
+      std::fputs("null", out_);
+      return *this;
+    }
+    char buffer[32];
+    auto [last, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    assert(ec == std::errc() && "Insufficient space for the number.");
+    (void)ec;
+    std::fwrite(buffer, 1, last - buffer, out_);
+    return *this;
+  }
+  /// @}
+
+ private:
+  /// Starts a nested container.
+  JsonWriter& Begin(std::string_view key, char opener) {
+    Key(key);
+    std::fputc(opener, out_);
+    closers_.push_back(opener == '{' ? '}' : ']');
+    first_ = true;
+    return *this;
+  }
+
+  /// Separates the value from the previous one and writes its name if any.
+  void Key(std::string_view key) {
+    if (!first_)
+      std::fputc(',', out_);
+    first_ = false;
+    if (!key.empty()) {
+      String(key);
+      std::fputc(':', out_);
+    }
+  }
+
+  /// Writes an escaped string.
+  void String(std::string_view value) {
+    std::fputc('"', out_);
+    for (char symbol : value) {
+      if (symbol == '"' || symbol == '\\') {
+        std::fputc('\\', out_);
+        std::fputc(symbol, out_);
+      } else if (static_cast<unsigned char>(symbol) < 0x20) {
+        std::fprintf(out_, "\\u%04x", symbol);
+      } else {
+        std::fputc(symbol, out_);
+      }
+    }
+    std::fputc('"', out_);
+  }
+
+  std::FILE* out_;  ///< The destination stream.
+  std::vector<char> closers_;  ///< The closing symbols of open containers.
+  bool first_ = true;  ///< No members in the current container yet.
+};
+
+}  // namespace scram
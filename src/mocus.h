@@ -61,6 +61,14 @@ class Mocus : private boost::noncopyable {
     return *zbdd_;
   }
 
+  /// Appends the size and table statistics of the resulting ZBDD.
+  ///
+  /// @param[in,out] metrics  The collection of analysis metrics.
+  void GatherMetrics(std::vector<Metric>* metrics) noexcept {
+    assert(zbdd_ && "Analysis is not done.");
+    zbdd_->GatherMetrics(metrics);
+  }
+
  private:
   /// Runs analysis on a module gate.
   /// All sub-modules are analyzed and joined recursively.
@@ -109,6 +109,12 @@ class Model
   auto extern_functions() const { return table<ExternFunction<void>>(); }
   /// @}
 
+  /// @returns The anonymous expressions owned by the model
+  ///          in the order of their registration.
+  const std::vector<std::unique_ptr<Expression>>& expressions() const {
+    return expressions_;
+  }
+
   using Composite::Add;
   using Composite::Remove;
 
@@ -0,0 +1,821 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the binary model cache.
+///
+/// The snapshot is a flat sequence of records in the host byte order:
+/// the header, the model, elements without their references,
+/// the model expressions in the order of registration
+/// (arguments always precede their users),
+/// then the references of the elements (expressions and formulas),
+/// CCF groups, and fault trees with their components.
+/// Elements are referenced by their indices in the snapshot.
+
+#include "model_cache.h"
+
+#include <cerrno>
+#include <cstdio>
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include <boost/exception/errinfo_errno.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+#include <boost/exception/errinfo_file_open_mode.hpp>
+
+#include "ccf_group.h"
+#include "error.h"
+#include "expression/boolean.h"
+#include "expression/conditional.h"
+#include "expression/constant.h"
+#include "expression/exponential.h"
+#include "expression/numerical.h"
+#include "expression/random_deviate.h"
+#include "fault_tree.h"
+#include "logger.h"
+#include "snapshot.h"
+#include "version.h"
+
+namespace scram::mef {
+
+namespace {  // The snapshot format facilities.
+
+const std::string_view kMagic = "SCRAMMDL";  ///< The snapshot format.
+const std::uint32_t kVersion = 1;  ///< Bump on any format change.
+
+/// The kinds of references to expressions.
+enum ExpressionRef : std::uint8_t {
+  kModelExpression = 0,
+  kParameterRef,
+  kMissionTimeRef,
+  kOneRef,
+  kZeroRef,
+  kPiRef
+};
+
+/// The kinds of formula argument events.
+enum EventRef : std::uint8_t {
+  kGateRef = 0,
+  kBasicRef,
+  kHouseRef,
+  kTrueRef,
+  kFalseRef
+};
+
+/// The CCF group models.
+enum CcfModel : std::uint8_t {
+  kBetaFactor = 0,
+  kMgl,
+  kAlphaFactor,
+  kPhiFactor
+};
+
+const std::uint8_t kConstantTag = UINT8_MAX;  ///< The tag of constants.
+
+/// The namespace marker of XInclude directives in input files.
+const std::string_view kXInclude = "XInclude";
+
+/// Convenience alias to expand argument packs of expressions.
+template <std::size_t>
+using ExpressionArg = Expression*;
+
+/// @returns true if the expression is constructible from N arguments.
+template <class T, std::size_t... Is>
+constexpr bool IsConstructible(std::index_sequence<Is...>) {
+  return std::is_constructible_v<T, ExpressionArg<Is>...>;
+}
+
+/// Constructs the expression from the fixed number of arguments.
+template <class T, std::size_t... Is>
+std::unique_ptr<Expression> Construct(const std::vector<Expression*>& args,
+                                      std::index_sequence<Is...>) {
+  return std::make_unique<T>(args[Is]...);
+}
+
+/// Constructs the expression from its arguments
+/// in the order of Expression::args().
+///
+/// @tparam T  The expression type.
+/// @tparam N  The number of arguments to try for fixed-arity constructors.
+///
+/// @throws LogicError  No constructor accepts the number of arguments.
+template <class T, std::size_t N = 1>
+std::unique_ptr<Expression> Make(std::vector<Expression*> args) {
+  if constexpr (std::is_constructible_v<T, std::vector<Expression*>>) {
+    return std::make_unique<T>(std::move(args));
+  } else if constexpr (N > 11) {
+    SCRAM_THROW(LogicError("Invalid number of expression arguments."));
+  } else {
+    if constexpr (IsConstructible<T>(std::make_index_sequence<N>())) {
+      if (args.size() == N)
+        return Construct<T>(args, std::make_index_sequence<N>());
+    }
+    return Make<T, N + 1>(std::move(args));
+  }
+}
+
+/// Histograms keep boundaries and then weights.
+template <>
+std::unique_ptr<Expression> Make<Histogram>(std::vector<Expression*> args) {
+  if (args.size() < 3 || args.size() % 2 == 0)
+    SCRAM_THROW(LogicError("Invalid number of histogram arguments."));
+  auto it_weights = std::next(args.begin(), (args.size() + 1) / 2);
+  return std::make_unique<Histogram>(
+      std::vector<Expression*>(args.begin(), it_weights),
+      std::vector<Expression*>(it_weights, args.end()));
+}
+
+/// Switch keeps the default value and then the condition-value pairs.
+template <>
+std::unique_ptr<Expression> Make<Switch>(std::vector<Expression*> args) {
+  if (args.size() % 2 == 0)
+    SCRAM_THROW(LogicError("Invalid number of switch arguments."));
+  std::vector<Switch::Case> cases;
+  for (auto it = std::next(args.begin()); it != args.end(); it += 2)
+    cases.push_back({**it, **std::next(it)});
+  return std::make_unique<Switch>(std::move(cases), args.front());
+}
+
+/// The type information of cacheable expressions.
+struct ExpressionType {
+  std::type_index type;  ///< The run-time type for serialization.
+  std::unique_ptr<Expression> (*make)(std::vector<Expression*>);  ///< Loader.
+};
+
+/// @returns The type information for the expression type.
+template <class T>
+ExpressionType Register() {
+  return {typeid(T), &Make<T>};
+}
+
+/// The expression types with their snapshot tags as indices.
+const ExpressionType kExpressionTypes[] = {
+    Register<Exponential>(),      Register<Glm>(),
+    Register<Weibull>(),          Register<PeriodicTest>(),
+    Register<UniformDeviate>(),   Register<NormalDeviate>(),
+    Register<LognormalDeviate>(), Register<GammaDeviate>(),
+    Register<BetaDeviate>(),      Register<Histogram>(),
+    Register<Neg>(),              Register<Add>(),
+    Register<Sub>(),              Register<Mul>(),
+    Register<Div>(),              Register<Abs>(),
+    Register<Acos>(),             Register<Asin>(),
+    Register<Atan>(),             Register<Cos>(),
+    Register<Sin>(),              Register<Tan>(),
+    Register<Cosh>(),             Register<Sinh>(),
+    Register<Tanh>(),             Register<Exp>(),
+    Register<Log>(),              Register<Log10>(),
+    Register<Mod>(),              Register<Pow>(),
+    Register<Sqrt>(),             Register<Ceil>(),
+    Register<Floor>(),            Register<Min>(),
+    Register<Max>(),              Register<Mean>(),
+    Register<Not>(),              Register<And>(),
+    Register<Or>(),               Register<Eq>(),
+    Register<Df>(),               Register<Lt>(),
+    Register<Gt>(),               Register<Leq>(),
+    Register<Geq>(),              Register<Ite>(),
+    Register<Switch>()};
+
+const std::size_t kNumExpressionTypes = std::size(kExpressionTypes);
+
+/// Appends model records into the snapshot buffer.
+class ModelSnapshotWriter : public SnapshotWriter {
+ public:
+  /// Writes the label and attributes of the element.
+  void PutElement(const Element& element) {
+    PutString(element.label());
+    Put<std::uint32_t>(element.attributes().size());
+    for (const Attribute& attribute : element.attributes()) {
+      PutString(attribute.name());
+      PutString(attribute.value());
+      PutString(attribute.type());
+    }
+  }
+
+  /// Writes the identification of the element with its role.
+  template <class T>
+  void PutId(const T& element) {
+    PutString(element.name());
+    PutString(element.base_path());
+    Put(element.role());
+    PutElement(element);
+  }
+};
+
+/// Consumes model records from the snapshot data with bounds checking.
+class ModelSnapshotReader : public SnapshotReader {
+ public:
+  using SnapshotReader::SnapshotReader;
+
+  /// Reads the label and attributes of the element.
+  void GetElement(Element* element) {
+    element->label(GetString());
+    for (std::uint32_t i = 0, num_attributes = GetCount(); i < num_attributes;
+         ++i) {
+      std::string name = GetString();
+      std::string value = GetString();
+      element->AddAttribute({std::move(name), std::move(value), GetString()});
+    }
+  }
+
+  /// Reads the identification of the element with its role.
+  ///
+  /// @tparam T  The element type constructible from the identification.
+  template <class T>
+  std::unique_ptr<T> GetId() {
+    std::string name = GetString();
+    std::string base_path = GetString();
+    auto role = Get<RoleSpecifier>();
+    if (role != RoleSpecifier::kPublic && role != RoleSpecifier::kPrivate)
+      SCRAM_THROW(IOError("Invalid role in the model snapshot."));
+    auto element =
+        std::make_unique<T>(std::move(name), std::move(base_path), role);
+    GetElement(element.get());
+    return element;
+  }
+};
+
+/// Unsupported model constructs stop the snapshot writing.
+struct Unsupported {};
+
+/// Assigns snapshot indices to elements in the order of writing.
+template <class T>
+class Index {
+ public:
+  /// @returns The elements in the order of the indices.
+  const std::vector<const T*>& elements() const { return elements_; }
+
+  /// Appends the element with the next index.
+  void Add(const T& element) {
+    index_.emplace(&element, elements_.size());
+    elements_.push_back(&element);
+  }
+
+  /// @returns The index of the element.
+  ///
+  /// @throws Unsupported  The element is not indexed.
+  std::uint32_t operator[](const T* element) const {
+    auto it = index_.find(element);
+    if (it == index_.end())
+      throw Unsupported();
+    return it->second;
+  }
+
+ private:
+  std::vector<const T*> elements_;  ///< Indexed elements.
+  std::unordered_map<const T*, std::uint32_t> index_;  ///< Element indices.
+};
+
+/// Writes the complete snapshot of the model.
+class ModelWriter {
+ public:
+  /// @param[in] model  The valid fault tree model.
+  /// @param[in,out] out  The snapshot destination.
+  ModelWriter(const Model& model, ModelSnapshotWriter* out)
+      : model_(model), out_(*out) {}
+
+  /// Writes the model.
+  ///
+  /// @throws Unsupported  The model has constructs not supported in snapshots.
+  void operator()() {
+    out_.PutString(model_.GetOptionalName());
+    out_.PutElement(model_);
+
+    PutIds(model_.parameters(), &parameters_);
+    for (const Parameter& parameter : model_.parameters())
+      out_.Put(parameter.unit());
+    PutIds(model_.house_events(), &house_events_);
+    for (const HouseEvent& house_event : model_.house_events())
+      out_.Put<std::uint8_t>(house_event.state());
+    PutIds(model_.basic_events(), &basic_events_);
+    PutIds(model_.gates(), &gates_);
+
+    PutUsage(parameters_);
+    PutUsage(house_events_);
+    PutUsage(basic_events_);
+    PutUsage(gates_);
+
+    out_.Put<std::uint32_t>(model_.expressions().size());
+    for (const std::unique_ptr<Expression>& expression : model_.expressions())
+      PutExpression(expression.get());
+
+    for (const Parameter* parameter : parameters_.elements())
+      PutRef(parameter->args().front());
+
+    for (const BasicEvent* basic_event : basic_events_.elements()) {
+      out_.Put<std::uint8_t>(basic_event->HasExpression());
+      if (basic_event->HasExpression())
+        PutRef(&basic_event->expression());
+    }
+
+    for (const Gate* gate : gates_.elements())
+      PutFormula(gate->formula());
+
+    out_.Put<std::uint32_t>(model_.ccf_groups().size());
+    for (const CcfGroup& ccf_group : model_.ccf_groups())
+      PutCcfGroup(ccf_group);
+
+    out_.Put<std::uint32_t>(model_.fault_trees().size());
+    for (const FaultTree& fault_tree : model_.fault_trees()) {
+      out_.PutString(fault_tree.name());
+      out_.PutElement(fault_tree);
+      PutComponent(fault_tree);
+    }
+  }
+
+ private:
+  /// Writes and indexes the identifications of the elements.
+  template <class Range, class T>
+  void PutIds(const Range& elements, Index<T>* index) {
+    out_.Put<std::uint32_t>(elements.size());
+    for (const T& element : elements) {
+      out_.PutId(element);
+      index->Add(element);
+    }
+  }
+
+  /// Writes the usage flags of the indexed elements.
+  template <class T>
+  void PutUsage(const Index<T>& index) {
+    for (const T* element : index.elements())
+      out_.Put<std::uint8_t>(element->usage());
+  }
+
+  /// Writes the reference to the expression.
+  void PutRef(const Expression* expression) {
+    if (expression == &ConstantExpression::kOne) {
+      out_.Put(kOneRef);
+    } else if (expression == &ConstantExpression::kZero) {
+      out_.Put(kZeroRef);
+    } else if (expression == &ConstantExpression::kPi) {
+      out_.Put(kPiRef);
+    } else if (expression == &model_.mission_time()) {
+      out_.Put(kMissionTimeRef);
+    } else if (auto* parameter = dynamic_cast<const Parameter*>(expression)) {
+      out_.Put(kParameterRef);
+      out_.Put(parameters_[parameter]);
+    } else {
+      out_.Put(kModelExpression);
+      out_.Put(expressions_[expression]);
+    }
+  }
+
+  /// Writes the model expression with references to its arguments.
+  void PutExpression(Expression* expression) {
+    const std::type_info& type = typeid(*expression);
+    if (type == typeid(ConstantExpression)) {
+      out_.Put(kConstantTag);
+      out_.Put(expression->value());
+    } else {
+      std::uint8_t tag = 0;
+      while (tag < kNumExpressionTypes && kExpressionTypes[tag].type != type)
+        ++tag;
+      if (tag == kNumExpressionTypes)
+        throw Unsupported();  // Extern functions or test-events.
+      out_.Put(tag);
+      out_.Put<std::uint32_t>(expression->args().size());
+      for (const Expression* arg : expression->args())
+        PutRef(arg);  // Only preceding expressions are indexed.
+    }
+    expressions_.Add(*expression);
+  }
+
+  /// Writes the gate formula with references to its argument events.
+  void PutFormula(const Formula& formula) {
+    out_.Put(formula.connective());
+    out_.Put<std::int32_t>(formula.min_number().value_or(-1));
+    out_.Put<std::int32_t>(formula.max_number().value_or(-1));
+    out_.Put<std::uint32_t>(formula.args().size());
+    for (const Formula::Arg& arg : formula.args()) {
+      out_.Put<std::uint8_t>(arg.complement);
+      if (auto* gate = std::get_if<Gate*>(&arg.event)) {
+        out_.Put(kGateRef);
+        out_.Put(gates_[*gate]);
+      } else if (auto* basic_event = std::get_if<BasicEvent*>(&arg.event)) {
+        out_.Put(kBasicRef);
+        out_.Put(basic_events_[*basic_event]);
+      } else {
+        const HouseEvent* house_event = std::get<HouseEvent*>(arg.event);
+        if (house_event == &HouseEvent::kTrue) {
+          out_.Put(kTrueRef);
+        } else if (house_event == &HouseEvent::kFalse) {
+          out_.Put(kFalseRef);
+        } else {
+          out_.Put(kHouseRef);
+          out_.Put(house_events_[house_event]);
+        }
+      }
+    }
+  }
+
+  /// Writes the CCF group with its members and factors.
+  void PutCcfGroup(const CcfGroup& ccf_group) {
+    if (dynamic_cast<const BetaFactorModel*>(&ccf_group)) {
+      out_.Put(kBetaFactor);
+    } else if (dynamic_cast<const MglModel*>(&ccf_group)) {
+      out_.Put(kMgl);
+    } else if (dynamic_cast<const AlphaFactorModel*>(&ccf_group)) {
+      out_.Put(kAlphaFactor);
+    } else if (dynamic_cast<const PhiFactorModel*>(&ccf_group)) {
+      out_.Put(kPhiFactor);
+    } else {
+      throw Unsupported();
+    }
+    out_.PutId(ccf_group);
+    out_.Put<std::uint32_t>(ccf_group.members().size());
+    for (const BasicEvent* member : ccf_group.members()) {
+      out_.Put(basic_events_[member]);
+      ccf_members_.insert(member);
+    }
+    PutRef(ccf_group.distribution());
+    std::uint32_t num_factors = 0;
+    for (const auto& factor : ccf_group.factors())
+      num_factors += factor.second != nullptr;
+    out_.Put(num_factors);
+    for (const auto& [level, factor] : ccf_group.factors()) {
+      if (!factor)
+        continue;
+      out_.Put<std::int32_t>(level);
+      PutRef(factor);
+    }
+    ccf_groups_.Add(ccf_group);
+  }
+
+  /// Writes the references to the elements of the component
+  /// and its sub-components.
+  void PutComponent(const Component& component) {
+    auto put_indices = [this](const auto& elements, const auto& index) {
+      out_.Put<std::uint32_t>(elements.size());
+      for (const auto& element : elements)
+        out_.Put(index[&element]);
+    };
+    put_indices(component.gates(), gates_);
+    put_indices(component.house_events(), house_events_);
+    put_indices(component.parameters(), parameters_);
+    put_indices(component.ccf_groups(), ccf_groups_);
+    // The CCF group members are added to components with their groups.
+    std::vector<std::uint32_t> basic_events;
+    for (const BasicEvent& basic_event : component.basic_events()) {
+      if (!ccf_members_.count(&basic_event))
+        basic_events.push_back(basic_events_[&basic_event]);
+    }
+    out_.Put<std::uint32_t>(basic_events.size());
+    for (std::uint32_t index : basic_events)
+      out_.Put(index);
+
+    out_.Put<std::uint32_t>(component.components().size());
+    for (const Component& sub_component : component.components()) {
+      out_.PutId(sub_component);
+      PutComponent(sub_component);
+    }
+  }
+
+  const Model& model_;  ///< The model to write.
+  ModelSnapshotWriter& out_;  ///< The snapshot destination.
+  Index<Parameter> parameters_;  ///< Parameter indices.
+  Index<HouseEvent> house_events_;  ///< House event indices.
+  Index<BasicEvent> basic_events_;  ///< Basic event indices.
+  Index<Gate> gates_;  ///< Gate indices.
+  Index<CcfGroup> ccf_groups_;  ///< CCF group indices.
+  Index<Expression> expressions_;  ///< Model expression indices.
+  std::unordered_set<const BasicEvent*> ccf_members_;  ///< All CCF members.
+};
+
+/// Reads the complete model from the snapshot.
+class ModelReader {
+ public:
+  /// @param[in,out] in  The snapshot source after the header.
+  explicit ModelReader(ModelSnapshotReader* in) : in_(*in) {}
+
+  /// @returns The model ready for the analysis setup.
+  ///
+  /// @throws IOError  The snapshot is corrupt.
+  /// @throws Error  The snapshot contains an invalid model.
+  std::unique_ptr<Model> operator()() {
+    model_ = std::make_unique<Model>(in_.GetString());
+    in_.GetElement(model_.get());
+
+    GetIds(&parameters_);
+    for (Parameter* parameter : parameters_) {
+      auto unit = in_.Get<Units>();
+      if (unit >= kNumUnits)
+        SCRAM_THROW(IOError("Invalid unit in the model snapshot."));
+      parameter->unit(unit);
+    }
+    GetIds(&house_events_);
+    for (HouseEvent* house_event : house_events_)
+      house_event->state(in_.Get<std::uint8_t>());
+    GetIds(&basic_events_);
+    GetIds(&gates_);
+
+    // The usage is assigned at the end
+    // because the formula construction marks its arguments as used.
+    std::vector<std::uint8_t> usage;
+    for (std::size_t i = 0, num_elements = parameters_.size() +
+                                           house_events_.size() +
+                                           basic_events_.size() + gates_.size();
+         i < num_elements; ++i) {
+      usage.push_back(in_.Get<std::uint8_t>());
+    }
+
+    for (std::uint32_t i = 0, num_expressions = in_.GetCount();
+         i < num_expressions; ++i) {
+      GetExpression();
+    }
+
+    for (Parameter* parameter : parameters_)
+      parameter->expression(GetRef());
+
+    for (BasicEvent* basic_event : basic_events_) {
+      if (in_.Get<std::uint8_t>())
+        basic_event->expression(GetRef());
+    }
+
+    for (Gate* gate : gates_)
+      gate->formula(GetFormula());
+
+    auto it_usage = usage.begin();
+    auto set_usage = [&it_usage](const auto& elements) {
+      for (auto* element : elements)
+        element->usage(*it_usage++);
+    };
+    set_usage(parameters_);
+    set_usage(house_events_);
+    set_usage(basic_events_);
+    set_usage(gates_);
+
+    for (std::uint32_t i = 0, num_groups = in_.GetCount(); i < num_groups; ++i)
+      GetCcfGroup();
+
+    for (std::uint32_t i = 0, num_trees = in_.GetCount(); i < num_trees; ++i) {
+      auto fault_tree = std::make_unique<FaultTree>(in_.GetString());
+      in_.GetElement(fault_tree.get());
+      GetComponent(fault_tree.get());
+      model_->Add(std::move(fault_tree));
+    }
+
+    if (!in_.empty())
+      SCRAM_THROW(IOError("Trailing data in the model snapshot."));
+    return std::move(model_);
+  }
+
+ private:
+  /// Reads the identifications of the elements and adds them into the model.
+  template <class T>
+  void GetIds(std::vector<T*>* elements) {
+    for (std::uint32_t i = 0, num_elements = in_.GetCount(); i < num_elements;
+         ++i) {
+      std::unique_ptr<T> element = in_.GetId<T>();
+      elements->push_back(element.get());
+      model_->Add(std::move(element));
+    }
+  }
+
+  /// @returns The referenced expression.
+  Expression* GetRef() {
+    switch (in_.Get<ExpressionRef>()) {
+      case kModelExpression:
+        return expressions_[in_.GetIndex(expressions_.size())];
+      case kParameterRef:
+        return parameters_[in_.GetIndex(parameters_.size())];
+      case kMissionTimeRef:
+        return &model_->mission_time();
+      case kOneRef:
+        return &ConstantExpression::kOne;
+      case kZeroRef:
+        return &ConstantExpression::kZero;
+      case kPiRef:
+        return &ConstantExpression::kPi;
+    }
+    SCRAM_THROW(IOError("Invalid expression reference in the model snapshot."));
+  }
+
+  /// Reads the next model expression.
+  void GetExpression() {
+    auto tag = in_.Get<std::uint8_t>();
+    std::unique_ptr<Expression> expression;
+    if (tag == kConstantTag) {
+      expression = std::make_unique<ConstantExpression>(in_.Get<double>());
+    } else {
+      if (tag >= kNumExpressionTypes)
+        SCRAM_THROW(IOError("Invalid expression type in the model snapshot."));
+      std::vector<Expression*> args;
+      for (std::uint32_t i = 0, num_args = in_.GetCount(); i < num_args; ++i)
+        args.push_back(GetRef());
+      expression = kExpressionTypes[tag].make(std::move(args));
+    }
+    expressions_.push_back(expression.get());
+    model_->Add(std::move(expression));
+  }
+
+  /// @returns The gate formula.
+  std::unique_ptr<Formula> GetFormula() {
+    auto connective = in_.Get<Connective>();
+    if (connective >= kNumConnectives)
+      SCRAM_THROW(IOError("Invalid connective in the model snapshot."));
+    auto get_number = [this]() -> std::optional<int> {
+      auto number = in_.Get<std::int32_t>();
+      if (number < 0)
+        return {};
+      return number;
+    };
+    std::optional<int> min_number = get_number();
+    std::optional<int> max_number = get_number();
+    Formula::ArgSet args;
+    for (std::uint32_t i = 0, num_args = in_.GetCount(); i < num_args; ++i) {
+      bool complement = in_.Get<std::uint8_t>();
+      switch (in_.Get<EventRef>()) {
+        case kGateRef:
+          args.Add(gates_[in_.GetIndex(gates_.size())], complement);
+          break;
+        case kBasicRef:
+          args.Add(basic_events_[in_.GetIndex(basic_events_.size())],
+                   complement);
+          break;
+        case kHouseRef:
+          args.Add(house_events_[in_.GetIndex(house_events_.size())],
+                   complement);
+          break;
+        case kTrueRef:
+          args.Add(&HouseEvent::kTrue, complement);
+          break;
+        case kFalseRef:
+          args.Add(&HouseEvent::kFalse, complement);
+          break;
+        default:
+          SCRAM_THROW(IOError("Invalid formula argument in the snapshot."));
+      }
+    }
+    return std::make_unique<Formula>(connective, std::move(args), min_number,
+                                     max_number);
+  }
+
+  /// Reads the next CCF group.
+  void GetCcfGroup() {
+    auto ccf_group = [this]() -> std::unique_ptr<CcfGroup> {
+      switch (in_.Get<CcfModel>()) {
+        case kBetaFactor:
+          return in_.GetId<BetaFactorModel>();
+        case kMgl:
+          return in_.GetId<MglModel>();
+        case kAlphaFactor:
+          return in_.GetId<AlphaFactorModel>();
+        case kPhiFactor:
+          return in_.GetId<PhiFactorModel>();
+      }
+      SCRAM_THROW(IOError("Invalid CCF model in the model snapshot."));
+    }();
+    for (std::uint32_t i = 0, num_members = in_.GetCount(); i < num_members;
+         ++i) {
+      ccf_group->AddMember(basic_events_[in_.GetIndex(basic_events_.size())]);
+    }
+    ccf_group->AddDistribution(GetRef());
+    for (std::uint32_t i = 0, num_factors = in_.GetCount(); i < num_factors;
+         ++i) {
+      auto level = in_.Get<std::int32_t>();
+      ccf_group->AddFactor(GetRef(), level);
+    }
+    ccf_groups_.push_back(ccf_group.get());
+    model_->Add(std::move(ccf_group));
+  }
+
+  /// Reads the elements of the component and its sub-components.
+  void GetComponent(Component* component) {
+    auto get_elements = [this, component](const auto& elements) {
+      for (std::uint32_t i = 0, num_elements = in_.GetCount();
+           i < num_elements; ++i) {
+        component->Add(elements[in_.GetIndex(elements.size())]);
+      }
+    };
+    get_elements(gates_);
+    get_elements(house_events_);
+    get_elements(parameters_);
+    get_elements(ccf_groups_);
+    get_elements(basic_events_);
+
+    for (std::uint32_t i = 0, num_components = in_.GetCount();
+         i < num_components; ++i) {
+      std::unique_ptr<Component> sub_component = in_.GetId<Component>();
+      GetComponent(sub_component.get());
+      component->Add(std::move(sub_component));
+    }
+  }
+
+  ModelSnapshotReader& in_;  ///< The snapshot source.
+  std::unique_ptr<Model> model_;  ///< The model being read.
+  std::vector<Parameter*> parameters_;  ///< Indexed parameters.
+  std::vector<HouseEvent*> house_events_;  ///< Indexed house events.
+  std::vector<BasicEvent*> basic_events_;  ///< Indexed basic events.
+  std::vector<Gate*> gates_;  ///< Indexed gates.
+  std::vector<CcfGroup*> ccf_groups_;  ///< Indexed CCF groups.
+  std::vector<Expression*> expressions_;  ///< Indexed model expressions.
+};
+
+}  // namespace
+
+ModelCache::ModelCache(const std::string& directory,
+                       const std::vector<std::string>& xml_files,
+                       const core::Settings& settings) {
+  SnapshotHash hash;
+  hash.Add(kVersion);
+  hash.Add(SCRAM_VERSION);
+  hash.Add(SCRAM_GIT_REVISION);
+  hash.Add(settings.probability_analysis());
+  hash.Add(settings.mission_time());
+
+  std::vector<char> buffer(1 << 16);
+  for (const std::string& xml_file : xml_files) {
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
+        std::fopen(xml_file.c_str(), "rb"), &std::fclose);
+    if (!fp) {
+      SCRAM_THROW(IOError("Cannot open the input file for the model cache."))
+          << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode("rb")
+          << boost::errinfo_file_name(xml_file);
+    }
+    std::uint64_t file_size = 0;
+    bool has_xinclude = false;
+    std::string boundary;  // The chunk boundary for the directive search.
+    while (std::size_t num_bytes =
+               std::fread(buffer.data(), 1, buffer.size(), fp.get())) {
+      hash.Add(buffer.data(), num_bytes);
+      file_size += num_bytes;
+      std::string_view chunk(buffer.data(), num_bytes);
+      boundary += chunk.substr(0, kXInclude.size() - 1);
+      has_xinclude |= boundary.find(kXInclude) != std::string::npos ||
+                      chunk.find(kXInclude) != std::string_view::npos;
+      boundary = chunk.substr(
+          num_bytes - std::min(num_bytes, kXInclude.size() - 1));
+    }
+    if (std::ferror(fp.get())) {
+      SCRAM_THROW(IOError("Failed to read the input file for the model cache."))
+          << boost::errinfo_errno(errno) << boost::errinfo_file_name(xml_file);
+    }
+    if (has_xinclude) {
+      LOG(DEBUG2) << "The model cache is disabled for XInclude in " << xml_file;
+      return;
+    }
+    hash.Add(file_size);
+  }
+  key_ = hash.value();
+  snapshot_ = SnapshotPath(directory, key_, "scram-model");
+}
+
+std::unique_ptr<Model> ModelCache::Load() const noexcept {
+  assert(enabled());
+  std::string data = LoadSnapshot(snapshot_);
+  if (data.empty()) {
+    LOG(DEBUG2) << "No model snapshot " << snapshot_;
+    return nullptr;
+  }
+  try {
+    ModelSnapshotReader in(data);
+    in.GetHeader(kMagic, kVersion, key_);
+    return ModelReader(&in)();
+  } catch (const std::exception& err) {
+    LOG(WARNING) << "Ignoring the corrupt model cache " << snapshot_ << ": "
+                 << err.what();
+    return nullptr;
+  }
+}
+
+bool ModelCache::Store(const Model& model) const {
+  assert(enabled());
+  if (!model.initiating_events().empty() || !model.event_trees().empty() ||
+      !model.sequences().empty() || !model.rules().empty() ||
+      !model.alignments().empty() || !model.substitutions().empty() ||
+      !model.libraries().empty() || !model.extern_functions().empty()) {
+    return false;
+  }
+  ModelSnapshotWriter out;
+  PutSnapshotHeader(kMagic, kVersion, key_, &out);
+  try {
+    ModelWriter(model, &out)();
+  } catch (const Unsupported&) {
+    return false;
+  }
+  StoreSnapshot(snapshot_, out.data());
+  return true;
+}
+
+}  // namespace scram::mef
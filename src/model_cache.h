@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Persistent binary snapshots of initialized models.
+///
+/// @note Only fault tree models are cached:
+///       event trees, alignments, substitutions, extern functions,
+///       and test-event expressions are not supported.
+
+#pragma once
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "model.h"
+#include "settings.h"
+
+namespace scram::mef {
+
+/// Cache of fully initialized models
+/// to skip the parsing, validation, and definition of unchanged input files.
+///
+/// The snapshots are keyed by the contents of the input files,
+/// the SCRAM version,
+/// and the analysis settings affecting the model initialization.
+/// Any mismatch or corruption of the snapshot results in a cache miss.
+class ModelCache {
+ public:
+  /// Computes the key of the input files.
+  ///
+  /// @param[in] directory  The cache directory (created on demand).
+  /// @param[in] xml_files  The MEF XML input files.
+  /// @param[in] settings  Analysis settings for the model initialization.
+  ///
+  /// @throws IOError  The input files are not readable.
+  ///
+  /// @note Inputs with XInclude directives are not cached
+  ///       because the included files are not tracked.
+  ModelCache(const std::string& directory,
+             const std::vector<std::string>& xml_files,
+             const core::Settings& settings);
+
+  /// @returns true if the inputs can be cached.
+  bool enabled() const { return !snapshot_.empty(); }
+
+  /// @returns The snapshot file for the input files.
+  const std::string& snapshot() const { return snapshot_; }
+
+  /// Loads the model from the snapshot of the input files.
+  ///
+  /// @returns The model ready for the analysis setup,
+  ///          or nullptr if no valid snapshot is found.
+  ///
+  /// @pre The cache is enabled.
+  std::unique_ptr<Model> Load() const noexcept;
+
+  /// Stores the snapshot of the model initialized from the input files.
+  ///
+  /// @param[in] model  The valid model before the analysis setup.
+  ///
+  /// @returns false if the model contains constructs not supported in caches.
+  ///
+  /// @pre The cache is enabled.
+  ///
+  /// @throws IOError  The snapshot cannot be written into the cache directory.
+  bool Store(const Model& model) const;
+
+ private:
+  std::string snapshot_;  ///< The snapshot file path.
+  std::uint64_t key_ = 0;  ///< The unique key of the inputs.
+};
+
+}  // namespace scram::mef
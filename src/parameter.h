@@ -22,6 +22,8 @@
 
 #include <cstdint>
 
+#include <optional>
+
 #include "element.h"
 #include "expression.h"
 
@@ -103,14 +105,37 @@ class Parameter : public Expression, public Id, public NodeMark, public Usage {
   /// @param[in] unit  A valid unit.
   void unit(Units unit) { unit_ = unit; }
 
-  double value() noexcept override { return expression_->value(); }
-  Interval interval() noexcept override { return expression_->interval(); }
+  /// @returns The value overriding the expression of this parameter.
+  const std::optional<double>& override_value() const {
+    return override_value_;
+  }
+
+  /// Overrides the value of the parameter expression
+  /// for what-if calculations, e.g., sensitivity studies.
+  ///
+  /// @param[in] value  The constant value of this parameter
+  ///                   or std::nullopt to restore the expression.
+  void override_value(std::optional<double> value) { override_value_ = value; }
+
+  double value() noexcept override {
+    return override_value_ ? *override_value_ : expression_->value();
+  }
+  Interval interval() noexcept override {
+    return override_value_ ? Interval::closed(*override_value_, *override_value_)
+                           : expression_->interval();
+  }
+  bool IsDeviate() noexcept override {
+    return !override_value_ && Expression::IsDeviate();
+  }
 
  private:
-  double DoSample() noexcept override { return expression_->Sample(); }
+  double DoSample() noexcept override {
+    return override_value_ ? *override_value_ : expression_->Sample();
+  }
 
   Units unit_ = kUnitless;  ///< Units of this parameter.
   Expression* expression_ = nullptr;  ///< Expression for this parameter.
+  std::optional<double> override_value_;  ///< The what-if constant value.
 };
 
 }  // namespace scram::mef
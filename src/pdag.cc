@@ -32,6 +32,7 @@
 #include <boost/math/special_functions/sign.hpp>
 #include <boost/range/algorithm.hpp>
 
+#include "ccf_group.h"
 #include "event.h"
 #include "ext/algorithm.h"
 #include "logger.h"
@@ -40,7 +41,7 @@
 
 namespace scram::core {
 
-void NodeParentManager::AddParent(const GatePtr& gate) {
+void NodeParentManager::AddParent(Gate* gate) {
   assert(!parents_.count(gate->index()) && "Adding an existing parent.");
   parents_.data().emplace_back(gate->index(), gate);
 }
@@ -49,7 +50,6 @@ Node::Node(Pdag* graph) noexcept
     : index_(Pdag::NodeIndexGenerator()(graph)),
       order_(0),
       visits_{},
-      opti_value_(0),
       pos_count_(0),
       neg_count_(0),
       graph_(*graph) {}
@@ -59,11 +59,9 @@ Node::~Node() = default;
 Gate::Gate(Connective type, Pdag* graph) noexcept
     : Node(graph),
       type_(type),
-      mark_(false),
       module_(false),
       coherent_(false),
       min_number_(0),
-      descendant_(0),
       ancestor_(0),
       min_time_(0),
       max_time_(0) {}
@@ -89,11 +87,11 @@ GatePtr Gate::Clone() noexcept {
   clone->constant_ = constant_;
   // Introducing the new parent to the args.
   for (const auto& arg : gate_args_)
-    arg.second->AddParent(clone);
+    arg.second->AddParent(clone.get());
   for (const auto& arg : variable_args_)
-    arg.second->AddParent(clone);
+    arg.second->AddParent(clone.get());
   if (constant_)
-    constant_->AddParent(clone);
+    constant_->AddParent(clone.get());
   return clone;
 }
 
@@ -326,7 +324,7 @@ void Gate::MakeConstant(bool state) noexcept {
   constant_ = Node::graph().constant();
   int index = state ? constant_->index() : -constant_->index();
   args_.insert(index);
-  constant_->AddParent(shared_from_this());
+  constant_->AddParent(this);
 }
 
 void Gate::ProcessDuplicateArg(int index) noexcept {
@@ -483,6 +481,41 @@ Pdag::Pdag(const mef::Gate& root, bool ccf, const mef::Model* model) noexcept
   }
 }
 
+Pdag::Pdag(const std::vector<const mef::Gate*>& roots, bool ccf,
+           std::vector<GatePtr>* root_gates) noexcept
+    : Pdag() {
+  TIMER(DEBUG2, "Shared PDAG Construction");
+  ProcessedNodes nodes;
+  nodes.share_structures = true;
+  for (const mef::Gate* root : roots) {
+    if (nodes.gates.emplace(root, nullptr).second)
+      GatherVariables(root->formula(), ccf, &nodes);
+  }
+
+  root_ = std::make_shared<Gate>(kOr, this);
+  for (const mef::Gate* root : roots) {
+    GatePtr& pdag_gate = nodes.gates.find(root)->second;
+    if (!pdag_gate)
+      pdag_gate = ShareStructure(ConstructGate(root->formula(), ccf, &nodes),
+                                 &nodes);
+    if (!root_->args().count(pdag_gate->index()))
+      root_->AddArg(pdag_gate);
+    root_gates->push_back(pdag_gate);
+  }
+}
+
+GatePtr Pdag::ShareStructure(GatePtr gate, ProcessedNodes* nodes) noexcept {
+  assert(gate->parents().empty() && "Only new gates can be merged.");
+  if (!nodes->share_structures || gate->type() == kNull || gate->constant())
+    return gate;  // Pass-through gates are removed by the preprocessor.
+  std::vector<int> key = {gate->type(), gate->min_number()};
+  key.insert(key.end(), gate->args().begin(), gate->args().end());
+  GatePtr& unique_gate = nodes->structures[std::move(key)];
+  if (!unique_gate)
+    unique_gate = std::move(gate);
+  return unique_gate;
+}
+
 void Pdag::Print() {
   Clear<kVisit>();
   std::cerr << "\n" << this << std::endl;
@@ -526,8 +559,12 @@ void Pdag::GatherVariables(const mef::Formula& formula, bool ccf,
 void Pdag::GatherVariables(const mef::BasicEvent& basic_event, bool ccf,
                            ProcessedNodes* nodes) noexcept {
   if (ccf && basic_event.HasCcf()) {  // Gather CCF events.
-    if (nodes->gates.emplace(&basic_event.ccf_gate(), nullptr).second)
-      GatherVariables(basic_event.ccf_gate().formula(), ccf, nodes);
+    if (nodes->ccf_gates.emplace(&basic_event, nullptr).second) {
+      for (const mef::CcfEvent* ccf_event :
+           basic_event.ccf_group().ccf_events(basic_event)) {
+        GatherVariables(*ccf_event, ccf, nodes);
+      }
+    }
   } else {
     VariablePtr& var = nodes->variables[&basic_event];
     if (!var) {
@@ -566,7 +603,8 @@ void Pdag::AddArg(const GatePtr& parent, const T& event, bool complement,
   } else if constexpr (std::is_same_v<T, mef::Gate>) {  // NOLINT
     GatePtr& pdag_gate = nodes->gates.find(&event)->second;
     if (!pdag_gate) {
-      pdag_gate = ConstructGate(event.formula(), ccf, nodes);
+      pdag_gate =
+          ShareStructure(ConstructGate(event.formula(), ccf, nodes), nodes);
     }
     parent->AddArg(pdag_gate, complement);
 
@@ -574,7 +612,15 @@ void Pdag::AddArg(const GatePtr& parent, const T& event, bool complement,
     static_assert(std::is_same_v<T, mef::BasicEvent>);
 
     if (ccf && event.HasCcf()) {  // Replace with a CCF gate.
-      AddArg(parent, event.ccf_gate(), complement, ccf, nodes);
+      GatePtr& ccf_gate = nodes->ccf_gates.find(&event)->second;
+      if (!ccf_gate) {
+        ccf_gate = std::make_shared<Gate>(kOr, this);
+        for (const mef::CcfEvent* ccf_event :
+             event.ccf_group().ccf_events(event)) {
+          ccf_gate->AddArg(nodes->variables.find(ccf_event)->second);
+        }
+      }
+      parent->AddArg(ccf_gate, complement);
     } else {
       VariablePtr& var = nodes->variables.find(&event)->second;
       assert(var && "Uninitialized variable.");
@@ -811,11 +857,11 @@ void Pdag::RemoveNullGates() noexcept {
 void Pdag::PropagateNullGate(const GatePtr& gate) noexcept {
   assert(gate->type() == kNull);
   while (!gate->parents().empty()) {
-    GatePtr parent = gate->parents().begin()->second.lock();
+    Gate* parent = gate->parents().begin()->second;
     int sign = parent->GetArgSign(gate);
     parent->JoinNullGate(sign * gate->index());
     if (parent->type() == kNull) {
-      PropagateNullGate(parent);
+      PropagateNullGate(parent->shared_from_this());
     }
   }
 }
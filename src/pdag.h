@@ -42,6 +42,7 @@
 #include <vector>
 
 #include <boost/container/flat_set.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 
@@ -66,14 +67,19 @@ using GateWeakPtr = std::weak_ptr<Gate>;  ///< An acyclic ptr to parent gates.
 
 /// A manager of information about parents.
 /// Only gates can manipulate the data.
+///
+/// The parent links are non-owning raw pointers.
+/// A gate unregisters itself from its arguments upon destruction,
+/// and a gate with parents is kept alive by the parents;
+/// hence, the registered parent pointers never dangle.
 class NodeParentManager : private boost::noncopyable {
   friend class Gate;  ///< The main manipulator of parent information.
 
  public:
-  using Parent = std::pair<int, GateWeakPtr>;  ///< Parent index and ptr.
+  using Parent = std::pair<int, Gate*>;  ///< Parent index and ptr.
 
-  /// A map type of parent gate positive indices and weak pointers to them.
-  using ParentMap = ext::linear_map<int, GateWeakPtr, ext::MoveEraser>;
+  /// A map type of parent gate positive indices and pointers to them.
+  using ParentMap = ext::linear_map<int, Gate*, ext::MoveEraser>;
 
   /// @returns The parents of a node.
   const ParentMap& parents() const { return parents_; }
@@ -87,7 +93,7 @@ class NodeParentManager : private boost::noncopyable {
   /// @param[in] gate  Pointer to the parent gate.
   ///
   /// @pre The parent is not in the container.
-  void AddParent(const GatePtr& gate);
+  void AddParent(Gate* gate);
 
   /// Removes a parent from the node.
   ///
@@ -104,9 +110,19 @@ class NodeParentManager : private boost::noncopyable {
 
 class Pdag;  // Manager of the graph, node indices and uniqueness.
 
+/// Traversal and optimization marks of a node.
+/// The host graph keeps the marks of its nodes contiguously by node index,
+/// so hot traversals can inspect the marks of arguments and parents
+/// with their indices alone without dereferencing the nodes.
+struct NodeState {
+  int opti_value = 0;  ///< Failure propagation optimization value.
+  int descendant = 0;  ///< Gate mark by descendant indices.
+  bool mark = false;  ///< Gate marking for linear traversal of a graph.
+};
+
 /// An abstract base class that represents a node in a PDAG.
 /// The index of the node is a unique identifier for the node.
-/// The node holds weak pointers to the parents
+/// The node holds non-owning pointers to the parents
 /// that are managed by the parents.
 ///
 /// @pre A node does not outlive its PDAG.
@@ -135,12 +151,12 @@ class Node : public NodeParentManager {
   void order(int val) { order_ = val; }
 
   /// @returns Optimization value for failure propagation.
-  int opti_value() const { return opti_value_; }
+  int opti_value() const { return state().opti_value; }
 
   /// Sets the optimization value for failure propagation.
   ///
   /// @param[in] val  Value that makes sense to the caller.
-  void opti_value(int val) { opti_value_ = val; }
+  void opti_value(int val) { state().opti_value = val; }
 
   /// Registers the visit time for this node upon graph traversal.
   /// This information can be used to detect dependencies.
@@ -211,11 +227,14 @@ class Node : public NodeParentManager {
     neg_count_ = 0;
   }
 
+ protected:
+  /// @returns The marks of this node kept by the host graph.
+  NodeState& state() const;
+
  private:
   int index_;  ///< Index of this node.
   int order_;  ///< Ordering of nodes in the graph.
   int visits_[3];  ///< Traversal array with first, second, and last visits.
-  int opti_value_;  ///< Failure propagation optimization value.
   int pos_count_;  ///< The number of occurrences as a positive node.
   int neg_count_;  ///< The number of occurrences as a negative node.
   Pdag& graph_;  ///< The host graph for the node.
@@ -402,7 +421,7 @@ class Gate : public Node, public std::enable_shared_from_this<Gate> {
   /// to visit information provided by the base Node class.
   ///
   /// @returns The mark of this gate.
-  bool mark() const { return mark_; }
+  bool mark() const { return Node::state().mark; }
 
   /// Sets the mark of this gate.
   ///
@@ -410,18 +429,18 @@ class Gate : public Node, public std::enable_shared_from_this<Gate> {
   ///
   /// @pre The marks are assigned in a top-down traversal.
   /// @pre The marks are continuous.
-  void mark(bool flag) { mark_ = flag; }
+  void mark(bool flag) { Node::state().mark = flag; }
 
   /// @returns Pre-assigned index of one of gate's descendants.
-  int descendant() const { return descendant_; }
+  int descendant() const { return Node::state().descendant; }
 
   /// Assigns a descendant index of this gate.
   ///
   /// @param[in] index  Index of the descendant.
-  void descendant(int index) { descendant_ = index; }
+  void descendant(int index) { Node::state().descendant = index; }
 
   /// @returns Pre-assigned index of one of the gate's ancestors.
-  int ancestor() { return ancestor_; }
+  int ancestor() const { return ancestor_; }
 
   /// Assigns an ancestor index of this gate.
   ///
@@ -557,7 +576,7 @@ class Gate : public Node, public std::enable_shared_from_this<Gate> {
 
     args_.insert(index);
     mutable_args<T>().data().emplace_back(index, arg);
-    arg->AddParent(shared_from_this());
+    arg->AddParent(this);
   }
   /// Wrapper to add gate arguments with index retrieval from the arg.
   template <class T>
@@ -681,8 +700,6 @@ class Gate : public Node, public std::enable_shared_from_this<Gate> {
   void MakeConstant(bool state) noexcept;
 
  private:
-  using std::enable_shared_from_this<Gate>::shared_from_this;
-
   /// Mutable getter for the gate arguments.
   ///
   /// @tparam T  The type of the argument nodes.
@@ -734,11 +751,9 @@ class Gate : public Node, public std::enable_shared_from_this<Gate> {
   }
 
   Connective type_;  ///< Type of this gate.
-  bool mark_;  ///< Marking for linear traversal of a graph.
   bool module_;  ///< Indication of an independent module gate.
   bool coherent_;  ///< Indication of a coherent graph.
   int min_number_;  ///< Min number for ATLEAST gate.
-  int descendant_;  ///< Mark by descendant indices.
   int ancestor_;  ///< Mark by ancestor indices.
   int min_time_;  ///< Minimum time of visits of the sub-graph of the gate.
   int max_time_;  ///< Maximum time of visits of the sub-graph of the gate.
@@ -779,6 +794,9 @@ void Gate::AddArg<Constant>(int index, const ConstantPtr& arg) noexcept;
 ///      which is not the assumption of
 ///      all the other preprocessing and analysis algorithms.
 class Pdag : private boost::noncopyable {
+  friend class Node;  // The marks of nodes are kept by the graph.
+  friend class PdagCache;  // Restoration of preprocessed graphs.
+
  public:
   static const int kVariableStartIndex = 2;  ///< The shift value for mapping.
   /// Sequential mapping of Variable indices to other data of type T.
@@ -791,7 +809,13 @@ class Pdag : private boost::noncopyable {
     /// @returns A new unique index in the graph.
     ///
     /// @param[in,out] graph  A graph within which the index is unique.
-    int operator()(Pdag* graph) const { return ++graph->node_index_; }
+    int operator()(Pdag* graph) const {
+      int index = ++graph->node_index_;
+      if (index >= static_cast<int>(graph->states_.size()))
+        graph->states_.resize(index + 1);
+      graph->states_[index] = {};
+      return index;
+    }
   };
 
   /// Registers pass-through or Null logic gates belonging to the graph.
@@ -861,6 +885,25 @@ class Pdag : private boost::noncopyable {
   explicit Pdag(const mef::Gate& root, bool ccf = false,
                 const mef::Model* model = nullptr) noexcept;
 
+  /// Constructs a PDAG with the structure shared by multiple root gates,
+  /// for example, sequences of an event tree.
+  /// The common sub-graphs of the roots are constructed only once.
+  /// Gates of different origin but with the identical structure
+  /// (connective and arguments after the conversion) are merged
+  /// so that the same sub-systems modeled separately are shared as well.
+  /// The root of the graph is an OR gate over the root gates.
+  ///
+  /// @param[in] roots  The root gates to share the graph.
+  /// @param[in] ccf  Incorporation of CCF gates and events for CCF groups.
+  /// @param[out] root_gates  The PDAG gates of the roots in the given order.
+  ///
+  /// @pre No new Variable nodes are introduced after the construction.
+  ///
+  /// @post The graph is not preprocessed
+  ///       because the root gates must preserve their identity.
+  Pdag(const std::vector<const mef::Gate*>& roots, bool ccf,
+       std::vector<GatePtr>* root_gates) noexcept;
+
   /// @returns Non-declarative substitutions to be applied by analysis.
   const std::vector<Substitution>& substitutions() const {
     return substitutions_;
@@ -918,6 +961,13 @@ class Pdag : private boost::noncopyable {
   /// @returns true if the graph has at least one pass-through logic gate.
   bool HasNullGates() const { return !null_gates_.empty(); }
 
+  /// @param[in] index  Positive or negative index of a node in this graph.
+  ///
+  /// @returns The marks of the node.
+  const NodeState& state(int index) const {
+    return states_[std::abs(index)];
+  }
+
   /// @returns true if the graph represents a trivial Boolean function;
   ///               that is, graph = Constant or graph = Variable.
   ///               The only gate is the root pass-through to the simple arg.
@@ -1012,8 +1062,25 @@ class Pdag : private boost::noncopyable {
   struct ProcessedNodes {  /// @{
     std::unordered_map<const mef::Gate*, GatePtr> gates;
     std::unordered_map<const mef::BasicEvent*, VariablePtr> variables;
+    std::unordered_map<const mef::BasicEvent*, GatePtr> ccf_gates;
+    /// Unique gates by structure (the connective, min number, and arguments).
+    std::unordered_map<std::vector<int>, GatePtr,
+                       boost::hash<std::vector<int>>>
+        structures;
+    bool share_structures = false;  ///< Enables the structural merging.
   };  /// @}
 
+  /// Finds the gate constructed earlier with the same structure.
+  ///
+  /// @param[in] gate  The newly constructed gate from a fault tree gate.
+  /// @param[in,out] nodes  The registry of unique gate structures.
+  ///
+  /// @returns The unique gate with the structure of the argument gate,
+  ///          which is the argument gate itself if it is the first one.
+  ///
+  /// @pre The gate has no parents.
+  GatePtr ShareStructure(GatePtr gate, ProcessedNodes* nodes) noexcept;
+
   /// Gathers and initializes Variables from Basic Events.
   /// The gates are gathered but not initialized
   /// to give the sequential indices for the Variables
@@ -1125,6 +1192,7 @@ class Pdag : private boost::noncopyable {
   void PropagateNullGate(const GatePtr& gate) noexcept;
 
   int node_index_;  ///< Automatic index of the new node.
+  std::vector<NodeState> states_;  ///< The marks of nodes by their indices.
   bool complement_;  ///< The indication of a complement graph.
   bool coherent_;  ///< Indication that the graph does not contain negation.
   bool normal_;  ///< Indication for the graph containing only OR and AND gates.
@@ -1139,6 +1207,8 @@ class Pdag : private boost::noncopyable {
   std::vector<Substitution> substitutions_;  ///< Non-declarative substitutions.
 };
 
+inline NodeState& Node::state() const { return graph_.states_[index_]; }
+
 /// Traverses and visits gates and nodes in the graph.
 ///
 /// @tparam Mark  The "visited" gate mark.
@@ -1155,7 +1225,8 @@ void TraverseGates(const GatePtr& gate, T&& visit) noexcept {
   gate->mark(Mark);
   visit(gate);
   for (const auto& arg : gate->args<Gate>()) {
-    TraverseGates<Mark>(arg.second, visit);
+    if (gate->graph().state(arg.first).mark != Mark)
+      TraverseGates<Mark>(arg.second, visit);
   }
 }
 template <typename T>
@@ -1165,7 +1236,8 @@ void TraverseNodes(const GatePtr& gate, T&& visit) noexcept {
   gate->mark(true);
   visit(gate);
   for (const auto& arg : gate->args<Gate>()) {
-    TraverseNodes(arg.second, visit);
+    if (!gate->graph().state(arg.first).mark)
+      TraverseNodes(arg.second, visit);
   }
   for (const auto& arg : gate->args<Variable>()) {
     visit(arg.second);
@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the preprocessed PDAG cache.
+///
+/// The snapshot records the graph properties,
+/// the gates in the post-order (arguments always precede their parents)
+/// with the arguments in their original order,
+/// the root gate,
+/// the orders of the variables,
+/// and the non-declarative substitutions.
+///
+/// Variables are not stored;
+/// they are gathered from the fault tree on loading
+/// with exactly the same indices as in the original PDAG construction.
+/// Gates are restored with their original indices.
+
+#include "pdag_cache.h"
+
+#include <cassert>
+#include <cstdlib>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <boost/range/size.hpp>
+
+#include "ccf_group.h"
+#include "error.h"
+#include "logger.h"
+#include "snapshot.h"
+#include "version.h"
+
+namespace scram::core {
+
+namespace {
+
+const std::string_view kMagic = "SCRAMPDG";  ///< The snapshot format.
+const std::uint32_t kVersion = 1;  ///< Bump on any format change.
+
+/// Hashes the fault tree structure relevant to the PDAG construction.
+class StructureHash {
+ public:
+  /// @param[in] ccf  Incorporation of CCF groups.
+  explicit StructureHash(bool ccf) : ccf_(ccf) { hash_.Add(ccf); }
+
+  /// Adds the Boolean formula with its sub-graph into the hash.
+  void operator()(const mef::Formula& formula) {
+    hash_.Add(static_cast<int>(formula.connective()));
+    hash_.Add(formula.min_number().value_or(-1));
+    hash_.Add(formula.max_number().value_or(-1));
+    hash_.Add(formula.args().size());
+    for (const mef::Formula::Arg& arg : formula.args()) {
+      hash_.Add(arg.complement);
+      hash_.Add(arg.event.index());
+      std::visit(*this, arg.event);
+    }
+  }
+
+  /// Adds the formula argument events into the hash.
+  /// @{
+  void operator()(const mef::Gate* gate) {
+    hash_.Add(gate->id());
+    if (gates_.insert(gate).second)
+      (*this)(gate->formula());
+  }
+  void operator()(const mef::BasicEvent* basic_event) {
+    hash_.Add(basic_event->id());
+    if (ccf_ && basic_event->HasCcf()) {
+      for (const mef::CcfEvent* ccf_event :
+           basic_event->ccf_group().ccf_events(*basic_event)) {
+        hash_.Add(ccf_event->id());
+      }
+    }
+  }
+  void operator()(const mef::HouseEvent* house_event) {
+    hash_.Add(house_event->id());
+    hash_.Add(house_event->state());
+  }
+  /// @}
+
+  /// Adds the substitution rule into the hash.
+  void operator()(const mef::Substitution& substitution) {
+    (*this)(substitution.hypothesis());
+    hash_.Add(substitution.source().size());
+    for (const mef::BasicEvent* source : substitution.source())
+      (*this)(source);
+    hash_.Add(substitution.target().index());
+    if (auto* target = std::get_if<mef::BasicEvent*>(&substitution.target())) {
+      (*this)(*target);
+    } else {
+      hash_.Add(std::get<bool>(substitution.target()));
+    }
+  }
+
+  /// @returns The hash of the structure.
+  SnapshotHash& hash() { return hash_; }
+
+ private:
+  bool ccf_;  ///< Incorporation of CCF groups.
+  std::unordered_set<const mef::Gate*> gates_;  ///< Gates already hashed.
+  SnapshotHash hash_;  ///< The hash of the structure.
+};
+
+/// Collects gates in the post-order and variables of the graph.
+struct GraphNodes {
+  /// Visits the gate and its sub-graph only once.
+  void operator()(const Gate& gate) {
+    if (!visited.insert(gate.index()).second)
+      return;
+    for (const auto& arg : gate.args<Gate>())
+      (*this)(arg.second);
+    for (const auto& arg : gate.args<Variable>()) {
+      if (visited.insert(arg.first > 0 ? arg.first : -arg.first).second)
+        variables.push_back(&arg.second);
+    }
+    gates.push_back(&gate);
+  }
+
+  std::unordered_set<int> visited;  ///< The indices of visited nodes.
+  std::vector<const Gate*> gates;  ///< Gates in the post-order.
+  std::vector<const Variable*> variables;  ///< Variables in the graph.
+};
+
+/// Writes the signed argument indices.
+///
+/// @param[in] args  The range of the gate arguments.
+/// @param[in,out] out  The snapshot destination.
+template <class Range>
+void PutArgs(const Range& args, SnapshotWriter* out) {
+  out->Put<std::uint32_t>(boost::size(args));
+  for (const auto& arg : args)
+    out->Put<std::int32_t>(arg.first);
+}
+
+/// Writes the vector of indices.
+void PutIndices(const std::vector<int>& indices, SnapshotWriter* out) {
+  out->Put<std::uint32_t>(indices.size());
+  for (int index : indices)
+    out->Put<std::int32_t>(index);
+}
+
+/// @returns The vector of variable indices.
+///
+/// @param[in] num_variables  The number of variables in the graph.
+/// @param[in,out] in  The snapshot source.
+///
+/// @throws IOError  The indices are not valid variable indices.
+std::vector<int> GetIndices(int num_variables, SnapshotReader* in) {
+  std::vector<int> indices(in->GetCount());
+  for (int& index : indices) {
+    index = in->Get<std::int32_t>();
+    if (index < Pdag::kVariableStartIndex ||
+        index >= Pdag::kVariableStartIndex + num_variables) {
+      SCRAM_THROW(IOError("Invalid variable index in the PDAG snapshot."));
+    }
+  }
+  return indices;
+}
+
+}  // namespace
+
+PdagCache::PdagCache(const std::string& directory, const mef::Gate& root,
+                     const Settings& settings, const mef::Model* model,
+                     std::string_view preprocessor) noexcept
+    : root_(root), model_(model), ccf_(settings.ccf_analysis()) {
+  StructureHash structure(ccf_);
+  SnapshotHash& hash = structure.hash();
+  hash.Add(kVersion);
+  hash.Add(SCRAM_VERSION);
+  hash.Add(SCRAM_GIT_REVISION);
+  hash.Add(preprocessor);
+  structure(&root_);
+  if (model_) {
+    for (const mef::Substitution& substitution : model_->substitutions())
+      structure(substitution);
+  }
+  key_ = hash.value();
+  snapshot_ = SnapshotPath(directory, key_, "scram-pdag");
+}
+
+std::unique_ptr<Pdag> PdagCache::Load() const noexcept {
+  std::string data = LoadSnapshot(snapshot_);
+  if (data.empty()) {
+    LOG(DEBUG2) << "No PDAG snapshot " << snapshot_;
+    return nullptr;
+  }
+  TIMER(DEBUG2, "Loading the PDAG snapshot");
+  try {
+    SnapshotReader in(data);
+    in.GetHeader(kMagic, kVersion, key_);
+
+    auto graph = std::make_unique<Pdag>();
+    graph->register_null_gates_ = false;
+    Pdag::ProcessedNodes nodes;  // Variables with the original indices.
+    graph->GatherVariables(root_.formula(), ccf_, &nodes);
+    if (model_) {
+      for (const mef::Substitution& substitution : model_->substitutions())
+        graph->GatherVariables(substitution, ccf_, &nodes);
+    }
+    int num_variables = graph->basic_events_.size();
+    std::vector<VariablePtr> variables(num_variables);
+    for (const auto& entry : nodes.variables)
+      variables[entry.second->index() - Pdag::kVariableStartIndex] =
+          entry.second;
+    if (in.Get<std::int32_t>() != num_variables)
+      SCRAM_THROW(IOError("Mismatched variables in the PDAG snapshot."));
+
+    int node_index = in.Get<std::int32_t>();
+    graph->complement_ = in.Get<bool>();
+    graph->coherent_ = in.Get<bool>();
+    graph->normal_ = in.Get<bool>();
+
+    auto invalid_gate = [] {
+      SCRAM_THROW(IOError("Invalid gate in the PDAG snapshot."));
+    };
+    std::unordered_map<int, GatePtr> gates;
+    for (std::uint32_t i = 0, num_gates = in.GetCount(); i < num_gates; ++i) {
+      int index = in.Get<std::int32_t>();
+      auto type = in.Get<std::uint8_t>();
+      if (index < Pdag::kVariableStartIndex + num_variables ||
+          index > node_index || gates.count(index) ||
+          type >= kNumConnectives) {
+        invalid_gate();
+      }
+      graph->node_index_ = index - 1;
+      auto gate =
+          std::make_shared<Gate>(static_cast<Connective>(type), graph.get());
+      assert(gate->index() == index);
+      gate->min_number(in.Get<std::int32_t>());
+      if (in.Get<bool>())
+        gate->module(true);
+      gate->coherent(in.Get<bool>());
+      gate->order(in.Get<std::int32_t>());
+
+      auto add_arg = [&gate, &invalid_gate](int arg_index, const auto& arg) {
+        if (!arg || gate->args().count(arg_index) ||
+            gate->args().count(-arg_index) ||
+            ((gate->type() == kNot || gate->type() == kNull) &&
+             !gate->args().empty())) {
+          invalid_gate();
+        }
+        gate->AddArg(arg_index, arg);
+      };
+      for (std::uint32_t j = 0, num_args = in.GetCount(); j < num_args; ++j) {
+        int arg_index = in.Get<std::int32_t>();
+        auto it = gates.find(std::abs(arg_index));
+        add_arg(arg_index, it == gates.end() ? nullptr : it->second);
+      }
+      for (std::uint32_t j = 0, num_args = in.GetCount(); j < num_args; ++j) {
+        int arg_index = in.Get<std::int32_t>();
+        int position = std::abs(arg_index) - Pdag::kVariableStartIndex;
+        add_arg(arg_index, position < 0 || position >= num_variables
+                               ? nullptr
+                               : variables[position]);
+      }
+      if (int constant = in.Get<std::int8_t>()) {
+        if (!gate->args().empty())
+          invalid_gate();
+        gate->MakeConstant(constant > 0);
+      }
+      gates.emplace(index, std::move(gate));
+    }
+    auto it = gates.find(in.Get<std::int32_t>());
+    if (it == gates.end())
+      invalid_gate();
+    graph->root_ = it->second;
+
+    for (std::uint32_t i = 0, num_orders = in.GetCount(); i < num_orders;
+         ++i) {
+      int position = in.Get<std::int32_t>() - Pdag::kVariableStartIndex;
+      if (position < 0 || position >= num_variables)
+        SCRAM_THROW(IOError("Invalid variable in the PDAG snapshot."));
+      variables[position]->order(in.Get<std::int32_t>());
+    }
+
+    for (std::uint32_t i = 0, num_substitutions = in.GetCount();
+         i < num_substitutions; ++i) {
+      std::vector<int> hypothesis = GetIndices(num_variables, &in);
+      std::vector<int> source = GetIndices(num_variables, &in);
+      int target = in.Get<std::int32_t>();
+      graph->substitutions_.push_back(
+          {std::move(hypothesis), std::move(source), target});
+    }
+    if (!in.empty())
+      SCRAM_THROW(IOError("Unexpected data at the end of the PDAG snapshot."));
+
+    graph->node_index_ = node_index;
+    graph->register_null_gates_ = true;
+    LOG(DEBUG2) << "Loaded the preprocessed PDAG from " << snapshot_;
+    return graph;
+  } catch (const std::exception& err) {
+    LOG(WARNING) << "Ignoring the corrupt PDAG cache " << snapshot_ << ": "
+                 << err.what();
+    return nullptr;
+  }
+}
+
+void PdagCache::Store(const Pdag& graph) const {
+  GraphNodes nodes;
+  nodes(graph.root());
+
+  SnapshotWriter out;
+  PutSnapshotHeader(kMagic, kVersion, key_, &out);
+  out.Put<std::int32_t>(graph.basic_events().size());
+  out.Put<std::int32_t>(graph.node_index_);
+  out.Put(graph.complement());
+  out.Put(graph.coherent());
+  out.Put(graph.normal());
+
+  out.Put<std::uint32_t>(nodes.gates.size());
+  for (const Gate* gate : nodes.gates) {
+    out.Put<std::int32_t>(gate->index());
+    out.Put<std::uint8_t>(gate->type());
+    out.Put<std::int32_t>(gate->min_number());
+    out.Put(gate->module());
+    out.Put(gate->coherent());
+    out.Put<std::int32_t>(gate->order());
+    PutArgs(gate->args<Gate>(), &out);
+    PutArgs(gate->args<Variable>(), &out);
+    std::int8_t constant = 0;
+    if (gate->constant())
+      constant = *gate->args().begin() > 0 ? 1 : -1;
+    out.Put(constant);
+  }
+  out.Put<std::int32_t>(graph.root().index());
+
+  out.Put<std::uint32_t>(nodes.variables.size());
+  for (const Variable* variable : nodes.variables) {
+    out.Put<std::int32_t>(variable->index());
+    out.Put<std::int32_t>(variable->order());
+  }
+
+  out.Put<std::uint32_t>(graph.substitutions().size());
+  for (const Pdag::Substitution& substitution : graph.substitutions()) {
+    PutIndices(substitution.hypothesis, &out);
+    PutIndices(substitution.source, &out);
+    out.Put<std::int32_t>(substitution.target);
+  }
+
+  StoreSnapshot(snapshot_, out.data());
+}
+
+}  // namespace scram::core
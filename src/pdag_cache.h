@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Persistent binary snapshots of preprocessed PDAGs.
+
+#pragma once
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "event.h"
+#include "model.h"
+#include "pdag.h"
+#include "settings.h"
+
+namespace scram::core {
+
+/// Cache of preprocessed PDAGs
+/// to skip the preprocessing of unchanged fault trees.
+///
+/// The snapshots are keyed by the structure of the fault tree
+/// reachable from the top gate (incl. CCF groups and substitutions),
+/// the kind of preprocessing,
+/// and the SCRAM version.
+/// Any mismatch or corruption of the snapshot results in a cache miss.
+class PdagCache {
+ public:
+  /// Computes the key of the fault tree.
+  ///
+  /// @param[in] directory  The cache directory (created on demand).
+  /// @param[in] root  The top gate of the fault tree.
+  /// @param[in] settings  Analysis settings for the PDAG construction.
+  /// @param[in] model  The Model containing substitutions if any.
+  /// @param[in] preprocessor  The unique name of the preprocessing kind.
+  PdagCache(const std::string& directory, const mef::Gate& root,
+            const Settings& settings, const mef::Model* model,
+            std::string_view preprocessor) noexcept;
+
+  /// @returns The snapshot file for the fault tree.
+  const std::string& snapshot() const { return snapshot_; }
+
+  /// Loads the preprocessed PDAG from the snapshot.
+  ///
+  /// @returns The graph ready for the analysis algorithm,
+  ///          or nullptr if no valid snapshot is found.
+  std::unique_ptr<Pdag> Load() const noexcept;
+
+  /// Stores the snapshot of the preprocessed PDAG.
+  ///
+  /// @param[in] graph  The graph constructed from the fault tree
+  ///                   and preprocessed for the analysis algorithm.
+  ///
+  /// @throws IOError  The snapshot cannot be written into the cache directory.
+  void Store(const Pdag& graph) const;
+
+ private:
+  const mef::Gate& root_;  ///< The top gate of the fault tree.
+  const mef::Model* model_;  ///< The optional model with substitutions.
+  bool ccf_;  ///< Incorporation of CCF groups.
+  std::string snapshot_;  ///< The snapshot file path.
+  std::uint64_t key_ = 0;  ///< The unique key of the fault tree.
+};
+
+}  // namespace scram::core
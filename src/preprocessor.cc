@@ -110,6 +110,8 @@ void TopologicalOrder(Pdag* graph) noexcept {
   auto topological_order = [](auto& self, Gate* root, int order) {
     if (root->order())
       return order;
+    if (root->constant())  // Only in graphs without preprocessing.
+      return order;
     for (Gate* arg : OrderArguments<Gate>(root)) {
       order = self(self, arg, order);
     }
@@ -117,7 +119,6 @@ void TopologicalOrder(Pdag* graph) noexcept {
       if (!arg->order())
         arg->order(++order);
     }
-    assert(!root->constant());
     root->order(++order);
     return order;
   };
@@ -169,11 +170,124 @@ void MarkCoherence(Pdag* graph) noexcept {
 
 Preprocessor::Preprocessor(Pdag* graph) noexcept : graph_(graph) {}
 
+Preprocessor::Preprocessor(Pdag* graph, const Settings& settings) noexcept
+    : graph_(graph) {
+  for (int i = 0; i < kNumBudgets; ++i)
+    budgets_[i] =
+        settings.preprocessing_budget(static_cast<PreprocessorPass>(i));
+}
+
 void Preprocessor::operator()() noexcept {
   TIMER(DEBUG2, "Preprocessing");
   this->Run();
 }
 
+GraphSize MeasureGraph(const Pdag& graph) noexcept {
+  GraphSize size;
+  std::vector<bool> visited;
+  std::vector<const Gate*> gates = {&graph.root()};
+  while (!gates.empty()) {
+    const Gate* gate = gates.back();
+    gates.pop_back();
+    if (gate->index() >= visited.size())
+      visited.resize(gate->index() + 1);
+    if (visited[gate->index()])
+      continue;
+    visited[gate->index()] = true;
+    ++size.gates;
+    size.args += gate->args().size();
+    if (gate->module())
+      ++size.modules;
+    for (const auto& arg : gate->args<Gate>())
+      gates.push_back(&arg.second);
+  }
+  return size;
+}
+
+/// Recorder of the statistics and time budget of a preprocessing pass run.
+/// Optional passes with spent budgets are skipped,
+/// and passes may stop early with the BudgetSpent check.
+class Preprocessor::PassScope : private boost::noncopyable {
+ public:
+  /// Starts a run of a pass without a budget.
+  ///
+  /// @param[in,out] preprocessor  The host preprocessor.
+  /// @param[in] name  The name of the pass.
+  PassScope(Preprocessor* preprocessor, const char* name) noexcept
+      : preprocessor_(*preprocessor), budget_(-1), start_(TIME_STAMP()) {
+    stats_.name = name;
+    stats_.runs = 1;
+    stats_.before = MeasureGraph(*preprocessor_.graph_);
+    previous_ = std::exchange(preprocessor_.pass_, this);
+  }
+
+  /// Starts a run of an optional pass with a time budget.
+  ///
+  /// @param[in,out] preprocessor  The host preprocessor.
+  /// @param[in] pass  The optional pass.
+  PassScope(Preprocessor* preprocessor, PreprocessorPass pass) noexcept
+      : PassScope(preprocessor,
+                  kPreprocessorPassToString[static_cast<int>(pass)]) {
+    budget_ = static_cast<int>(pass);
+    double budget = preprocessor_.budgets_[budget_];
+    if (budget && preprocessor_.spent_[budget_] >= budget) {
+      LOG(DEBUG3) << "Skipping " << stats_.name << ": the budget is spent.";
+      stats_.skipped = true;
+    }
+  }
+
+  /// Records the statistics of the run.
+  ~PassScope() noexcept {
+    preprocessor_.pass_ = previous_;
+    stats_.time = DUR(start_);
+    if (budget_ >= 0)
+      preprocessor_.spent_[budget_] += stats_.time;
+    stats_.after =
+        stats_.skipped ? stats_.before : MeasureGraph(*preprocessor_.graph_);
+
+    std::vector<PassStats>& records = preprocessor_.stats_;
+    if (records.empty() ||
+        std::string_view(records.back().name) != stats_.name) {
+      records.push_back(stats_);
+      return;
+    }
+    PassStats& last = records.back();  // Merge consecutive runs.
+    ++last.runs;
+    last.time += stats_.time;
+    last.after = stats_.after;
+    last.skipped &= stats_.skipped;
+    last.aborted |= stats_.aborted;
+  }
+
+  /// @returns true if the budget is spent before the start of the run.
+  bool skipped() const { return stats_.skipped; }
+
+  /// @returns true if the budget of the pass is spent.
+  ///
+  /// @post The run is registered as aborted.
+  bool expired() noexcept {
+    if (budget_ < 0 || !preprocessor_.budgets_[budget_])
+      return false;
+    if (!stats_.aborted &&
+        preprocessor_.spent_[budget_] + DUR(start_) <
+            preprocessor_.budgets_[budget_])
+      return false;
+    if (!stats_.aborted)
+      LOG(DEBUG3) << "Stopping " << stats_.name << ": the budget is spent.";
+    stats_.aborted = true;
+    return true;
+  }
+
+ private:
+  Preprocessor& preprocessor_;  ///< The host preprocessor.
+  PassScope* previous_;  ///< The enclosing pass run.
+  int budget_;  ///< The index of the budget; negative for no budget.
+  std::uint64_t start_;  ///< The start time stamp.
+  PassStats stats_;  ///< The statistics of this run.
+};
+
+bool Preprocessor::BudgetSpent() noexcept { return pass_ && pass_->expired(); }
+
 void Preprocessor::Run() noexcept {
   pdag::Transform(graph_, [this](Pdag*) { RunPhaseOne(); },
                   [this](Pdag*) { RunPhaseTwo(); },
@@ -448,13 +562,13 @@ bool DetectOverlap(int a_min, int a_max, int b_min, int b_max) noexcept {
 /// @param[in] exit_time  The exit time of the root gate of the graph.
 ///
 /// @returns true if the node within the graph visit times.
-bool IsNodeWithinGraph(const NodePtr& node, int enter_time,
+bool IsNodeWithinGraph(const Node& node, int enter_time,
                        int exit_time) noexcept {
   assert(enter_time > 0);
   assert(exit_time > enter_time);
-  assert(node->EnterTime() >= 0);
-  assert(node->LastVisit() >= node->EnterTime());
-  return node->EnterTime() > enter_time && node->LastVisit() < exit_time;
+  assert(node.EnterTime() >= 0);
+  assert(node.LastVisit() >= node.EnterTime());
+  return node.EnterTime() > enter_time && node.LastVisit() < exit_time;
 }
 
 /// Checks if a subgraph with a root gate is within a subgraph.
@@ -479,6 +593,7 @@ bool IsSubgraphWithinGraph(const GatePtr& root, int enter_time,
 
 void Preprocessor::NormalizeGates(bool full) noexcept {
   TIMER(DEBUG3, (full ? "Full normalization" : "Partial normalization"));
+  PassScope pass(this, "normalization");
   assert(!graph_->HasNullGates());
   if (full)
     pdag::TopologicalOrder(graph_);  // K/N gates need order.
@@ -685,6 +800,7 @@ bool Preprocessor::CoalesceGates(bool common) noexcept {
   assert(!graph_->HasNullGates());
   if (graph_->root()->constant())
     return false;
+  PassScope pass(this, "coalescing");
   graph_->Clear<Pdag::kGateMark>();
   bool ret = CoalesceGates(graph_->root(), common);
 
@@ -749,6 +865,7 @@ bool Preprocessor::ProcessMultipleDefinitions() noexcept {
     return false;
 
   TIMER(DEBUG3, "Detecting multiple definitions");
+  PassScope pass(this, "multiple-definitions");
 
   graph_->Clear<Pdag::kGateMark>();
   // The original gate and its multiple definitions.
@@ -800,6 +917,7 @@ void Preprocessor::DetectMultipleDefinitions(
 
 void Preprocessor::DetectModules() noexcept {
   TIMER(DEBUG3, "Module detection");
+  PassScope pass(this, "module-detection");
   assert(!graph_->HasNullGates());
   const GatePtr& root_gate = graph_->root();  // No change in this algorithm.
   // First stage, traverse the graph depth-first for gates
@@ -870,13 +988,13 @@ void Preprocessor::FindModules(const GatePtr& gate) noexcept {
   for (const Gate::Arg<Variable>& arg : gate->args<Variable>()) {
     const VariablePtr& var = arg.second;
     if (var->parents().size() == 1) {
-      assert(IsNodeWithinGraph(var, enter_time, exit_time));
+      assert(IsNodeWithinGraph(*var, enter_time, exit_time));
       assert(var->parents().count(gate->index()));
 
       non_shared_args.push_back(arg);
       continue;  // The single parent argument.
     }
-    if (IsNodeWithinGraph(var, enter_time, exit_time)) {
+    if (IsNodeWithinGraph(*var, enter_time, exit_time)) {
       modular_args.push_back(arg);
     } else {
       non_modular_args.push_back(arg);
@@ -1096,6 +1214,9 @@ std::vector<GateWeakPtr> Preprocessor::GatherModules() noexcept {
 bool Preprocessor::MergeCommonArgs() noexcept {
   TIMER(DEBUG3, "Merging common arguments");
   assert(!graph_->HasNullGates());
+  PassScope pass(this, PreprocessorPass::kMergeCommonArgs);
+  if (pass.skipped())
+    return false;
   bool changed = false;
 
   LOG(DEBUG4) << "Merging common arguments for AND gates...";
@@ -1123,6 +1244,8 @@ bool Preprocessor::MergeCommonArgs(Connective op) noexcept {
   LOG(DEBUG4) << "Working with " << modules.size() << " modules...";
   bool changed = false;
   for (const auto& module : modules) {
+    if (BudgetSpent())
+      break;
     if (module.expired())
       continue;
     GatePtr root = module.lock();
@@ -1515,6 +1638,9 @@ void Preprocessor::TransformCommonArgs(MergeTable::MergeGroup* group) noexcept {
 bool Preprocessor::DetectDistributivity() noexcept {
   TIMER(DEBUG3, "Processing Distributivity");
   assert(!graph_->HasNullGates());
+  PassScope pass(this, PreprocessorPass::kDistributivity);
+  if (pass.skipped())
+    return false;
   graph_->Clear<Pdag::kGateMark>();
   bool changed = DetectDistributivity(graph_->root());
   assert(!graph_->HasConstants());
@@ -1778,6 +1904,9 @@ void Preprocessor::TransformDistributiveArgs(
 void Preprocessor::BooleanOptimization() noexcept {
   TIMER(DEBUG3, "Boolean optimization");
   assert(!graph_->HasNullGates());
+  PassScope pass(this, PreprocessorPass::kBooleanOptimization);
+  if (pass.skipped())
+    return;
   graph_->Clear<Pdag::kGateMark>();
   graph_->Clear<Pdag::kOptiValue>();
   graph_->Clear<Pdag::kDescendant>();
@@ -1787,10 +1916,16 @@ void Preprocessor::BooleanOptimization() noexcept {
   std::vector<GateWeakPtr> common_gates;
   std::vector<std::weak_ptr<Variable>> common_variables;
   GatherCommonNodes(&common_gates, &common_variables);
-  for (const auto& gate : common_gates)
+  for (const auto& gate : common_gates) {
+    if (BudgetSpent())
+      return;
     ProcessCommonNode(gate);
-  for (const auto& var : common_variables)
+  }
+  for (const auto& var : common_variables) {
+    if (BudgetSpent())
+      return;
     ProcessCommonNode(var);
+  }
 }
 
 void Preprocessor::GatherCommonNodes(
@@ -1835,7 +1970,7 @@ void Preprocessor::ProcessCommonNode(
   if (node->parents().size() == 1)
     return;  // The extra parent is deleted.
   GatePtr root;
-  MarkAncestors(node, &root);
+  MarkAncestors(*node, &root);
   assert(root && "Marking ancestors ended without guaranteed module.");
   assert(root->mark() && "Graph gate marks are not cleaned.");
   assert(!root->opti_value() && "Optimization values are corrupted.");
@@ -1870,25 +2005,23 @@ void Preprocessor::ProcessCommonNode(
       ProcessStateDestinations(node, destinations);
     }
   }
-  ClearStateMarks(root);
+  ClearStateMarks(root.get());
   node->opti_value(0);
   graph_->RemoveNullGates();
 }
 
-void Preprocessor::MarkAncestors(const NodePtr& node,
-                                 GatePtr* module) noexcept {
-  for (const Node::Parent& member : node->parents()) {
-    assert(!member.second.expired());
-    GatePtr parent = member.second.lock();
-    if (parent->mark())
+void Preprocessor::MarkAncestors(const Node& node, GatePtr* module) noexcept {
+  for (const Node::Parent& member : node.parents()) {
+    if (graph_->state(member.first).mark)
       continue;
+    Gate* parent = member.second;
     parent->mark(true);
     if (parent->module()) {  // Do not mark further than independent subgraph.
       assert(!*module);
-      *module = parent;
+      *module = parent->shared_from_this();
       continue;
     }
-    MarkAncestors(parent, module);
+    MarkAncestors(*parent, module);
   }
 }
 
@@ -1904,10 +2037,11 @@ int Preprocessor::PropagateState(const GatePtr& gate,
   int num_failure = 0;  // The number of failed arguments.
   int num_success = 0;  // The number of success arguments.
   for (const Gate::Arg<Gate>& arg : gate->args<Gate>()) {
-    const GatePtr& arg_gate = arg.second;
-    mult_tot += PropagateState(arg_gate, node);
-    assert(!arg_gate->mark());
-    int failed = arg_gate->opti_value() * boost::math::sign(arg.first);
+    if (graph_->state(arg.first).mark)
+      mult_tot += PropagateState(arg.second, node);
+    assert(!arg.second->mark());
+    int failed =
+        graph_->state(arg.first).opti_value * boost::math::sign(arg.first);
     assert(!failed || failed == -1 || failed == 1);
     if (failed == 1) {
       ++num_failure;
@@ -1998,16 +2132,17 @@ int Preprocessor::CollectStateDestinations(
   gate->opti_value(2);
   int num_dest = 0;
   for (const Gate::Arg<Gate>& member : gate->args<Gate>()) {
-    const GatePtr& arg = member.second;
-    num_dest += CollectStateDestinations(arg, index, destinations);
-    if (arg->index() == index)
+    const NodeState& arg_state = graph_->state(member.first);
+    if (arg_state.descendant)
+      num_dest += CollectStateDestinations(member.second, index, destinations);
+    if (std::abs(member.first) == index)
       continue;  // The state source.
-    if (!arg->opti_value())
+    if (!arg_state.opti_value)
       continue;  // Indeterminate branches.
-    if (arg->opti_value() > 1)
+    if (arg_state.opti_value > 1)
       continue;  // Not a state destination.
     ++num_dest;  // Optimization value is 1 or -1.
-    destinations->emplace(arg->index(), arg);
+    destinations->emplace(std::abs(member.first), member.second);
   }
   return num_dest;
 }
@@ -2016,8 +2151,7 @@ void Preprocessor::CollectRedundantParents(
     const NodePtr& node, std::unordered_map<int, GateWeakPtr>* destinations,
     std::vector<GateWeakPtr>* redundant_parents) noexcept {
   for (const Node::Parent& member : node->parents()) {
-    assert(!member.second.expired());
-    GatePtr parent = member.second.lock();
+    Gate* parent = member.second;
     assert(!parent->mark());
     if (parent->opti_value() == 2)
       continue;  // Non-redundant parent.
@@ -2033,7 +2167,7 @@ void Preprocessor::CollectRedundantParents(
         assert(!(graph_->coherent() && parent->type() == type));
       }
     }
-    redundant_parents->push_back(parent);
+    redundant_parents->push_back(parent->weak_from_this());
   }
 }
 
@@ -2083,22 +2217,27 @@ void Preprocessor::ProcessStateDestinations(
   }
 }
 
-void Preprocessor::ClearStateMarks(const GatePtr& gate) noexcept {
+void Preprocessor::ClearStateMarks(Gate* gate) noexcept {
   if (!gate->descendant())
     return;  // Clean only 'dirty' gates.
   gate->descendant(0);
   gate->opti_value(0);
   for (const Gate::Arg<Gate>& arg : gate->args<Gate>()) {
-    ClearStateMarks(arg.second);
+    if (graph_->state(arg.first).descendant)
+      ClearStateMarks(arg.second.get());
   }
   for (const Node::Parent& member : gate->parents()) {
-    ClearStateMarks(member.second.lock());  // Due to replacement.
+    if (graph_->state(member.first).descendant)
+      ClearStateMarks(member.second);  // Due to replacement.
   }
 }
 
 bool Preprocessor::DecomposeCommonNodes() noexcept {
   TIMER(DEBUG3, "Decomposition of common nodes");
   assert(!graph_->HasNullGates());
+  PassScope pass(this, PreprocessorPass::kDecomposition);
+  if (pass.skipped())
+    return false;
 
   std::vector<GateWeakPtr> common_gates;
   std::vector<std::weak_ptr<Variable>> common_variables;
@@ -2115,6 +2254,8 @@ bool Preprocessor::DecomposeCommonNodes() noexcept {
   // The deepest-first processing avoids generating extra parents
   // for the nodes that are deep in the graph.
   for (auto it = common_gates.rbegin(); it != common_gates.rend(); ++it) {
+    if (BudgetSpent())
+      return changed;
     changed |= DecompositionProcessor()(*it, this);
   }
 
@@ -2123,6 +2264,8 @@ bool Preprocessor::DecomposeCommonNodes() noexcept {
   // there may be no need to process these variables.
   for (auto it = common_variables.rbegin(); it != common_variables.rend();
        ++it) {
+    if (BudgetSpent())
+      return changed;
     changed |= DecompositionProcessor()(*it, this);
   }
   return changed;
@@ -2154,31 +2297,28 @@ bool Preprocessor::DecompositionProcessor::operator()(  // clang-format confuse?
   // Determine if the decomposition setups are possible.
   auto it = boost::find_if(
       node_->parents(), [&is_decomposition_type](const Node::Parent& member) {
-        return is_decomposition_type(member.second.lock()->type());
+        return is_decomposition_type(member.second->type());
       });
   if (it == node_->parents().end())
     return false;  // No setups possible.
 
   assert(2 > boost::count_if(node_->parents(), [](const Node::Parent& member) {
-           return member.second.lock()->module();
+           return member.second->module();
          }));
 
   // Mark parents and ancestors.
   for (const Node::Parent& member : node_->parents()) {
-    assert(!member.second.expired());
-    GatePtr parent = member.second.lock();
-    MarkDestinations(parent);
+    MarkDestinations(member.second);
   }
   // Find destinations with particular setups.
   // If a parent gets marked upon destination search,
   // the parent is the destination.
   std::vector<GateWeakPtr> dest;
   for (const Node::Parent& member : node_->parents()) {
-    assert(!member.second.expired());
-    GatePtr parent = member.second.lock();
+    Gate* parent = member.second;
     if (parent->descendant() == node_->index() &&
         is_decomposition_type(parent->type())) {
-      dest.push_back(parent);
+      dest.push_back(parent->weak_from_this());
     }
   }
   if (dest.empty())
@@ -2190,14 +2330,14 @@ bool Preprocessor::DecompositionProcessor::operator()(  // clang-format confuse?
 }
 
 void Preprocessor::DecompositionProcessor::MarkDestinations(
-    const GatePtr& parent) noexcept {
+    Gate* parent) noexcept {
   if (parent->module())
     return;  // Limited with independent subgraphs.
   for (const Node::Parent& member : parent->parents()) {
-    assert(!member.second.expired());
-    GatePtr ancestor = member.second.lock();
-    if (ancestor->descendant() == node_->index())
+    if (preprocessor_->graph_->state(member.first).descendant ==
+        node_->index())
       continue;  // Already marked.
+    Gate* ancestor = member.second;
     ancestor->descendant(node_->index());
     MarkDestinations(ancestor);
   }
@@ -2254,7 +2394,7 @@ bool Preprocessor::DecompositionProcessor::ProcessAncestors(
     GatePtr gate = arg.second;
     if (node_->parents().count(gate->index())) {
       LOG(DEBUG5) << "Reached decomposition sub-parent G" << gate->index();
-      if (IsAncestryWithinGraph(gate, root)) {
+      if (IsAncestryWithinGraph(gate.get(), *root)) {
         changed = true;
         gate->ProcessConstantArg(node_, state);
         preprocessor_->RegisterToClear(gate);
@@ -2275,12 +2415,12 @@ bool Preprocessor::DecompositionProcessor::ProcessAncestors(
     }
     if (gate->descendant() != node_->index())
       continue;
-    if (!IsAncestryWithinGraph(gate, root))
+    if (!IsAncestryWithinGraph(gate.get(), *root))
       continue;
     changed |= ProcessAncestors(gate, state, root);
   }
   for (const auto& arg : ancestor->args<Gate>()) {
-    ClearAncestorMarks(arg.second, root);
+    ClearAncestorMarks(arg.second.get(), *root);
   }
   for (const auto& arg : to_swap) {
     ancestor->EraseArg(arg.first);
@@ -2296,35 +2436,35 @@ bool Preprocessor::DecompositionProcessor::ProcessAncestors(
 }
 
 bool Preprocessor::DecompositionProcessor::IsAncestryWithinGraph(
-    const GatePtr& gate, const GatePtr& root) noexcept {
-  if (gate == root)
+    Gate* gate, const Gate& root) noexcept {
+  if (gate == &root)
     return true;
-  if (gate->ancestor() == root->index())
+  if (gate->ancestor() == root.index())
     return true;
-  if (gate->ancestor() == -root->index())
+  if (gate->ancestor() == -root.index())
     return false;
 
-  if (IsNodeWithinGraph(gate, root->EnterTime(), root->ExitTime()) &&
+  if (IsNodeWithinGraph(*gate, root.EnterTime(), root.ExitTime()) &&
       ext::all_of(gate->parents(), [&root](const Node::Parent& member) {
-        return IsAncestryWithinGraph(member.second.lock(), root);
+        return IsAncestryWithinGraph(member.second, root);
       })) {
-    gate->ancestor(root->index());
+    gate->ancestor(root.index());
     return true;
   }
 
-  gate->ancestor(-root->index());
+  gate->ancestor(-root.index());
   return false;
 }
 
 void Preprocessor::DecompositionProcessor::ClearAncestorMarks(
-    const GatePtr& gate, const GatePtr& root) noexcept {
-  assert(root->ancestor() == 0 && "The root mark is dirty.");
+    Gate* gate, const Gate& root) noexcept {
+  assert(root.ancestor() == 0 && "The root mark is dirty.");
   if (gate->ancestor() == 0)
     return;
-  assert(std::abs(gate->ancestor()) == root->index() && "Wrong markings.");
+  assert(std::abs(gate->ancestor()) == root.index() && "Wrong markings.");
   gate->ancestor(0);
   for (const Node::Parent& member : gate->parents()) {
-    ClearAncestorMarks(member.second.lock(), root);
+    ClearAncestorMarks(member.second, root);
   }
 }
 
@@ -2332,7 +2472,7 @@ void Preprocessor::ReplaceGate(const GatePtr& gate,
                                const GatePtr& replacement) noexcept {
   assert(!gate->parents().empty());
   while (!gate->parents().empty()) {
-    GatePtr parent = gate->parents().begin()->second.lock();
+    Gate* parent = gate->parents().begin()->second;
     int sign = parent->GetArgSign(gate);
     parent->EraseArg(sign * gate->index());
     parent->AddArg(replacement, sign < 0);
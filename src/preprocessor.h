@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include <array>
+#include <iterator>
 #include <memory>
 #include <set>
 #include <unordered_map>
@@ -31,6 +33,7 @@
 #include <boost/unordered_map.hpp>
 
 #include "pdag.h"
+#include "settings.h"
 
 namespace scram::core {
 
@@ -82,6 +85,32 @@ void MarkCoherence(Pdag* graph) noexcept;
 
 }  // namespace pdag
 
+/// The size of a PDAG.
+struct GraphSize {
+  int gates = 0;  ///< The number of gates.
+  int args = 0;  ///< The number of gate arguments.
+  int modules = 0;  ///< The number of module gates.
+};
+
+/// Measures the graph without the use of gate marks.
+///
+/// @param[in] graph  The graph to measure.
+///
+/// @returns The size of the graph reachable from the root.
+GraphSize MeasureGraph(const Pdag& graph) noexcept;
+
+/// Statistics of a preprocessing pass.
+/// Consecutive runs of the same pass are merged into one record.
+struct PassStats {
+  const char* name = nullptr;  ///< The name of the pass.
+  int runs = 0;  ///< The number of consecutive runs.
+  double time = 0;  ///< The total time of the runs in seconds.
+  GraphSize before;  ///< The graph before the first run.
+  GraphSize after;  ///< The graph after the last run.
+  bool skipped = false;  ///< The runs are skipped with the budget spent.
+  bool aborted = false;  ///< The budget is spent in the middle of a run.
+};
+
 /// The class provides main preprocessing operations
 /// over a PDAG
 /// to simplify the fault tree
@@ -103,13 +132,24 @@ class Preprocessor : private boost::noncopyable {
   ///          which will mess the new structure of the PDAG.
   explicit Preprocessor(Pdag* graph) noexcept;
 
+  /// Constructs a preprocessor
+  /// with time budgets for optional preprocessing passes.
+  ///
+  /// @param[in] graph  The PDAG to be preprocessed.
+  /// @param[in] settings  The settings with the preprocessing budgets.
+  Preprocessor(Pdag* graph, const Settings& settings) noexcept;
+
   virtual ~Preprocessor() = default;
 
   /// Runs the graph preprocessing.
   void operator()() noexcept;
 
+  /// @returns The statistics of the preprocessing passes in the run order.
+  const std::vector<PassStats>& stats() const { return stats_; }
+
  protected:
   class GateSet;  ///< Container of unique gates by semantics.
+  class PassScope;  ///< Statistics and budget of a pass run.
 
   /// Runs the default preprocessing
   /// that achieves the graph in a normal form.
@@ -727,7 +767,7 @@ class Preprocessor : private boost::noncopyable {
   ///          cleanup must be performed after/with the use of the ancestors.
   ///          If the cleanup is done improperly or not at all,
   ///          the default global contract of clean marks will be broken.
-  void MarkAncestors(const NodePtr& node, GatePtr* module) noexcept;
+  void MarkAncestors(const Node& node, GatePtr* module) noexcept;
 
   /// Propagates failure or success of a common node
   /// by setting its ancestors' optimization values to 1 or -1
@@ -826,7 +866,7 @@ class Preprocessor : private boost::noncopyable {
   /// @pre The common node itself is not the ancestor.
   ///
   /// @warning The common node must be cleaned separately.
-  void ClearStateMarks(const GatePtr& gate) noexcept;
+  void ClearStateMarks(Gate* gate) noexcept;
 
   /// The Shannon decomposition for common nodes in the PDAG.
   /// This procedure is also called "Constant Propagation",
@@ -885,7 +925,7 @@ class Preprocessor : private boost::noncopyable {
     /// @pre Marking is limited by a single root module.
     ///
     /// @post The ancestor gate descendant marks are set to the index.
-    void MarkDestinations(const GatePtr& parent) noexcept;
+    void MarkDestinations(Gate* parent) noexcept;
 
     /// Processes decomposition destinations
     /// with the decomposition setups.
@@ -934,8 +974,7 @@ class Preprocessor : private boost::noncopyable {
     ///
     /// @post The ancestor gates are marked with the signed root gate index
     ///       as explained in the precondition.
-    static bool IsAncestryWithinGraph(const GatePtr& gate,
-                                      const GatePtr& root) noexcept;
+    static bool IsAncestryWithinGraph(Gate* gate, const Gate& root) noexcept;
 
     /// Clears only the used ancestor marks.
     ///
@@ -944,8 +983,7 @@ class Preprocessor : private boost::noncopyable {
     /// @param[in] root  The root of the graph.
     ///
     /// @post Gate ancestor marks are set to 0.
-    static void ClearAncestorMarks(const GatePtr& gate,
-                                   const GatePtr& root) noexcept;
+    static void ClearAncestorMarks(Gate* gate, const Gate& root) noexcept;
 
     NodePtr node_;  ///< The common node to process.
     Preprocessor* preprocessor_ = nullptr;  ///< The host preprocessor.
@@ -991,8 +1029,21 @@ class Preprocessor : private boost::noncopyable {
   void GatherNodes(const GatePtr& gate, std::vector<GatePtr>* gates,
                    std::vector<VariablePtr>* variables) noexcept;
 
+  /// @returns true if the time budget of the current pass is spent.
+  ///          The pass must stop processing the graph.
+  bool BudgetSpent() noexcept;
+
   /// @todo Eliminate the protected data.
   Pdag* graph_;  ///< The PDAG to preprocess.
+
+ private:
+  /// The number of optional passes with time budgets.
+  static constexpr int kNumBudgets = std::size(kPreprocessorPassToString);
+
+  std::array<double, kNumBudgets> budgets_{};  ///< Budgets of passes.
+  std::array<double, kNumBudgets> spent_{};  ///< Time spent by passes.
+  std::vector<PassStats> stats_;  ///< Statistics of pass runs.
+  PassScope* pass_ = nullptr;  ///< The current pass run.
 };
 
 /// Undefined template class for specialization of Preprocessor
@@ -33,7 +33,11 @@ namespace scram::core {
 
 ProbabilityAnalysis::ProbabilityAnalysis(const FaultTreeAnalysis* fta,
                                          mef::MissionTime* mission_time)
-    : Analysis(fta->settings()), p_total_(0), mission_time_(mission_time) {}
+    : ProbabilityAnalysis(fta->settings(), mission_time) {}
+
+ProbabilityAnalysis::ProbabilityAnalysis(const Settings& settings,
+                                         mef::MissionTime* mission_time)
+    : Analysis(settings), p_total_(0), mission_time_(mission_time) {}
 
 void ProbabilityAnalysis::Analyze() noexcept {
   CLOCK(p_time);
@@ -51,6 +55,7 @@ void ProbabilityAnalysis::Analyze() noexcept {
     ComputeSil();
   LOG(DEBUG3) << "Finished probability calculations in " << DUR(p_time);
   Analysis::AddAnalysisTime(DUR(p_time));
+  Analysis::AddMetric("peak-memory", PeakMemory());
 }
 
 ///< @todo Use Boost math integration instead.
@@ -216,6 +221,71 @@ ProbabilityAnalyzerBase::CalculateProbabilityOverTime() noexcept {
   return p_time;
 }
 
+namespace {
+
+/// Calculates exact probability of a BDD function graph
+/// with an explicit stack instead of recursion over the variables.
+///
+/// @param[in] root  The root vertex of the function graph.
+/// @param[in] mark  A flag to mark traversed vertices.
+/// @param[in] p_vars  The probabilities of the variables.
+/// @param[in] modules  The function graphs of module proxy vertices.
+///
+/// @returns Probability value.
+///
+/// @warning Vertices already marked with the input mark
+///          are not traversed, and their probability values are reused.
+double CalculateBddProbability(
+    const Bdd::VertexPtr& root, bool mark, const Pdag::IndexMap<double>& p_vars,
+    const std::unordered_map<int, Bdd::Function>& modules) noexcept {
+  if (root->terminal())
+    return 1;
+  // Vertices are marked on expansion
+  // and get their probabilities after their branches.
+  std::vector<std::pair<Ite*, bool>> todo = {{&Ite::Ref(root), false}};
+  auto schedule = [&todo, mark](const Bdd::VertexPtr& vertex) {
+    if (!vertex->terminal() && Ite::Ref(vertex).mark() != mark)
+      todo.emplace_back(&Ite::Ref(vertex), false);
+  };
+  auto probability = [](const Bdd::VertexPtr& vertex) {
+    return vertex->terminal() ? 1 : Ite::Ref(vertex).p();
+  };
+  while (!todo.empty()) {
+    auto [ite, expanded] = todo.back();
+    if (!expanded) {
+      if (ite->mark() == mark) {  // Reached through another parent.
+        todo.pop_back();
+        continue;
+      }
+      ite->mark(mark);
+      todo.back().second = true;
+      if (ite->module())
+        schedule(modules.find(ite->index())->second.vertex);
+      schedule(ite->low());
+      schedule(ite->high());
+      continue;
+    }
+    todo.pop_back();
+    double p_var = 0;
+    if (ite->module()) {
+      const Bdd::Function& res = modules.find(ite->index())->second;
+      p_var = probability(res.vertex);
+      if (res.complement)
+        p_var = 1 - p_var;
+    } else {
+      p_var = p_vars[ite->index()];
+    }
+    double high = probability(ite->high());
+    double low = probability(ite->low());
+    if (ite->complement_edge())
+      low = 1 - low;
+    ite->p(p_var * high + (1 - p_var) * low);
+  }
+  return Ite::Ref(root).p();
+}
+
+}  // namespace
+
 ProbabilityAnalyzer<Bdd>::ProbabilityAnalyzer(FaultTreeAnalyzer<Bdd>* fta,
                                               mef::MissionTime* mission_time)
     : ProbabilityAnalyzerBase(fta, mission_time), owner_(false) {
@@ -253,13 +323,14 @@ void ProbabilityAnalyzer<Bdd>::CreateBdd(
 
   CLOCK(prep_time);  // Overall preprocessing time.
   LOG(DEBUG2) << "Preprocessing...";
-  CustomPreprocessor<Bdd>{&graph}();
+  CustomPreprocessor<Bdd>{&graph, Analysis::settings()}();
   LOG(DEBUG2) << "Finished preprocessing in " << DUR(prep_time);
 
   CLOCK(bdd_time);  // BDD based calculation time.
   LOG(DEBUG2) << "Creating BDD for Probability Analysis...";
   bdd_graph_ = new Bdd(&graph, Analysis::settings());
   LOG(DEBUG2) << "BDD is created in " << DUR(bdd_time);
+  bdd_graph_->GatherMetrics(&Analysis::metrics());
 
   Analysis::AddAnalysisTime(DUR(total_time));
 }
@@ -267,27 +338,90 @@ void ProbabilityAnalyzer<Bdd>::CreateBdd(
 double ProbabilityAnalyzer<Bdd>::CalculateProbability(
     const Bdd::VertexPtr& vertex, bool mark,
     const Pdag::IndexMap<double>& p_vars) noexcept {
-  if (vertex->terminal())
-    return 1;
-  Ite& ite = Ite::Ref(vertex);
-  if (ite.mark() == mark)
-    return ite.p();
-  ite.mark(mark);
-  double p_var = 0;
-  if (ite.module()) {
-    const Bdd::Function& res = bdd_graph_->modules().find(ite.index())->second;
-    p_var = CalculateProbability(res.vertex, mark, p_vars);
-    if (res.complement)
-      p_var = 1 - p_var;
-  } else {
-    p_var = p_vars[ite.index()];
+  return CalculateBddProbability(vertex, mark, p_vars, bdd_graph_->modules());
+}
+
+SharedProbabilityAnalyzer::SharedProbabilityAnalyzer(
+    std::vector<const mef::Gate*> targets, const Settings& settings,
+    mef::MissionTime* mission_time)
+    : Analysis(settings),
+      targets_(std::move(targets)),
+      mission_time_(mission_time),
+      current_mark_(false) {}
+
+SharedProbabilityAnalyzer::~SharedProbabilityAnalyzer() noexcept = default;
+
+void SharedProbabilityAnalyzer::Analyze() noexcept {
+  CLOCK(analysis_time);
+  std::vector<GatePtr> root_gates;
+  graph_ = std::make_unique<Pdag>(
+      targets_, Analysis::settings().ccf_analysis(), &root_gates);
+  pdag::TopologicalOrder(graph_.get());
+  bdd_graph_ = std::make_unique<Bdd>(graph_.get(), root_gates,
+                                     Analysis::settings());
+  LOG(DEBUG3) << "The shared BDD is created for " << targets_.size()
+              << " targets";
+  Quantify();
+  Analysis::AddAnalysisTime(DUR(analysis_time));
+}
+
+void SharedProbabilityAnalyzer::Recalculate() noexcept {
+  assert(bdd_graph_ && "The shared BDD is not constructed.");
+  Quantify();
+}
+
+void SharedProbabilityAnalyzer::Quantify() noexcept {
+  p_vars_.clear();
+  p_vars_.reserve(graph_->basic_events().size());
+  for (const mef::BasicEvent* event : graph_->basic_events())
+    p_vars_.push_back(event->p());
+  p_total_ = CalculateProbabilities();
+
+  p_time_.assign(targets_.size(), {});
+  double time_step = Analysis::settings().time_step();
+  if (time_step) {
+    double total_time = mission_time_->value();
+    auto update = [this](double time) {
+      mission_time_->value(time);
+      auto it_p = p_vars_.begin();
+      for (const mef::BasicEvent* event : graph_->basic_events())
+        *it_p++ = event->p();
+      std::vector<double> p_targets = CalculateProbabilities();
+      for (int i = 0; i < p_targets.size(); ++i)
+        p_time_[i].emplace_back(p_targets[i], time);
+    };
+    for (double time = 0; time < total_time; time += time_step)
+      update(time);
+    update(total_time);  // The original mission time is restored.
   }
-  double high = CalculateProbability(ite.high(), mark, p_vars);
-  double low = CalculateProbability(ite.low(), mark, p_vars);
-  if (ite.complement_edge())
-    low = 1 - low;
-  ite.p(p_var * high + (1 - p_var) * low);
-  return ite.p();
+}
+
+std::vector<double> SharedProbabilityAnalyzer::CalculateProbabilities() noexcept {
+  current_mark_ = !current_mark_;  // The targets share the calculations.
+  std::vector<double> p_targets;
+  for (const Bdd::Function& target : bdd_graph_->targets()) {
+    double prob = CalculateProbability(target.vertex, current_mark_, p_vars_);
+    p_targets.push_back(target.complement ? 1 - prob : prob);
+  }
+  return p_targets;
+}
+
+double SharedProbabilityAnalyzer::CalculateProbability(
+    const Bdd::VertexPtr& vertex, bool mark,
+    const Pdag::IndexMap<double>& p_vars) noexcept {
+  assert(bdd_graph_->modules().empty() && "No modules without preprocessing.");
+  return CalculateBddProbability(vertex, mark, p_vars, bdd_graph_->modules());
+}
+
+SharedProbabilityAnalysis::SharedProbabilityAnalysis(
+    std::shared_ptr<const SharedProbabilityAnalyzer> analyzer, int index,
+    mef::MissionTime* mission_time)
+    : ProbabilityAnalysis(analyzer->settings(), mission_time),
+      analyzer_(std::move(analyzer)),
+      index_(index) {
+  assert(index_ >= 0 && index_ < analyzer_->num_targets());
+  Analysis::AddAnalysisTime(analyzer_->analysis_time() /
+                            analyzer_->num_targets());
 }
 
 }  // namespace scram::core
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -67,6 +68,13 @@ class ProbabilityAnalysis : public Analysis {
   ProbabilityAnalysis(const FaultTreeAnalysis* fta,
                       mef::MissionTime* mission_time);
 
+  /// Probability analysis
+  /// without the results of qualitative analysis.
+  ///
+  /// @param[in] settings  The analysis settings.
+  /// @param[in] mission_time  The mission time expression of the model.
+  ProbabilityAnalysis(const Settings& settings, mef::MissionTime* mission_time);
+
   virtual ~ProbabilityAnalysis() = default;
 
   /// Performs quantitative analysis on the supplied fault tree.
@@ -330,4 +338,110 @@ class ProbabilityAnalyzer<Bdd> : public ProbabilityAnalyzerBase {
   bool owner_;  ///< Indication that pointers are handles.
 };
 
+/// Exact probability analysis of multiple targets
+/// with a single PDAG and BDD shared by all the targets.
+/// The common sub-functions of the targets
+/// (e.g., functional events of event tree sequences)
+/// are converted only once,
+/// and the probabilities of all the targets
+/// are calculated in a single traversal of the shared BDD.
+class SharedProbabilityAnalyzer : public Analysis {
+ public:
+  /// @param[in] targets  The target gates to share the analysis.
+  /// @param[in] settings  The analysis settings.
+  /// @param[in] mission_time  The mission time expression of the model.
+  SharedProbabilityAnalyzer(std::vector<const mef::Gate*> targets,
+                            const Settings& settings,
+                            mef::MissionTime* mission_time);
+
+  ~SharedProbabilityAnalyzer() noexcept;
+
+  /// Constructs the shared BDD
+  /// and calculates the probabilities of all the targets.
+  ///
+  /// @pre Analysis is called only once.
+  ///
+  /// @post The mission time expression has its original value.
+  void Analyze() noexcept;
+
+  /// Recalculates the probabilities of all the targets
+  /// with the current probabilities of the basic events
+  /// without reconstruction of the shared BDD.
+  ///
+  /// @pre The analysis is done.
+  /// @pre The structure of the targets (incl. house events) is unchanged.
+  ///
+  /// @post The mission time expression has its original value.
+  void Recalculate() noexcept;
+
+  /// @returns The number of targets.
+  int num_targets() const { return targets_.size(); }
+
+  /// @returns The total probabilities of the targets in the given order.
+  ///
+  /// @pre The analysis is done.
+  const std::vector<double>& p_total() const { return p_total_; }
+
+  /// @returns The probability values of the targets over the mission time.
+  ///          The empty containers imply no calculation has been done.
+  ///
+  /// @pre The analysis is done.
+  const std::vector<std::vector<std::pair<double, double>>>& p_time() const {
+    return p_time_;
+  }
+
+ private:
+  /// Calculates the probabilities of all the targets
+  /// with the current probabilities of the variables.
+  ///
+  /// @returns The probabilities of the targets in the given order.
+  std::vector<double> CalculateProbabilities() noexcept;
+
+  /// Gathers the probabilities of the variables
+  /// and calculates the probabilities of the targets over the mission time.
+  void Quantify() noexcept;
+
+  /// @copydoc ProbabilityAnalyzer<Bdd>::CalculateProbability
+  double CalculateProbability(const Bdd::VertexPtr& vertex, bool mark,
+                              const Pdag::IndexMap<double>& p_vars) noexcept;
+
+  std::vector<const mef::Gate*> targets_;  ///< The target gates.
+  mef::MissionTime* mission_time_;  ///< The mission time expression.
+  std::unique_ptr<Pdag> graph_;  ///< The PDAG shared by the targets.
+  std::unique_ptr<Bdd> bdd_graph_;  ///< The BDD shared by the targets.
+  Pdag::IndexMap<double> p_vars_;  ///< Variable probabilities.
+  bool current_mark_;  ///< To keep track of BDD current mark.
+  std::vector<double> p_total_;  ///< The total probabilities of the targets.
+  /// The probabilities of the targets over time.
+  std::vector<std::vector<std::pair<double, double>>> p_time_;
+};
+
+/// Probability analysis of a single target
+/// with the results of the shared probability analyzer.
+class SharedProbabilityAnalysis : public ProbabilityAnalysis {
+ public:
+  /// @param[in] analyzer  The shared analyzer with the analysis done.
+  /// @param[in] index  The index of the target in the shared analyzer.
+  /// @param[in] mission_time  The mission time expression of the model.
+  ///
+  /// @note The time of the shared analysis
+  ///       is distributed evenly among the targets.
+  SharedProbabilityAnalysis(
+      std::shared_ptr<const SharedProbabilityAnalyzer> analyzer, int index,
+      mef::MissionTime* mission_time);
+
+ private:
+  double CalculateTotalProbability() noexcept final {
+    return analyzer_->p_total()[index_];
+  }
+
+  std::vector<std::pair<double, double>>
+  CalculateProbabilityOverTime() noexcept final {
+    return analyzer_->p_time()[index_];
+  }
+
+  std::shared_ptr<const SharedProbabilityAnalyzer> analyzer_;  ///< The owner.
+  int index_;  ///< The index of the target.
+};
+
 }  // namespace scram::core
@@ -26,6 +26,7 @@
 #include <memory>
 #include <optional>
 #include <string_view>
+#include <vector>
 
 #include <boost/predef.h>
 
@@ -128,9 +129,29 @@ void Project::GatherOptions(const xml::Element& root) {
       } else if (name == "prime-implicants") {
         settings_.prime_implicants(true);
 
+      } else if (name == "shared-sequence-bdd") {
+        settings_.shared_sequence_bdd(true);
+
+      } else if (name == "shared-top-event-bdd") {
+        settings_.shared_top_event_bdd(true);
+
+      } else if (name == "apply-schedule") {
+        settings_.apply_schedule(option_group.attribute("name"));
+
       } else if (name == "approximation") {
         settings_.approximation(option_group.attribute("name"));
 
+      } else if (name == "importance-sampling") {
+        settings_.importance_sampling(true);
+
+      } else if (name == "sensitivity") {
+        std::vector<double> values;
+        for (xml::Element value : option_group.children())
+          values.push_back(value.text<double>());
+        settings_.sensitivity_parameter(
+            std::string(option_group.attribute("parameter")),
+            std::move(values));
+
       } else if (name == "limits") {
         SetLimits(option_group);
       }
@@ -192,6 +213,13 @@ void Project::SetLimits(const xml::Element& limits) {
 
     } else if (name == "seed") {
       settings_.seed(limit.text<int>());
+
+    } else if (name == "bdd-cache-limit") {
+      settings_.bdd_cache_limit(limit.text<int>());
+
+    } else if (name == "preprocessing-budget") {
+      settings_.preprocessing_budget(limit.attribute("pass"),
+                                     limit.text<double>());
     }
   }
 }
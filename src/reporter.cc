@@ -20,10 +20,20 @@
 
 #include "reporter.h"
 
+#include <cmath>
+#include <cstdint>
 #include <ctime>
 
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <boost/algorithm/string/join.hpp>
@@ -36,6 +46,7 @@
 #include "ccf_group.h"
 #include "element.h"
 #include "error.h"
+#include "json_writer.h"
 #include "logger.h"
 #include "parameter.h"
 #include "version.h"
@@ -66,11 +77,167 @@ void PutId(const core::RiskAnalysis::Result::Id& id,
   }
 }
 
+/// Writer of analysis results into the columnar binary container.
+///
+/// The container starts with the file header
+/// followed by 8-byte aligned sections in the host byte order.
+/// Strings are referenced by indices into the string table,
+/// which is the last section of the container.
+/// The layout is documented in the report file documentation.
+class BinaryWriter {
+ public:
+  /// The types of container sections.
+  enum Section : std::uint32_t {
+    kStrings = 1,
+    kProducts,
+    kProbability,
+    kImportance,
+    kUncertainty,
+    kSequences
+  };
+
+  static const std::uint32_t kVersion = 1;  ///< The container format version.
+  static const std::uint32_t kNone = UINT32_MAX;  ///< The null string index.
+
+  /// Writes the container header.
+  ///
+  /// @param[out] out  The destination stream.
+  explicit BinaryWriter(std::FILE* out) : out_(out) {
+    std::fwrite("SCRAMRES", 1, 8, out_);
+    Put(kVersion);
+    Put(std::uint32_t(0x01020304));  // The byte order mark.
+  }
+
+  /// The string table indices of the section target
+  /// (name, initiating event, alignment, phase).
+  using Target = std::array<std::uint32_t, 4>;
+
+  /// @param[in] id  The analysis target.
+  ///
+  /// @returns The section target of the analysis results.
+  Target MakeTarget(const core::RiskAnalysis::Result::Id& id) {
+    Target target = MakeTarget(id.context);
+    if (auto* gate = std::get_if<const mef::Gate*>(&id.target)) {
+      target[0] = Intern((*gate)->id());
+    } else {
+      const auto& sequence = std::get<1>(id.target);
+      target[0] = Intern(sequence.second.name());
+      target[1] = Intern(sequence.first.name());
+    }
+    return target;
+  }
+
+  /// @param[in] context  The optional alignment context of the analysis.
+  ///
+  /// @returns The section target with only the context.
+  Target MakeTarget(const std::optional<core::RiskAnalysis::Context>& context) {
+    if (!context)
+      return {kNone, kNone, kNone, kNone};
+    return {kNone, kNone, Intern(context->alignment.name()),
+            Intern(context->phase.name())};
+  }
+
+  /// Writes the section header.
+  ///
+  /// @param[in] type  The type of the section.
+  /// @param[in] size  The size of the section payload in bytes.
+  /// @param[in] target  The analysis target of the section.
+  void BeginSection(Section type, std::uint64_t size,
+                    const Target& target = {kNone, kNone, kNone, kNone}) {
+    assert(size % 8 == 0 && "Unaligned section payload.");
+    Put(std::uint32_t(type));
+    Put(std::uint32_t(0));  // Reserved.
+    Put(size);
+    for (std::uint32_t index : target)
+      Put(index);
+  }
+
+  /// Writes the string table as the last section.
+  void EndContainer() {
+    std::uint64_t num_bytes = 0;
+    for (const std::string* str : strings_)
+      num_bytes += str->size() + 1;
+    BeginSection(kStrings, 8 + Size<std::uint64_t>(strings_.size() + 1) +
+                               Size<char>(num_bytes));
+    Put<std::uint64_t>(strings_.size());
+    std::uint64_t offset = 0;
+    Put(offset);
+    for (const std::string* str : strings_) {
+      offset += str->size() + 1;
+      Put(offset);
+    }
+    for (const std::string* str : strings_)
+      std::fwrite(str->c_str(), 1, str->size() + 1, out_);
+    Pad(num_bytes);
+  }
+
+  /// @param[in] str  The string to put into the table.
+  ///
+  /// @returns The index of the string in the string table.
+  std::uint32_t Intern(const std::string& str) {
+    auto [it, inserted] = string_index_.try_emplace(str, strings_.size());
+    if (inserted)
+      strings_.push_back(&it->first);
+    return it->second;
+  }
+
+  /// @returns The aligned size in bytes of the array of values.
+  template <typename T>
+  static std::uint64_t Size(std::uint64_t num_values) {
+    return (num_values * sizeof(T) + 7) & ~std::uint64_t(7);
+  }
+
+  /// Writes the value in the host byte order.
+  template <typename T>
+  void Put(T value) {
+    std::fwrite(&value, sizeof(value), 1, out_);
+  }
+
+  /// Writes the values as an aligned array.
+  template <typename T>
+  void Put(const std::vector<T>& values) {
+    std::fwrite(values.data(), sizeof(T), values.size(), out_);
+    Pad(values.size() * sizeof(T));
+  }
+
+ private:
+  /// Pads the written data to the alignment boundary.
+  ///
+  /// @param[in] num_bytes  The number of written bytes.
+  void Pad(std::uint64_t num_bytes) {
+    const char zeros[8] = {};
+    std::fwrite(zeros, 1, Size<char>(num_bytes) - num_bytes, out_);
+  }
+
+  std::FILE* out_;  ///< The destination stream.
+  std::vector<const std::string*> strings_;  ///< The string table.
+  /// The string table indices of the strings.
+  std::unordered_map<std::string, std::uint32_t> string_index_;
+};
+
+/// The analyses of a result with their names in the performance report.
+using AnalysisTable =
+    std::array<std::pair<const char*, const core::Analysis*>, 5>;
+
+/// @param[in] result  The risk analysis result.
+///
+/// @returns The analyses of the result (null if not performed).
+AnalysisTable GetAnalyses(const core::RiskAnalysis::Result& result) {
+  return {{{"products", result.fault_tree_analysis.get()},
+           {"probability", result.probability_analysis.get()},
+           {"importance", result.importance_analysis.get()},
+           {"uncertainty", result.uncertainty_analysis.get()},
+           {"sensitivity", result.sensitivity_analysis.get()}}};
+}
+
 }  // namespace
 
 void Reporter::Report(const core::RiskAnalysis& risk_an, std::FILE* out,
-                      bool indent) {
-  xml::Stream xml_stream(out, indent);
+                      bool indent, Format format) {
+  if (format == Format::kBinary)
+    return ReportBinary(risk_an, out);
+
+  xml::Stream xml_stream(out, indent, format == Format::kXmlGzip);
   xml::StreamElement report = xml_stream.root("report");
   ReportInformation(risk_an, &report);
 
@@ -86,9 +253,17 @@ void Reporter::Report(const core::RiskAnalysis& risk_an, std::FILE* out,
   }
 
   for (const core::RiskAnalysis::Result& result : risk_an.results()) {
-    if (result.fault_tree_analysis)
+    if (result.fault_tree_analysis) {
       ReportResults(result.id, *result.fault_tree_analysis,
                     result.probability_analysis.get(), &results);
+    } else if (result.probability_analysis &&
+               std::holds_alternative<const mef::Gate*>(result.id.target)) {
+      // The shared analysis of top events provides only the probability.
+      xml::StreamElement sum_of_products = results.AddChild("sum-of-products");
+      scram::PutId(result.id, &sum_of_products);
+      sum_of_products.SetAttribute("probability",
+                                   result.probability_analysis->p_total());
+    }
 
     if (result.probability_analysis)
       ReportResults(result.id, *result.probability_analysis, &results);
@@ -98,19 +273,23 @@ void Reporter::Report(const core::RiskAnalysis& risk_an, std::FILE* out,
 
     if (result.uncertainty_analysis)
       ReportResults(result.id, *result.uncertainty_analysis, &results);
+
+    if (result.sensitivity_analysis)
+      ReportResults(result.id, *result.sensitivity_analysis, &results);
   }
 }
 
 void Reporter::Report(const core::RiskAnalysis& risk_an,
-                      const std::string& file, bool indent) {
+                      const std::string& file, bool indent, Format format) {
+  const char* mode = format == Format::kXml ? "w" : "wb";
   std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
-      std::fopen(file.c_str(), "w"), &std::fclose);
+      std::fopen(file.c_str(), mode), &std::fclose);
   try {
     if (!fp) {
       SCRAM_THROW(IOError("Cannot open the output file for report."))
-          << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode("w");
+          << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode(mode);
     }
-    Report(risk_an, fp.get(), indent);
+    Report(risk_an, fp.get(), indent, format);
   } catch (IOError& err) {
     err << boost::errinfo_file_name(file);
     throw;
@@ -118,6 +297,156 @@ void Reporter::Report(const core::RiskAnalysis& risk_an,
 }
 
 /// Describes the fault tree analysis and techniques.
+void Reporter::ReportBinary(const core::RiskAnalysis& risk_an,
+                            std::FILE* out) {
+  assert(!std::ferror(out) && "Unclean error state in output destination.");
+  TIMER(DEBUG1, "Reporting binary analysis results");
+  using Writer = BinaryWriter;
+  Writer writer(out);
+
+  if (risk_an.settings().probability_analysis()) {
+    for (const core::RiskAnalysis::EtaResult& result :
+         risk_an.event_tree_results()) {
+      std::vector<std::uint32_t> names;
+      std::vector<double> values;
+      for (const core::EventTreeAnalysis::Result& sequence :
+           result.event_tree_analysis->sequences()) {
+        names.push_back(writer.Intern(sequence.sequence.name()));
+        values.push_back(sequence.p_sequence);
+      }
+      Writer::Target target = writer.MakeTarget(result.context);
+      target[1] = writer.Intern(result.initiating_event.name());
+      writer.BeginSection(Writer::kSequences,
+                          8 + Writer::Size<std::uint32_t>(names.size()) +
+                              Writer::Size<double>(values.size()),
+                          target);
+      writer.Put<std::uint64_t>(names.size());
+      writer.Put(names);
+      writer.Put(values);
+    }
+  }
+
+  for (const core::RiskAnalysis::Result& result : risk_an.results()) {
+    Writer::Target target = writer.MakeTarget(result.id);
+    if (result.fault_tree_analysis) {
+      const core::ProductContainer& products =
+          result.fault_tree_analysis->products();
+      bool has_p = result.probability_analysis != nullptr;
+      std::unordered_map<const mef::BasicEvent*, std::int32_t> event_index;
+      std::vector<std::uint32_t> events;
+      std::vector<std::uint64_t> offsets = {0};
+      std::vector<std::int32_t> literals;
+      std::vector<double> p_products;
+      for (const core::Product& product : products) {
+        for (const core::Literal& literal : product) {
+          auto [it, inserted] =
+              event_index.try_emplace(&literal.event, events.size() + 1);
+          if (inserted)
+            events.push_back(writer.Intern(literal.event.id()));
+          literals.push_back(literal.complement ? -it->second : it->second);
+        }
+        offsets.push_back(literals.size());
+        if (has_p)
+          p_products.push_back(product.p());
+      }
+      writer.BeginSection(Writer::kProducts,
+                          32 + Writer::Size<std::uint64_t>(offsets.size()) +
+                              Writer::Size<std::int32_t>(literals.size()) +
+                              Writer::Size<std::uint32_t>(events.size()) +
+                              Writer::Size<double>(p_products.size()),
+                          target);
+      writer.Put<std::uint64_t>(products.size());
+      writer.Put<std::uint64_t>(literals.size());
+      writer.Put<std::uint64_t>(events.size());
+      writer.Put<std::uint64_t>(has_p);  // The flags.
+      writer.Put(offsets);
+      writer.Put(literals);
+      writer.Put(events);
+      writer.Put(p_products);
+    }
+
+    if (const auto* prob_analysis = result.probability_analysis.get()) {
+      std::vector<double> time;
+      std::vector<double> values;
+      for (const std::pair<double, double>& p_vs_time :
+           prob_analysis->p_time()) {
+        time.push_back(p_vs_time.second);
+        values.push_back(p_vs_time.first);
+      }
+      writer.BeginSection(Writer::kProbability,
+                          16 + Writer::Size<double>(time.size()) +
+                              Writer::Size<double>(values.size()),
+                          target);
+      writer.Put(prob_analysis->p_total());
+      writer.Put<std::uint64_t>(time.size());
+      writer.Put(time);
+      writer.Put(values);
+    }
+
+    if (const auto* importance_analysis = result.importance_analysis.get()) {
+      const std::vector<core::ImportanceRecord>& records =
+          importance_analysis->importance();
+      std::vector<std::uint32_t> events;
+      std::vector<std::int32_t> occurrence;
+      std::vector<double> columns[6];  // p, MIF, CIF, DIF, RAW, RRW.
+      for (const core::ImportanceRecord& record : records) {
+        const core::ImportanceFactors& factors = record.factors;
+        events.push_back(writer.Intern(record.event.id()));
+        occurrence.push_back(factors.occurrence);
+        columns[0].push_back(record.event.p());
+        columns[1].push_back(factors.mif);
+        columns[2].push_back(factors.cif);
+        columns[3].push_back(factors.dif);
+        columns[4].push_back(factors.raw);
+        columns[5].push_back(factors.rrw);
+      }
+      writer.BeginSection(Writer::kImportance,
+                          8 + Writer::Size<std::uint32_t>(records.size()) +
+                              Writer::Size<std::int32_t>(records.size()) +
+                              6 * Writer::Size<double>(records.size()),
+                          target);
+      writer.Put<std::uint64_t>(records.size());
+      writer.Put(events);
+      writer.Put(occurrence);
+      for (const std::vector<double>& column : columns)
+        writer.Put(column);
+    }
+
+    if (const auto* uncert_analysis = result.uncertainty_analysis.get()) {
+      const std::vector<double>& quantiles = uncert_analysis->quantiles();
+      std::vector<double> bounds;
+      std::vector<double> values;
+      for (const std::pair<double, double>& bin :
+           uncert_analysis->distribution()) {
+        bounds.push_back(bin.first);
+        values.push_back(bin.second);
+      }
+      if (!values.empty())
+        values.pop_back();  // The last bound only closes the last bin.
+      writer.BeginSection(Writer::kUncertainty,
+                          56 + Writer::Size<double>(quantiles.size()) +
+                              Writer::Size<double>(bounds.size()) +
+                              Writer::Size<double>(values.size()),
+                          target);
+      writer.Put(uncert_analysis->mean());
+      writer.Put(uncert_analysis->sigma());
+      writer.Put(uncert_analysis->confidence_interval().first);
+      writer.Put(uncert_analysis->confidence_interval().second);
+      writer.Put(uncert_analysis->error_factor());
+      writer.Put<std::uint64_t>(quantiles.size());
+      writer.Put(quantiles);
+      writer.Put<std::uint64_t>(values.size());
+      writer.Put(bounds);
+      writer.Put(values);
+    }
+  }
+  writer.EndContainer();
+
+  if (int err = std::ferror(out)) {
+    SCRAM_THROW(IOError("FILE error on write")) << boost::errinfo_errno(err);
+  }
+}
+
 template <>
 void Reporter::ReportCalculatedQuantity<core::FaultTreeAnalysis>(
     const core::Settings& settings, xml::StreamElement* information) {
@@ -202,7 +531,9 @@ void Reporter::ReportCalculatedQuantity<core::UncertaintyAnalysis>(
                     "Calculation of uncertainties with the Monte Carlo method");
 
   xml::StreamElement methods = quant.AddChild("calculation-method");
-  methods.SetAttribute("name", "Monte Carlo");
+  methods.SetAttribute("name", settings.importance_sampling()
+                                   ? "Monte Carlo with Importance Sampling"
+                                   : "Monte Carlo");
   xml::StreamElement limits = methods.AddChild("limits");
   limits.AddChild("number-of-trials").AddText(settings.num_trials());
   if (settings.seed() >= 0) {
@@ -210,6 +541,25 @@ void Reporter::ReportCalculatedQuantity<core::UncertaintyAnalysis>(
   }
 }
 
+/// Describes the sensitivity analysis and the parameter grids.
+template <>
+void Reporter::ReportCalculatedQuantity<core::SensitivityAnalysis>(
+    const core::Settings& settings, xml::StreamElement* information) {
+  xml::StreamElement quant = information->AddChild("calculated-quantity");
+  quant.SetAttribute("name", "Sensitivity Analysis")
+      .SetAttribute("definition",
+                    "Re-evaluation of the total probability "
+                    "over grids of parameter values");
+
+  xml::StreamElement methods = quant.AddChild("calculation-method");
+  methods.SetAttribute("name", "One-at-a-time Parameter Sweeps");
+  xml::StreamElement limits = methods.AddChild("limits");
+  int num_points = 0;
+  for (const auto& entry : settings.sensitivity_parameters())
+    num_points += entry.second.size();
+  limits.AddChild("number-of-points").AddText(num_points);
+}
+
 /// Describes all performed analyses deduced from settings.
 template <>
 void Reporter::ReportCalculatedQuantity<core::RiskAnalysis>(
@@ -230,6 +580,9 @@ void Reporter::ReportCalculatedQuantity<core::RiskAnalysis>(
   if (settings.uncertainty_analysis()) {
     ReportCalculatedQuantity<core::UncertaintyAnalysis>(settings, information);
   }
+  if (!settings.sensitivity_parameters().empty()) {
+    ReportCalculatedQuantity<core::SensitivityAnalysis>(settings, information);
+  }
 }
 
 void Reporter::ReportInformation(const core::RiskAnalysis& risk_an,
@@ -322,6 +675,28 @@ void Reporter::ReportPerformance(const core::RiskAnalysis& risk_an,
       calc_time.AddChild("products")
           .AddText(result.fault_tree_analysis->analysis_time());
 
+    if (result.fault_tree_analysis &&
+        !result.fault_tree_analysis->preprocessing().empty()) {
+      xml::StreamElement preprocessing = calc_time.AddChild("preprocessing");
+      for (const core::PassStats& stats :
+           result.fault_tree_analysis->preprocessing()) {
+        xml::StreamElement pass = preprocessing.AddChild("pass");
+        pass.SetAttribute("name", stats.name)
+            .SetAttribute("runs", stats.runs)
+            .SetAttribute("gates-before", stats.before.gates)
+            .SetAttribute("gates-after", stats.after.gates)
+            .SetAttribute("arguments-before", stats.before.args)
+            .SetAttribute("arguments-after", stats.after.args)
+            .SetAttribute("modules-before", stats.before.modules)
+            .SetAttribute("modules-after", stats.after.modules);
+        if (stats.skipped)
+          pass.SetAttribute("skipped", "true");
+        if (stats.aborted)
+          pass.SetAttribute("aborted", "true");
+        pass.AddText(stats.time);
+      }
+    }
+
     if (result.probability_analysis)
       calc_time.AddChild("probability")
           .AddText(result.probability_analysis->analysis_time());
@@ -333,6 +708,103 @@ void Reporter::ReportPerformance(const core::RiskAnalysis& risk_an,
     if (result.uncertainty_analysis)
       calc_time.AddChild("uncertainty")
           .AddText(result.uncertainty_analysis->analysis_time());
+
+    if (result.sensitivity_analysis)
+      calc_time.AddChild("sensitivity")
+          .AddText(result.sensitivity_analysis->analysis_time());
+
+    AnalysisTable analyses = GetAnalyses(result);
+    if (std::none_of(analyses.begin(), analyses.end(), [](const auto& entry) {
+          return entry.second && !entry.second->metrics().empty();
+        })) {
+      continue;
+    }
+    xml::StreamElement metrics = calc_time.AddChild("metrics");
+    for (const auto& [name, analysis] : analyses) {
+      if (!analysis)
+        continue;
+      for (const core::Metric& metric : analysis->metrics()) {
+        metrics.AddChild("metric")
+            .SetAttribute("name", metric.name)
+            .SetAttribute("analysis", name)
+            .AddText(metric.value);
+      }
+    }
+  }
+}
+
+void Reporter::ReportMetrics(const core::RiskAnalysis& risk_an,
+                             std::FILE* out) {
+  assert(!std::ferror(out) && "Unclean error state in output destination.");
+  JsonWriter json(out);
+  json.BeginObject().BeginArray("results");
+  for (const core::RiskAnalysis::Result& result : risk_an.results()) {
+    json.BeginObject();
+    if (auto* gate = std::get_if<const mef::Gate*>(&result.id.target)) {
+      json.Put("name", (*gate)->id());
+    } else {
+      const auto& sequence = std::get<1>(result.id.target);
+      json.Put("name", sequence.second.name());
+      json.Put("initiating-event", sequence.first.name());
+    }
+    if (result.id.context) {
+      json.Put("alignment", result.id.context->alignment.name());
+      json.Put("phase", result.id.context->phase.name());
+    }
+    for (const auto& [name, analysis] : GetAnalyses(result)) {
+      if (!analysis)
+        continue;
+      json.BeginObject(name).Put("time", analysis->analysis_time());
+      if (analysis == result.fault_tree_analysis.get() &&
+          !result.fault_tree_analysis->preprocessing().empty()) {
+        json.BeginArray("preprocessing");
+        for (const core::PassStats& stats :
+             result.fault_tree_analysis->preprocessing()) {
+          json.BeginObject()
+              .Put("name", stats.name)
+              .Put("runs", stats.runs)
+              .Put("time", stats.time)
+              .Put("gates-before", stats.before.gates)
+              .Put("gates-after", stats.after.gates)
+              .Put("arguments-before", stats.before.args)
+              .Put("arguments-after", stats.after.args)
+              .Put("modules-before", stats.before.modules)
+              .Put("modules-after", stats.after.modules);
+          if (stats.skipped)
+            json.Put("skipped", 1);
+          if (stats.aborted)
+            json.Put("aborted", 1);
+          json.End();
+        }
+        json.End();
+      }
+      json.BeginObject("metrics");
+      for (const core::Metric& metric : analysis->metrics())
+        json.Put(metric.name, metric.value);
+      json.End().End();
+    }
+    json.End();
+  }
+  json.End().End();
+  std::fputc('\n', out);
+  std::fflush(out);
+  if (std::ferror(out))
+    SCRAM_THROW(IOError("Failed to write the metrics."));
+}
+
+void Reporter::ReportMetrics(const core::RiskAnalysis& risk_an,
+                             const std::string& file) {
+  std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
+      std::fopen(file.c_str(), "w"), &std::fclose);
+  try {
+    if (!fp) {
+      SCRAM_THROW(IOError("Cannot open the output file for metrics."))
+          << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode("w");
+    }
+    ReportMetrics(risk_an, fp.get());
+  } catch (IOError& err) {
+    err << boost::errinfo_file_name(file);
+    throw;
   }
 }
 
@@ -402,11 +874,8 @@ void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
                     " "));
   }
 
-  double sum = 0;  // Sum of probabilities for contribution calculations.
-  if (prob_analysis) {
-    for (const core::Product& product_set : fta.products())
-      sum += product_set.p();
-  }
+  // Sum of probabilities for contribution calculations.
+  double sum = prob_analysis ? fta.products().p_sum() : 0;
   for (const core::Product& product_set : fta.products()) {
     xml::StreamElement product = sum_of_products.AddChild("product");
     product.SetAttribute("order", product_set.order());
@@ -547,6 +1016,37 @@ void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
   }
 }
 
+void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
+                             const core::SensitivityAnalysis& sens_analysis,
+                             xml::StreamElement* results) {
+  for (const core::SensitivityAnalysis::Curve& curve : sens_analysis.curves()) {
+    xml::StreamElement sensitivity = results->AddChild("sensitivity");
+    scram::PutId(id, &sensitivity);
+    if (!sens_analysis.warnings().empty())
+      sensitivity.SetAttribute("warning", sens_analysis.warnings());
+    sensitivity.SetAttribute("parameter", curve.parameter.id())
+        .SetAttribute("points", curve.points.size());
+    for (const core::SensitivityAnalysis::Point& point : curve.points) {
+      xml::StreamElement element = sensitivity.AddChild("point");
+      element.SetAttribute("value", point.value)
+          .SetAttribute("probability", point.p_total);
+      for (const auto& [record, p_var] : point.importance) {
+        const core::ImportanceFactors& factors = record.factors;
+        auto add_data = [&factors, p_var = p_var](xml::StreamElement* data) {
+          data->SetAttribute("occurrence", factors.occurrence)
+              .SetAttribute("probability", p_var)
+              .SetAttribute("MIF", factors.mif)
+              .SetAttribute("CIF", factors.cif)
+              .SetAttribute("DIF", factors.dif)
+              .SetAttribute("RAW", factors.raw)
+              .SetAttribute("RRW", factors.rrw);
+        };
+        ReportBasicEvent(record.event, &element, add_data);
+      }
+    }
+  }
+}
+
 void Reporter::ReportLiteral(const core::Literal& literal,
                              xml::StreamElement* parent) {
   auto add_data = [](xml::StreamElement* /*element*/) {};
@@ -573,7 +1073,7 @@ void Reporter::ReportBasicEvent(const mef::BasicEvent& basic_event,
         .SetAttribute("order", ccf_event->members().size())
         .SetAttribute("group-size", ccf_group.members().size());
     add_data(&element);
-    for (const mef::Gate* member : ccf_event->members()) {
+    for (const mef::BasicEvent* member : ccf_event->members()) {
       element.AddChild("basic-event").SetAttribute("name", member->name());
     }
   }
@@ -30,6 +30,7 @@
 #include "model.h"
 #include "probability_analysis.h"
 #include "risk_analysis.h"
+#include "sensitivity_analysis.h"
 #include "settings.h"
 #include "uncertainty_analysis.h"
 #include "xml_stream.h"
@@ -39,19 +40,27 @@ namespace scram {
 /// Facilities to report analysis results.
 class Reporter {
  public:
+  /// The formats of the report output.
+  enum class Format {
+    kXml,  ///< The XML document conforming to the report schema.
+    kXmlGzip,  ///< The XML document compressed with gzip.
+    kBinary  ///< The columnar binary container of analysis results.
+  };
+
   /// Reports the results of risk analysis on a model.
   /// The XML report is formed as a single document.
   ///
   /// @param[in] risk_an  Risk analysis with results.
   /// @param[out] out  The report destination stream.
   /// @param[in] indent  The flag to indent output for readability.
+  /// @param[in] format  The output format of the report.
   ///
   /// @pre The output destination is used only by this reporter.
   ///      There is going to be no appending to the stream after the report.
   ///
   /// @throws IOError  The write operation has failed.
   void Report(const core::RiskAnalysis& risk_an, std::FILE* out,
-              bool indent = true);
+              bool indent = true, Format format = Format::kXml);
 
   /// A convenience function to generate the report into a file.
   /// This function overwrites the file.
@@ -59,13 +68,45 @@ class Reporter {
   /// @param[in] risk_an  Risk analysis with results.
   /// @param[out] file  The output destination.
   /// @param[in] indent  The flag to indent output for readability.
+  /// @param[in] format  The output format of the report.
   ///
   /// @throws IOError  The output file is not accessible,
   ///                  or the write operation has failed.
   void Report(const core::RiskAnalysis& risk_an, const std::string& file,
-              bool indent = true);
+              bool indent = true, Format format = Format::kXml);
+
+  /// Writes the performance metrics of analyses as a JSON document
+  /// for automated monitoring of analysis runs.
+  /// The document contains the analysis times, preprocessing passes,
+  /// and metrics of each analysis target.
+  ///
+  /// @param[in] risk_an  Risk analysis with results.
+  /// @param[out] out  The destination stream.
+  ///
+  /// @throws IOError  The write operation has failed.
+  void ReportMetrics(const core::RiskAnalysis& risk_an, std::FILE* out);
+
+  /// A convenience function to write the metrics into a file.
+  /// This function overwrites the file.
+  ///
+  /// @param[in] risk_an  Risk analysis with results.
+  /// @param[out] file  The output destination.
+  ///
+  /// @throws IOError  The output file is not accessible,
+  ///                  or the write operation has failed.
+  void ReportMetrics(const core::RiskAnalysis& risk_an,
+                     const std::string& file);
 
  private:
+  /// Writes the analysis results into the columnar binary container.
+  /// The informational part of the XML report is not included.
+  ///
+  /// @param[in] risk_an  Risk analysis with results.
+  /// @param[out] out  The report destination stream.
+  ///
+  /// @throws IOError  The write operation has failed.
+  void ReportBinary(const core::RiskAnalysis& risk_an, std::FILE* out);
+
   /// This function populates information
   /// about the software, settings, time, methods, model, etc.
   ///
@@ -168,6 +209,15 @@ class Reporter {
                      const core::UncertaintyAnalysis& uncert_analysis,
                      xml::StreamElement* results);
 
+  /// Reports the results of sensitivity analysis.
+  ///
+  /// @param[in] id  The analysis id.
+  /// @param[in] sens_analysis  Sensitivity analysis with results.
+  /// @param[in,out] results  XML element to for all results.
+  void ReportResults(const core::RiskAnalysis::Result::Id& id,
+                     const core::SensitivityAnalysis& sens_analysis,
+                     xml::StreamElement* results);
+
   /// Reports literal in products.
   ///
   /// @param[in] literal  A literal to be reported.
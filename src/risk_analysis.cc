@@ -31,7 +31,10 @@
 namespace scram::core {
 
 RiskAnalysis::RiskAnalysis(mef::Model* model, const Settings& settings)
-    : Analysis(settings), model_(model) {}
+    : Analysis(settings), model_(model) {
+  for (const auto& [id, values] : settings.sensitivity_parameters())
+    sensitivity_parameters_.push_back(&model->Get<mef::Parameter>(id));
+}
 
 void RiskAnalysis::Analyze() noexcept {
   assert(results_.empty() && "Rerunning the analysis.");
@@ -88,21 +91,30 @@ void RiskAnalysis::RunAnalysis(std::optional<Context> context) noexcept {
       auto eta = std::make_unique<EventTreeAnalysis>(
           initiating_event, Analysis::settings(), model_->context());
       eta->Analyze();
-      for (EventTreeAnalysis::Result& result : eta->sequences()) {
-        const mef::Sequence& sequence = result.sequence;
-        LOG(INFO) << "Running analysis for sequence: " << sequence.name();
-        results_.push_back(
-            {{std::pair<const mef::InitiatingEvent&, const mef::Sequence&>{
-                  initiating_event, sequence},
-              context}});
-        RunAnalysis(*result.gate, &results_.back());
-        if (result.is_expression_only) {
-          results_.back().fault_tree_analysis = nullptr;
-          results_.back().importance_analysis = nullptr;
+      bool shared = Analysis::settings().shared_sequence_bdd() &&
+                    Analysis::settings().probability_analysis() &&
+                    !Analysis::settings().importance_analysis() &&
+                    !Analysis::settings().uncertainty_analysis() &&
+                    sensitivity_parameters_.empty();
+      if (shared) {
+        RunSharedAnalysis(initiating_event, eta.get(), context);
+      } else {
+        for (EventTreeAnalysis::Result& result : eta->sequences()) {
+          const mef::Sequence& sequence = result.sequence;
+          LOG(INFO) << "Running analysis for sequence: " << sequence.name();
+          results_.push_back(
+              {{std::pair<const mef::InitiatingEvent&, const mef::Sequence&>{
+                    initiating_event, sequence},
+                context}});
+          RunAnalysis(*result.gate, &results_.back());
+          if (result.is_expression_only) {
+            results_.back().fault_tree_analysis = nullptr;
+            results_.back().importance_analysis = nullptr;
+          }
+          if (Analysis::settings().probability_analysis())
+            result.p_sequence = results_.back().probability_analysis->p_total();
+          LOG(INFO) << "Finished analysis for sequence: " << sequence.name();
         }
-        if (Analysis::settings().probability_analysis())
-          result.p_sequence = results_.back().probability_analysis->p_total();
-        LOG(INFO) << "Finished analysis for sequence: " << sequence.name();
       }
       event_tree_results_.push_back(
           {initiating_event, context, std::move(eta)});
@@ -110,6 +122,16 @@ void RiskAnalysis::RunAnalysis(std::optional<Context> context) noexcept {
     }
   }
 
+  bool shared = Analysis::settings().shared_top_event_bdd() &&
+                Analysis::settings().probability_analysis() &&
+                !Analysis::settings().importance_analysis() &&
+                !Analysis::settings().uncertainty_analysis() &&
+                sensitivity_parameters_.empty();
+  if (shared) {
+    RunSharedAnalysis(context);
+    return;
+  }
+
   for (const mef::FaultTree& ft : model_->fault_trees()) {
     for (const mef::Gate* target : ft.top_events()) {
       LOG(INFO) << "Running analysis for gate: " << target->id();
@@ -120,6 +142,59 @@ void RiskAnalysis::RunAnalysis(std::optional<Context> context) noexcept {
   }
 }
 
+void RiskAnalysis::RunSharedAnalysis(
+    const mef::InitiatingEvent& initiating_event, EventTreeAnalysis* eta,
+    const std::optional<Context>& context) noexcept {
+  LOG(INFO) << "Running shared analysis for sequences of: "
+            << initiating_event.name();
+  std::vector<const mef::Gate*> targets;
+  for (const EventTreeAnalysis::Result& result : eta->sequences())
+    targets.push_back(result.gate.get());
+  auto analyzer = std::make_shared<SharedProbabilityAnalyzer>(
+      std::move(targets), Analysis::settings(), &model_->mission_time());
+  analyzer->Analyze();
+
+  int index = 0;
+  for (EventTreeAnalysis::Result& result : eta->sequences()) {
+    results_.push_back(
+        {{std::pair<const mef::InitiatingEvent&, const mef::Sequence&>{
+              initiating_event, result.sequence},
+          context}});
+    auto pa = std::make_unique<SharedProbabilityAnalysis>(
+        analyzer, index++, &model_->mission_time());
+    pa->Analyze();
+    result.p_sequence = pa->p_total();
+    results_.back().probability_analysis = std::move(pa);
+  }
+  LOG(INFO) << "Finished shared analysis for sequences of: "
+            << initiating_event.name();
+}
+
+void RiskAnalysis::RunSharedAnalysis(
+    const std::optional<Context>& context) noexcept {
+  std::vector<const mef::Gate*> targets;
+  for (const mef::FaultTree& ft : model_->fault_trees()) {
+    for (const mef::Gate* target : ft.top_events())
+      targets.push_back(target);
+  }
+  if (targets.empty())
+    return;
+  LOG(INFO) << "Running shared analysis for " << targets.size()
+            << " top events";
+  auto analyzer = std::make_shared<SharedProbabilityAnalyzer>(
+      targets, Analysis::settings(), &model_->mission_time());
+  analyzer->Analyze();
+
+  for (int i = 0; i < analyzer->num_targets(); ++i) {
+    results_.push_back({{targets[i], context}});
+    auto pa = std::make_unique<SharedProbabilityAnalysis>(
+        analyzer, i, &model_->mission_time());
+    pa->Analyze();
+    results_.back().probability_analysis = std::move(pa);
+  }
+  LOG(INFO) << "Finished shared analysis for top events";
+}
+
 void RiskAnalysis::RunAnalysis(const mef::Gate& target,
                                Result* result) noexcept {
   switch (Analysis::settings().algorithm()) {
@@ -169,6 +244,12 @@ void RiskAnalysis::RunAnalysis(FaultTreeAnalyzer<Algorithm>* fta,
     ua->Analyze();
     result->uncertainty_analysis = std::move(ua);
   }
+  if (!sensitivity_parameters_.empty()) {
+    auto sa = std::make_unique<SensitivityAnalyzer<Calculator>>(
+        pa.get(), sensitivity_parameters_);
+    sa->Analyze();
+    result->sensitivity_analysis = std::move(sa);
+  }
   result->probability_analysis = std::move(pa);
 }
 
@@ -33,7 +33,9 @@
 #include "fault_tree_analysis.h"
 #include "importance_analysis.h"
 #include "model.h"
+#include "parameter.h"
 #include "probability_analysis.h"
+#include "sensitivity_analysis.h"
 #include "settings.h"
 #include "uncertainty_analysis.h"
 
@@ -66,6 +68,7 @@ class RiskAnalysis : public Analysis {
     std::unique_ptr<const ProbabilityAnalysis> probability_analysis;
     std::unique_ptr<const ImportanceAnalysis> importance_analysis;
     std::unique_ptr<const UncertaintyAnalysis> uncertainty_analysis;
+    std::unique_ptr<const SensitivityAnalysis> sensitivity_analysis;
     /// @}
   };
 
@@ -82,6 +85,8 @@ class RiskAnalysis : public Analysis {
   /// @param[in] model  An analysis model with fault trees, events, etc.
   /// @param[in] settings  Analysis settings for the given model.
   ///
+  /// @throws UndefinedElement  The sensitivity parameter is not in the model.
+  ///
   /// @note The model is not const
   ///       because mission time and event-tree walk context are manipulated.
   ///       However, at the end of analysis, everything is reset.
@@ -120,6 +125,22 @@ class RiskAnalysis : public Analysis {
   /// @post The model is restored to the original state.
   void RunAnalysis(std::optional<Context> context = {}) noexcept;
 
+  /// Runs the analysis of all sequences of an event tree
+  /// with a single BDD shared by the sequences.
+  ///
+  /// @param[in] initiating_event  The initiating event of the event tree.
+  /// @param[in,out] eta  The event tree analysis with collected sequences.
+  /// @param[in] context  The optional analysis context.
+  void RunSharedAnalysis(const mef::InitiatingEvent& initiating_event,
+                         EventTreeAnalysis* eta,
+                         const std::optional<Context>& context) noexcept;
+
+  /// Runs the probability analysis of all top events of the fault trees
+  /// with a single BDD shared by the top events.
+  ///
+  /// @param[in] context  The optional analysis context.
+  void RunSharedAnalysis(const std::optional<Context>& context) noexcept;
+
   /// Runs all possible analysis on a given target.
   /// Analysis types are deduced from the settings.
   ///
@@ -151,6 +172,8 @@ class RiskAnalysis : public Analysis {
   void RunAnalysis(FaultTreeAnalyzer<Algorithm>* fta, Result* result) noexcept;
 
   mef::Model* model_;  ///< The model with constructs.
+  /// The parameters in the order of the sensitivity settings.
+  std::vector<mef::Parameter*> sensitivity_parameters_;
   std::vector<Result> results_;  ///< The analysis result storage.
   std::vector<EtaResult> event_tree_results_;  ///< Grouping of sequences.
 };
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the resident re-quantification of models.
+
+#include "risk_monitor.h"
+
+#include <string>
+
+#include "error.h"
+#include "expression/constant.h"
+#include "fault_tree.h"
+#include "logger.h"
+
+namespace scram::core {
+
+namespace {
+
+/// Gathers the house events in the formulas of the gate and its descendants.
+///
+/// @param[in] gate  The root gate to start the traversal.
+/// @param[in,out] gates  The visited gates.
+/// @param[in,out] house_events  The collected house events.
+void GatherHouseEvents(
+    const mef::Gate& gate, std::unordered_set<const mef::Gate*>* gates,
+    std::unordered_set<const mef::HouseEvent*>* house_events) noexcept {
+  if (!gates->insert(&gate).second)
+    return;
+  for (const mef::Formula::Arg& arg : gate.formula().args()) {
+    if (auto* house_event = std::get_if<mef::HouseEvent*>(&arg.event)) {
+      house_events->insert(*house_event);
+    } else if (auto* arg_gate = std::get_if<mef::Gate*>(&arg.event)) {
+      GatherHouseEvents(**arg_gate, gates, house_events);
+    }
+  }
+}
+
+}  // namespace
+
+RiskMonitor::RiskMonitor(mef::Model* model, const Settings& settings)
+    : Analysis(settings), model_(model) {}
+
+RiskMonitor::~RiskMonitor() noexcept = default;
+
+void RiskMonitor::Analyze() noexcept {
+  assert(groups_.empty() && "Rerunning the analysis.");
+  CLOCK(analysis_time);
+  auto add_group = [this](std::vector<const mef::Gate*> gates,
+                          std::unique_ptr<EventTreeAnalysis> eta = {}) {
+    int offset = targets_.size() - gates.size();
+    Group group{std::move(eta), std::move(gates), {}, nullptr, offset, false};
+    std::unordered_set<const mef::Gate*> visited;
+    for (const mef::Gate* gate : group.gates)
+      GatherHouseEvents(*gate, &visited, &group.house_events);
+    Build(&group);
+    groups_.push_back(std::move(group));
+  };
+
+  for (const mef::InitiatingEvent& initiating_event :
+       model_->initiating_events()) {
+    if (!initiating_event.event_tree())
+      continue;
+    auto eta = std::make_unique<EventTreeAnalysis>(
+        initiating_event, Analysis::settings(), model_->context());
+    eta->Analyze();
+    std::vector<const mef::Gate*> gates;
+    for (const EventTreeAnalysis::Result& result : eta->sequences()) {
+      targets_.push_back(
+          {std::pair(&initiating_event, &result.sequence), 0});
+      gates.push_back(result.gate.get());
+    }
+    add_group(std::move(gates), std::move(eta));
+  }
+
+  std::vector<const mef::Gate*> top_events;
+  for (const mef::FaultTree& ft : model_->fault_trees()) {
+    for (const mef::Gate* target : ft.top_events()) {
+      targets_.push_back({target, 0});
+      if (Analysis::settings().shared_top_event_bdd()) {
+        top_events.push_back(target);
+      } else {
+        add_group({target});
+      }
+    }
+  }
+  if (!top_events.empty())
+    add_group(std::move(top_events));
+
+  Update();
+  LOG(DEBUG2) << "The monitor is ready for " << targets_.size()
+              << " targets in " << DUR(analysis_time);
+  Analysis::AddAnalysisTime(DUR(analysis_time));
+}
+
+void RiskMonitor::SetProbability(std::string_view id, double value) {
+  mef::BasicEvent& basic_event = model_->Get<mef::BasicEvent>(id);
+  auto expression = std::make_unique<mef::ConstantExpression>(value);
+  try {
+    mef::EnsureProbability(expression.get());
+  } catch (mef::DomainError& err) {
+    err << mef::errinfo_element(basic_event.id(),
+                                mef::BasicEvent::kTypeString);
+    throw;
+  }
+  basic_event.expression(expression.get());
+  model_->Add(std::move(expression));
+  probabilities_changed_ = true;
+}
+
+void RiskMonitor::SetHouseEvent(std::string_view id, bool state) {
+  mef::HouseEvent& house_event = model_->Get<mef::HouseEvent>(id);
+  if (house_event.state() == state)
+    return;
+  house_event.state(state);
+  for (Group& group : groups_) {
+    if (group.house_events.count(&house_event))
+      group.dirty = true;
+  }
+}
+
+int RiskMonitor::Update() noexcept {
+  int num_rebuilt = 0;
+  for (Group& group : groups_) {
+    if (group.dirty) {
+      Build(&group);
+      ++num_rebuilt;
+    } else if (probabilities_changed_) {
+      group.analyzer->Recalculate();
+    }
+    const std::vector<double>& p_total = group.analyzer->p_total();
+    for (int i = 0; i < p_total.size(); ++i)
+      targets_[group.offset + i].p_total = p_total[i];
+  }
+  probabilities_changed_ = false;
+  return num_rebuilt;
+}
+
+void RiskMonitor::Build(Group* group) noexcept {
+  group->analyzer = std::make_unique<SharedProbabilityAnalyzer>(
+      group->gates, Analysis::settings(), &model_->mission_time());
+  group->analyzer->Analyze();
+  group->dirty = false;
+}
+
+}  // namespace scram::core
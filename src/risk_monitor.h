@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Resident probability analysis for repeated re-quantification.
+
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "analysis.h"
+#include "event.h"
+#include "event_tree_analysis.h"
+#include "model.h"
+#include "probability_analysis.h"
+#include "settings.h"
+
+namespace scram::core {
+
+/// Exact probability analysis of all the model targets
+/// (top events of fault trees and sequences of event trees)
+/// with the PDAGs and BDDs kept resident between changes of event data.
+///
+/// Changes in basic-event probabilities only re-evaluate the BDDs.
+/// Changes in house-event states rebuild only the BDDs
+/// of the targets depending on the changed house events.
+///
+/// @note The analysis is done without alignment phases.
+class RiskMonitor : public Analysis {
+ public:
+  /// The analysis target with its current probability.
+  struct Target {
+    /// The top event or the initiating event with its sequence.
+    std::variant<const mef::Gate*,
+                 std::pair<const mef::InitiatingEvent*, const mef::Sequence*>>
+        id;
+    double p_total;  ///< The current probability of the target.
+  };
+
+  /// @param[in] model  A fully initialized model with probabilities.
+  /// @param[in] settings  Analysis settings for the model.
+  ///
+  /// @note The model is changed by the monitor requests.
+  RiskMonitor(mef::Model* model, const Settings& settings);
+
+  ~RiskMonitor() noexcept;
+
+  /// Constructs the BDDs of the targets
+  /// and calculates their probabilities.
+  ///
+  /// @pre The analysis is performed only once.
+  void Analyze() noexcept;
+
+  /// Sets a constant probability for a basic event.
+  ///
+  /// @param[in] id  The full id of the basic event.
+  /// @param[in] value  The new probability of the basic event.
+  ///
+  /// @throws UndefinedElement  The basic event is not in the model.
+  /// @throws DomainError  The value is not a probability.
+  ///
+  /// @post The results are updated only on the next request.
+  void SetProbability(std::string_view id, double value);
+
+  /// Sets the state of a house event.
+  ///
+  /// @param[in] id  The full id of the house event.
+  /// @param[in] state  The new state of the house event.
+  ///
+  /// @throws UndefinedElement  The house event is not in the model.
+  ///
+  /// @post The results are updated only on the next request.
+  void SetHouseEvent(std::string_view id, bool state);
+
+  /// Brings the probabilities of the targets up to date
+  /// with the changes since the last update.
+  ///
+  /// @returns The number of BDDs rebuilt for house-event changes.
+  ///
+  /// @pre The analysis is done.
+  int Update() noexcept;
+
+  /// @returns The targets with their probabilities as of the last update.
+  const std::vector<Target>& targets() const { return targets_; }
+
+ private:
+  /// The targets analyzed with a single shared BDD.
+  struct Group {
+    /// The holder of the sequence gates if any.
+    std::unique_ptr<EventTreeAnalysis> event_tree_analysis;
+    std::vector<const mef::Gate*> gates;  ///< The target gates.
+    /// The house events in the structure of the target gates.
+    std::unordered_set<const mef::HouseEvent*> house_events;
+    std::unique_ptr<SharedProbabilityAnalyzer> analyzer;  ///< The BDD holder.
+    int offset;  ///< The position of the first group target in the targets.
+    bool dirty;  ///< The structure has changed since the BDD construction.
+  };
+
+  /// Constructs the shared BDD of the group.
+  ///
+  /// @param[in,out] group  The group with the target gates.
+  void Build(Group* group) noexcept;
+
+  mef::Model* model_;  ///< The model under analysis.
+  std::vector<Group> groups_;  ///< The groups of targets.
+  std::vector<Target> targets_;  ///< The targets in the order of the groups.
+  bool probabilities_changed_ = false;  ///< Pending re-evaluation.
+};
+
+}  // namespace scram::core
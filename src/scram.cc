@@ -24,12 +24,17 @@
 
 #include <iostream>
 #include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <boost/core/typeinfo.hpp>
 #include <boost/exception/all.hpp>
 #include <boost/program_options.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
 #include <boost/version.hpp>
 
 #include <libxml/parser.h>  // xmlInitParser, xmlCleanupParser
@@ -39,10 +44,12 @@
 #include "error.h"
 #include "ext/scope_guard.h"
 #include "initializer.h"
+#include "json_writer.h"
 #include "logger.h"
 #include "project.h"
 #include "reporter.h"
 #include "risk_analysis.h"
+#include "risk_monitor.h"
 #include "serialization.h"
 #include "settings.h"
 #include "version.h"
@@ -57,6 +64,7 @@ namespace {
 /// @returns Command-line option descriptions.
 po::options_description ConstructOptions() {
   using path = std::string;  // To print argument type as path.
+  using format = std::string;
 
   po::options_description desc("Options");
   // clang-format off
@@ -66,13 +74,37 @@ po::options_description ConstructOptions() {
       ("project", OPT_VALUE(path), "Project file with analysis configurations")
       ("allow-extern", "**UNSAFE** Allow external libraries")
       ("validate", "Validate input files without analysis")
+      ("monitor",
+       "Serve JSON re-quantification requests on standard input/output")
+      ("model-cache", OPT_VALUE(path),
+       "Directory for binary snapshots of initialized models")
+      ("pdag-cache", OPT_VALUE(path),
+       "Directory for snapshots of preprocessed fault trees")
+      ("preprocessing-budget",
+       po::value<std::vector<std::string>>()->composing()->value_name(
+           "pass=seconds"),
+       "Time budget for an optional preprocessing pass")
       ("bdd", "Perform qualitative analysis with BDD")
       ("zbdd", "Perform qualitative analysis with ZBDD")
       ("mocus", "Perform qualitative analysis with MOCUS")
       ("prime-implicants", "Calculate prime implicants")
+      ("shared-sequence-bdd",
+       "Quantify event tree sequences with a single shared BDD")
+      ("shared-top-event-bdd",
+       "Quantify fault tree top events with a single shared BDD")
+      ("apply-schedule", OPT_VALUE(std::string),
+       "BDD gate argument combination: sequential, smallest-first, balanced")
+      ("bdd-cache-limit", OPT_VALUE(int),
+       "BDD computed-table entries reused across gates (0 to clear)")
       ("probability", "Perform probability analysis")
       ("importance", "Perform importance analysis")
       ("uncertainty", "Perform uncertainty analysis")
+      ("importance-sampling",
+       "Use importance sampling in uncertainty analysis")
+      ("sensitivity",
+       po::value<std::vector<std::string>>()->composing()->value_name(
+           "parameter=v1,v2,..."),
+       "Sweep a parameter over values in probability analysis")
       ("ccf", "Perform common-cause failure analysis")
       ("sil", "Compute the Safety Integrity Level metrics")
       ("rare-event", "Use the rare event approximation")
@@ -89,7 +121,10 @@ po::options_description ConstructOptions() {
       ("num-bins", OPT_VALUE(int), "Number of bins for histograms")
       ("seed", OPT_VALUE(int), "Seed for the pseudo-random number generator")
       ("output,o", OPT_VALUE(path), "Output file for reports")
+      ("metrics", OPT_VALUE(path), "Output JSON file for performance metrics")
       ("no-indent", "Omit indentation whitespace in output XML")
+      ("output-format", OPT_VALUE(format),
+       "Report format: xml, xml.gz (compressed), binary (columnar)")
       ("verbosity", OPT_VALUE(int), "Set log verbosity");
 #ifndef NDEBUG
   po::options_description debug("Debug Options");
@@ -180,6 +215,14 @@ int ParseArguments(int argc, char* argv[], po::variables_map* vm) {
     print_help(std::cerr);
     return 1;
   }
+  if (vm->count("output-format")) {
+    std::string format = (*vm)["output-format"].as<std::string>();
+    if (format != "xml" && format != "xml.gz" && format != "binary") {
+      std::cerr << "Unknown report output format: " << format << "\n\n";
+      print_help(std::cerr);
+      return 1;
+    }
+  }
   return 0;
 }
 
@@ -209,6 +252,10 @@ void ConstructSettings(const po::variables_map& vm,
     settings->algorithm(scram::core::Algorithm::kMocus);
   }
   settings->prime_implicants(vm.count("prime-implicants"));
+  settings->shared_sequence_bdd(vm.count("shared-sequence-bdd"));
+  settings->shared_top_event_bdd(vm.count("shared-top-event-bdd"));
+  SET("apply-schedule", std::string, apply_schedule);
+  SET("bdd-cache-limit", int, bdd_cache_limit);
   // Determine if the probability approximation is requested.
   if (vm.count("rare-event")) {
     assert(!vm.count("mcub"));
@@ -222,6 +269,7 @@ void ConstructSettings(const po::variables_map& vm,
   settings->probability_analysis(vm.count("probability"));
   settings->importance_analysis(vm.count("importance"));
   settings->uncertainty_analysis(vm.count("uncertainty"));
+  settings->importance_sampling(vm.count("importance-sampling"));
   settings->ccf_analysis(vm.count("ccf"));
   SET("seed", int, seed);
   SET("limit-order", int, limit_order);
@@ -230,6 +278,55 @@ void ConstructSettings(const po::variables_map& vm,
   SET("num-trials", int, num_trials);
   SET("num-quantiles", int, num_quantiles);
   SET("num-bins", int, num_bins);
+  SET("pdag-cache", std::string, pdag_cache);
+  if (vm.count("preprocessing-budget")) {
+    for (const std::string& budget :
+         vm["preprocessing-budget"].as<std::vector<std::string>>()) {
+      auto pos = budget.find('=');
+      double seconds = 0;
+      bool valid = false;
+      if (pos != std::string::npos) {
+        try {
+          std::size_t end = 0;
+          seconds = std::stod(budget.substr(pos + 1), &end);
+          valid = pos + 1 + end == budget.size();
+        } catch (const std::logic_error&) {  // Invalid or out of range.
+        }
+      }
+      if (!valid) {
+        SCRAM_THROW(scram::SettingsError(
+            "The preprocessing budget must be in pass=seconds format."))
+            << scram::errinfo_value(budget);
+      }
+      settings->preprocessing_budget(std::string_view(budget).substr(0, pos),
+                                     seconds);
+    }
+  }
+  if (vm.count("sensitivity")) {
+    for (const std::string& sweep :
+         vm["sensitivity"].as<std::vector<std::string>>()) {
+      auto pos = sweep.find('=');
+      std::vector<double> values;
+      bool valid = pos != std::string::npos && pos != 0;
+      while (valid && pos != sweep.size()) {
+        try {
+          std::size_t end = 0;
+          values.push_back(std::stod(sweep.substr(pos + 1), &end));
+          pos += 1 + end;
+          valid = pos == sweep.size() || sweep[pos] == ',';
+        } catch (const std::logic_error&) {  // Invalid or out of range.
+          valid = false;
+        }
+      }
+      if (!valid || values.empty()) {
+        SCRAM_THROW(scram::SettingsError(
+            "The sensitivity must be in parameter=v1,v2,... format."))
+            << scram::errinfo_value(sweep);
+      }
+      settings->sensitivity_parameter(sweep.substr(0, sweep.find('=')),
+                                      std::move(values));
+    }
+  }
 #ifndef NDEBUG
   settings->preprocessor = vm.count("preprocessor");
   settings->print = vm.count("print");
@@ -237,6 +334,88 @@ void ConstructSettings(const po::variables_map& vm,
 }
 #undef SET
 
+/// Serves re-quantification requests with the model analysis kept resident
+/// until the end of the input or the quit request.
+///
+/// The requests and responses are JSON objects, one per line:
+/// {"command": "set-probability", "event": "id", "value": 0.1},
+/// {"command": "set-house-event", "event": "id", "value": true},
+/// {"command": "recompute"}, and {"command": "quit"}.
+/// Invalid requests get error responses without stopping the service.
+///
+/// @param[in,out] model  The initialized model to be changed by requests.
+/// @param[in] settings  The analysis settings.
+void RunMonitor(scram::mef::Model* model,
+                const scram::core::Settings& settings) {
+  namespace pt = boost::property_tree;
+  scram::core::RiskMonitor monitor(model, settings);
+  monitor.Analyze();
+
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+    scram::JsonWriter json(stdout);
+    json.BeginObject();
+    bool quit = false;
+    try {
+      pt::ptree request;
+      std::istringstream stream(line);
+      pt::read_json(stream, request);
+      std::string command = request.get<std::string>("command");
+      if (command == "set-probability") {
+        monitor.SetProbability(request.get<std::string>("event"),
+                               request.get<double>("value"));
+        json.Put("status", "ok");
+      } else if (command == "set-house-event") {
+        monitor.SetHouseEvent(request.get<std::string>("event"),
+                              request.get<bool>("value"));
+        json.Put("status", "ok");
+      } else if (command == "recompute") {
+        CLOCK(update_time);
+        int num_rebuilt = monitor.Update();
+        json.Put("status", "ok")
+            .Put("rebuilt", num_rebuilt)
+            .Put("time", DUR(update_time))
+            .BeginArray("results");
+        for (const auto& target : monitor.targets()) {
+          json.BeginObject();
+          if (const auto* gate = std::get_if<const scram::mef::Gate*>(
+                  &target.id)) {
+            json.Put("name", (*gate)->id());
+          } else {
+            const auto& sequence = std::get<1>(target.id);
+            json.Put("name", sequence.second->name())
+                .Put("initiating-event", sequence.first->name());
+          }
+          json.Put("probability", target.p_total).End();
+        }
+        json.End();
+      } else if (command == "quit") {
+        json.Put("status", "ok");
+        quit = true;
+      } else {
+        json.Put("status", "error")
+            .Put("message", "Unknown command: " + command);
+      }
+    } catch (const pt::ptree_error& err) {
+      json.Put("status", "error").Put("message", err.what());
+    } catch (const scram::Error& err) {
+      std::string message = err.what();
+      if (const auto* id =
+              boost::get_error_info<scram::mef::errinfo_element_id>(err)) {
+        message += ": " + *id;
+      }
+      json.Put("status", "error").Put("message", message);
+    }
+    json.End();
+    std::fputc('\n', stdout);
+    std::fflush(stdout);
+    if (quit)
+      return;
+  }
+}
+
 /// Main body of command-line entrance to run the program.
 ///
 /// @param[in] vm  Variables map of program options.
@@ -264,8 +443,12 @@ void RunScram(const po::variables_map& vm) {
   // Process input files
   // into valid analysis containers and constructs.
   // Throws if anything is invalid.
+  std::string model_cache;
+  if (vm.count("model-cache"))
+    model_cache = vm["model-cache"].as<std::string>();
   std::unique_ptr<scram::mef::Model> model =
-      scram::mef::Initializer(input_files, settings, vm.count("allow-extern"))
+      scram::mef::Initializer(input_files, settings, vm.count("allow-extern"),
+                              nullptr, model_cache)
           .model();
 #ifndef NDEBUG
   if (vm.count("serialize"))
@@ -273,6 +456,8 @@ void RunScram(const po::variables_map& vm) {
 #endif
   if (vm.count("validate"))
     return;  // Stop if only validation is requested.
+  if (vm.count("monitor"))
+    return RunMonitor(model.get(), settings);
 
   // Initiate risk analysis with the given information.
   scram::core::RiskAnalysis analysis(model.get(), settings);
@@ -283,11 +468,22 @@ void RunScram(const po::variables_map& vm) {
 #endif
   scram::Reporter reporter;
   bool indent = vm.count("no-indent") ? false : true;
+  auto format = scram::Reporter::Format::kXml;
+  if (vm.count("output-format")) {
+    std::string name = vm["output-format"].as<std::string>();
+    if (name == "xml.gz") {
+      format = scram::Reporter::Format::kXmlGzip;
+    } else if (name == "binary") {
+      format = scram::Reporter::Format::kBinary;
+    }
+  }
   if (vm.count("output")) {
-    reporter.Report(analysis, vm["output"].as<std::string>(), indent);
+    reporter.Report(analysis, vm["output"].as<std::string>(), indent, format);
   } else {
-    reporter.Report(analysis, stdout, indent);
+    reporter.Report(analysis, stdout, indent, format);
   }
+  if (vm.count("metrics"))
+    reporter.ReportMetrics(analysis, vm["metrics"].as<std::string>());
 }
 
 /// Callback function to redirect XML library error/warning messages to logging.
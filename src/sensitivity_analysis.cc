@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the parametric sensitivity analysis.
+
+#include "sensitivity_analysis.h"
+
+#include <cstdlib>
+
+#include "event.h"
+#include "logger.h"
+#include "parameter.h"
+#include "zbdd.h"
+
+namespace scram::core {
+
+SensitivityAnalysis::SensitivityAnalysis(
+    const ProbabilityAnalyzerBase* prob_analyzer,
+    std::vector<mef::Parameter*> parameters)
+    : Analysis(prob_analyzer->settings()),
+      prob_analyzer_(prob_analyzer),
+      parameters_(std::move(parameters)) {
+  assert(parameters_.size() ==
+         Analysis::settings().sensitivity_parameters().size());
+}
+
+void SensitivityAnalysis::Analyze() noexcept {
+  CLOCK(analysis_time);
+  LOG(DEBUG3) << "Sweeping parameter values...";
+  const std::vector<const mef::BasicEvent*>& basic_events =
+      prob_analyzer_->graph()->basic_events();
+  Pdag::IndexMap<double> p_vars = prob_analyzer_->p_vars();  // Private copy!
+  Pdag::IndexMap<int> occurrences(basic_events.size());
+  if (Analysis::settings().importance_analysis()) {
+    for (const std::vector<int>& product : prob_analyzer_->products()) {
+      for (int index : product)
+        occurrences[std::abs(index)]++;
+    }
+  }
+
+  bool clamped = false;
+  int num_points = 0;
+  for (int i = 0; i < parameters_.size(); ++i) {
+    mef::Parameter* parameter = parameters_[i];
+    Curve curve{*parameter, {}};
+    for (double value :
+         Analysis::settings().sensitivity_parameters()[i].second) {
+      parameter->override_value(value);
+      int index = Pdag::kVariableStartIndex;
+      for (const mef::BasicEvent* event : basic_events) {
+        double p_var = event->p();
+        if (p_var < 0 || p_var > 1) {
+          clamped = true;
+          p_var = p_var > 1 ? 1 : 0;
+        }
+        p_vars[index++] = p_var;
+      }
+      Point point{value, this->CalculateTotalProbability(p_vars), {}};
+      assert(point.p_total >= 0 && point.p_total <= 1);
+      if (Analysis::settings().importance_analysis())
+        CalculateImportance(occurrences, &p_vars, &point);
+      curve.points.push_back(std::move(point));
+      ++num_points;
+    }
+    parameter->override_value(std::nullopt);
+    curves_.push_back(std::move(curve));
+  }
+  if (clamped)
+    Analysis::AddWarning("Probabilities out of [0, 1] are clamped.");
+
+  double sweep_time = DUR(analysis_time);
+  LOG(DEBUG3) << "Evaluated " << num_points << " points in " << sweep_time;
+  if (sweep_time > 0)
+    Analysis::AddMetric("points-per-second", num_points / sweep_time);
+  Analysis::AddAnalysisTime(sweep_time);
+}
+
+void SensitivityAnalysis::CalculateImportance(
+    const Pdag::IndexMap<int>& occurrences, Pdag::IndexMap<double>* p_vars,
+    Point* point) noexcept {
+  const std::vector<const mef::BasicEvent*>& basic_events =
+      prob_analyzer_->graph()->basic_events();
+  int index = Pdag::kVariableStartIndex;
+  for (const mef::BasicEvent* event : basic_events) {
+    if (occurrences[index]) {
+      double p_var = (*p_vars)[index];  // Save the value for restoring.
+      (*p_vars)[index] = 1;
+      double mif = this->CalculateTotalProbability(*p_vars);
+      (*p_vars)[index] = 0;
+      mif -= this->CalculateTotalProbability(*p_vars);
+      (*p_vars)[index] = p_var;
+      point->importance.emplace_back(
+          ImportanceRecord{*event,
+                           CalculateImportanceFactors(occurrences[index], p_var,
+                                                      mif, point->p_total)},
+          p_var);
+    }
+    ++index;
+  }
+}
+
+}  // namespace scram::core
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Parametric sensitivity analysis
+/// over the products or BDD of a single qualitative analysis.
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "analysis.h"
+#include "importance_analysis.h"
+#include "probability_analysis.h"
+
+namespace scram::mef {  // Decouple from the implementation dependence.
+class Parameter;
+}  // namespace scram::mef
+
+namespace scram::core {
+
+/// Sweeps of model parameters over grids of values
+/// with the total probability (and optionally importance factors)
+/// re-evaluated for every grid point
+/// without repeating the qualitative analysis.
+class SensitivityAnalysis : public Analysis {
+ public:
+  /// The results at a single grid point.
+  struct Point {
+    double value;  ///< The parameter value.
+    double p_total;  ///< The total probability with the parameter value.
+    /// The importance factors with the event probabilities at the value
+    /// if importance analysis is requested.
+    std::vector<std::pair<ImportanceRecord, double>> importance;
+  };
+
+  /// The results of the sweep of a single parameter.
+  struct Curve {
+    const mef::Parameter& parameter;  ///< The swept parameter.
+    std::vector<Point> points;  ///< The results in the order of the grid.
+  };
+
+  /// @param[in] prob_analyzer  Completed probability analysis.
+  /// @param[in] parameters  The model parameters
+  ///                        in the order of the sensitivity settings.
+  SensitivityAnalysis(const ProbabilityAnalyzerBase* prob_analyzer,
+                      std::vector<mef::Parameter*> parameters);
+
+  virtual ~SensitivityAnalysis() = default;
+
+  /// Sweeps the parameters one at a time
+  /// with the other parameters at their nominal values.
+  ///
+  /// @note The parameter values are restored after the analysis.
+  /// @note Undefined behavior if analysis called two or more times.
+  void Analyze() noexcept;
+
+  /// @returns The results of the sweeps in the order of the parameters.
+  const std::vector<Curve>& curves() const { return curves_; }
+
+ private:
+  /// @param[in] p_vars  Indices to probabilities mapping with values.
+  ///
+  /// @returns The total probability with the given variable probabilities.
+  virtual double
+  CalculateTotalProbability(const Pdag::IndexMap<double>& p_vars) noexcept = 0;
+
+  /// Calculates the importance factors of the events in the products.
+  ///
+  /// @param[in] occurrences  The number of products with variables.
+  /// @param[in,out] p_vars  The variable probabilities at the grid point.
+  /// @param[in,out] point  The grid point with the total probability.
+  void CalculateImportance(const Pdag::IndexMap<int>& occurrences,
+                           Pdag::IndexMap<double>* p_vars,
+                           Point* point) noexcept;
+
+  const ProbabilityAnalyzerBase* prob_analyzer_;  ///< The products and PDAG.
+  std::vector<mef::Parameter*> parameters_;  ///< The parameters to sweep.
+  std::vector<Curve> curves_;  ///< The results of the sweeps.
+};
+
+/// Sensitivity analysis facility.
+///
+/// @tparam Calculator  Quantitative analysis calculator.
+template <class Calculator>
+class SensitivityAnalyzer : public SensitivityAnalysis {
+ public:
+  /// Constructs sensitivity analyzer from probability analyzer.
+  /// Probability analyzer facilities are used
+  /// to calculate the total probability for every grid point.
+  ///
+  /// @param[in] prob_analyzer  Instantiated probability analyzer.
+  /// @param[in] parameters  The model parameters to sweep.
+  SensitivityAnalyzer(ProbabilityAnalyzer<Calculator>* prob_analyzer,
+                      std::vector<mef::Parameter*> parameters)
+      : SensitivityAnalysis(prob_analyzer, std::move(parameters)),
+        prob_analyzer_(prob_analyzer) {}
+
+ private:
+  double CalculateTotalProbability(
+      const Pdag::IndexMap<double>& p_vars) noexcept override {
+    return prob_analyzer_->CalculateTotalProbability(p_vars);
+  }
+
+  /// Calculator of the total probability.
+  ProbabilityAnalyzer<Calculator>* prob_analyzer_;
+};
+
+}  // namespace scram::core
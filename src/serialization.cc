@@ -25,6 +25,7 @@
 #include <boost/exception/errinfo_file_name.hpp>
 #include <boost/exception/errinfo_file_open_mode.hpp>
 
+#include "ccf_group.h"
 #include "element.h"
 #include "event.h"
 #include "expression.h"
@@ -167,6 +168,38 @@ void Serialize(const BasicEvent& basic_event, xml::StreamElement* parent) {
     Serialize(basic_event.expression(), &be_element);
 }
 
+void Serialize(const CcfGroup& ccf_group, xml::StreamElement* parent) {
+  assert(ccf_group.role() == RoleSpecifier::kPublic);
+  xml::StreamElement ccf_element = parent->AddChild("define-CCF-group");
+  ccf_element.SetAttribute("name", ccf_group.name())
+      .SetAttribute("model", [&ccf_group] {
+        if (dynamic_cast<const BetaFactorModel*>(&ccf_group))
+          return "beta-factor";
+        if (dynamic_cast<const MglModel*>(&ccf_group))
+          return "MGL";
+        if (dynamic_cast<const AlphaFactorModel*>(&ccf_group))
+          return "alpha-factor";
+        assert(dynamic_cast<const PhiFactorModel*>(&ccf_group));
+        return "phi-factor";
+      }());
+  SerializeLabelAndAttributes(ccf_group, &ccf_element);
+  {
+    xml::StreamElement members = ccf_element.AddChild("members");
+    for (const BasicEvent* member : ccf_group.members())
+      members.AddChild("basic-event").SetAttribute("name", member->name());
+  }
+  {
+    xml::StreamElement distribution = ccf_element.AddChild("distribution");
+    Serialize(*ccf_group.distribution(), &distribution);
+  }
+  xml::StreamElement factors = ccf_element.AddChild("factors");
+  for (const auto& [level, factor] : ccf_group.factors()) {
+    xml::StreamElement factor_element = factors.AddChild("factor");
+    factor_element.SetAttribute("level", level);
+    Serialize(*factor, &factor_element);
+  }
+}
+
 void Serialize(const HouseEvent& house_event, xml::StreamElement* parent) {
   assert(house_event.role() == RoleSpecifier::kPublic);
   assert(&house_event != &HouseEvent::kTrue &&
@@ -186,7 +219,6 @@ void Serialize(const Model& model, std::FILE* out) {
     root.SetAttribute("name", model.name());
   SerializeLabelAndAttributes(model, &root);
   /// @todo Implement serialization for the following unsupported constructs.
-  assert(model.ccf_groups().empty());
   assert(model.parameters().empty());
   assert(model.initiating_events().empty());
   assert(model.event_trees().empty());
@@ -195,10 +227,14 @@ void Serialize(const Model& model, std::FILE* out) {
 
   for (const FaultTree& fault_tree : model.fault_trees())
     Serialize(fault_tree, &root);
+  for (const CcfGroup& ccf_group : model.ccf_groups())
+    Serialize(ccf_group, &root);
 
   xml::StreamElement model_data = root.AddChild("model-data");
-  for (const BasicEvent& basic_event : model.basic_events())
-    Serialize(basic_event, &model_data);
+  for (const BasicEvent& basic_event : model.basic_events()) {
+    if (!basic_event.HasCcf())  // CCF members are defined in their groups.
+      Serialize(basic_event, &model_data);
+  }
   for (const HouseEvent& house_event : model.house_events())
     Serialize(house_event, &model_data);
 }
@@ -18,7 +18,8 @@
 /// @file
 /// The MEF Model serialization facilities.
 ///
-/// @note This facility currently caters only models representable in the GUI.
+/// @note This facility currently caters only models representable in the GUI
+///       and their CCF groups.
 /// @todo Implement serialization for all MEF constructs.
 
 #pragma once
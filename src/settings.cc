@@ -35,10 +35,14 @@ Settings& Settings::algorithm(Algorithm value) noexcept {
       approximation(Approximation::kNone);
       break;
     default:
-      if (approximation_ == Approximation::kNone)
-        approximation(Approximation::kRareEvent);
       if (prime_implicants_)
         prime_implicants(false);
+      if (shared_sequence_bdd_)
+        shared_sequence_bdd(false);
+      if (shared_top_event_bdd_)
+        shared_top_event_bdd(false);
+      if (approximation_ == Approximation::kNone)
+        approximation(Approximation::kRareEvent);
   }
   return *this;
 }
@@ -58,6 +62,12 @@ Settings& Settings::approximation(Approximation value) {
   if (value != Approximation::kNone && prime_implicants_)
     SCRAM_THROW(SettingsError(
         "Prime implicants require no quantitative approximation."));
+  if (value != Approximation::kNone && shared_sequence_bdd_)
+    SCRAM_THROW(SettingsError(
+        "The shared sequence BDD requires no quantitative approximation."));
+  if (value != Approximation::kNone && shared_top_event_bdd_)
+    SCRAM_THROW(SettingsError(
+        "The shared top event BDD requires no quantitative approximation."));
   approximation_ = value;
   return *this;
 }
@@ -73,6 +83,25 @@ Settings& Settings::approximation(std::string_view value) {
       static_cast<Approximation>(std::distance(kApproximationToString, it)));
 }
 
+Settings& Settings::apply_schedule(std::string_view value) {
+  auto it = boost::find(kApplyScheduleToString, value);
+  if (it == std::end(kApplyScheduleToString))
+    SCRAM_THROW(SettingsError("The BDD Apply schedule is not recognized."))
+        << errinfo_value(std::string(value));
+
+  return apply_schedule(
+      static_cast<ApplySchedule>(std::distance(kApplyScheduleToString, it)));
+}
+
+Settings& Settings::bdd_cache_limit(int entries) {
+  if (entries < 0)
+    SCRAM_THROW(SettingsError("The BDD cache limit cannot be negative."))
+        << errinfo_value(std::to_string(entries));
+
+  bdd_cache_limit_ = entries;
+  return *this;
+}
+
 Settings& Settings::prime_implicants(bool flag) {
   if (flag && algorithm_ != Algorithm::kBdd)
     SCRAM_THROW(
@@ -84,6 +113,28 @@ Settings& Settings::prime_implicants(bool flag) {
   return *this;
 }
 
+Settings& Settings::shared_sequence_bdd(bool flag) {
+  if (flag && algorithm_ != Algorithm::kBdd)
+    SCRAM_THROW(
+        SettingsError("The shared sequence BDD can only be used with BDD"));
+
+  shared_sequence_bdd_ = flag;
+  if (shared_sequence_bdd_)
+    approximation(Approximation::kNone);
+  return *this;
+}
+
+Settings& Settings::shared_top_event_bdd(bool flag) {
+  if (flag && algorithm_ != Algorithm::kBdd)
+    SCRAM_THROW(
+        SettingsError("The shared top event BDD can only be used with BDD"));
+
+  shared_top_event_bdd_ = flag;
+  if (shared_top_event_bdd_)
+    approximation(Approximation::kNone);
+  return *this;
+}
+
 Settings& Settings::limit_order(int order) {
   if (order < 0)
     SCRAM_THROW(SettingsError(
@@ -172,4 +223,44 @@ Settings& Settings::safety_integrity_levels(bool flag) {
   return *this;
 }
 
+Settings& Settings::sensitivity_parameter(std::string id,
+                                          std::vector<double> values) {
+  if (values.empty())
+    SCRAM_THROW(SettingsError("The sensitivity parameter has no values."))
+        << errinfo_value(id);
+  if (boost::find_if(sensitivity_parameters_, [&id](const auto& entry) {
+        return entry.first == id;
+      }) != sensitivity_parameters_.end()) {
+    SCRAM_THROW(SettingsError("Duplicate sensitivity parameter."))
+        << errinfo_value(id);
+  }
+
+  sensitivity_parameters_.emplace_back(std::move(id), std::move(values));
+  probability_analysis_ = true;
+  return *this;
+}
+
+Settings& Settings::preprocessing_budget(PreprocessorPass pass,
+                                         double seconds) {
+  if (seconds < 0)
+    SCRAM_THROW(SettingsError("The preprocessing budget cannot be negative."))
+        << errinfo_value(std::to_string(seconds));
+
+  preprocessing_budgets_[static_cast<int>(pass)] = seconds;
+  return *this;
+}
+
+Settings& Settings::preprocessing_budget(std::string_view pass,
+                                         double seconds) {
+  auto it = boost::find(kPreprocessorPassToString, pass);
+  if (it == std::end(kPreprocessorPassToString))
+    SCRAM_THROW(SettingsError("The preprocessing pass is not recognized."))
+        << errinfo_value(std::string(pass));
+
+  return preprocessing_budget(
+      static_cast<PreprocessorPass>(
+          std::distance(kPreprocessorPassToString, it)),
+      seconds);
+}
+
 }  // namespace scram::core
@@ -22,7 +22,12 @@
 
 #include <cstdint>
 
+#include <array>
+#include <iterator>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace scram::core {
 
@@ -38,6 +43,30 @@ enum class Approximation : std::uint8_t { kNone = 0, kRareEvent, kMcub };
 /// String representations for approximations.
 const char* const kApproximationToString[] = {"none", "rare-event", "mcub"};
 
+/// Strategies to combine gate argument functions in BDD construction.
+enum class ApplySchedule : std::uint8_t {
+  kSequential = 0,  ///< Left-to-right in the variable order.
+  kSmallestFirst,  ///< The two smallest functions first (Huffman-like).
+  kBalanced  ///< Pairwise rounds in a balanced binary tree.
+};
+
+/// String representations for the Apply schedules.
+const char* const kApplyScheduleToString[] = {"sequential", "smallest-first",
+                                              "balanced"};
+
+/// Optional preprocessing passes that can be limited with time budgets.
+enum class PreprocessorPass : std::uint8_t {
+  kMergeCommonArgs = 0,
+  kDistributivity,
+  kBooleanOptimization,
+  kDecomposition
+};
+
+/// String representations for the optional preprocessing passes.
+const char* const kPreprocessorPassToString[] = {
+    "merge-common-args", "distributivity", "boolean-optimization",
+    "decomposition"};
+
 /// Builder for analysis settings.
 /// Analysis facilities are guaranteed not to throw or fail
 /// with an instance of this class.
@@ -106,6 +135,84 @@ class Settings {
   /// @throws SettingsError  The request is not relevant to the algorithm.
   Settings& prime_implicants(bool flag);
 
+  /// @returns true if all sequences of an event tree
+  ///               share a single PDAG and BDD for probability analysis.
+  bool shared_sequence_bdd() const { return shared_sequence_bdd_; }
+
+  /// Sets a flag to quantify all sequences of an initiating event
+  /// with a single BDD shared by the sequences.
+  /// The shared analysis is exact;
+  /// it is applicable only to BDD-based algorithms.
+  ///
+  /// The request cancels
+  /// the request for inapplicable quantitative analysis approximations.
+  ///
+  /// @param[in] flag  True for the request.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws SettingsError  The request is not relevant to the algorithm.
+  Settings& shared_sequence_bdd(bool flag);
+
+  /// @returns true if all top events of fault trees
+  ///               share a single PDAG and BDD for probability analysis.
+  bool shared_top_event_bdd() const { return shared_top_event_bdd_; }
+
+  /// Sets a flag to quantify all top events of the model fault trees
+  /// with a single BDD shared by the top events.
+  /// Common sub-systems, including structurally identical gates,
+  /// are converted into BDD only once.
+  /// The shared analysis is exact;
+  /// it is applicable only to BDD-based algorithms.
+  ///
+  /// The request cancels
+  /// the request for inapplicable quantitative analysis approximations.
+  ///
+  /// @param[in] flag  True for the request.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws SettingsError  The request is not relevant to the algorithm.
+  Settings& shared_top_event_bdd(bool flag);
+
+  /// @returns The strategy to combine gate arguments in BDD construction.
+  ApplySchedule apply_schedule() const { return apply_schedule_; }
+
+  /// Sets the order in which the BDD functions of gate arguments
+  /// are combined with the Apply operation.
+  /// The strategy affects only the performance of BDD construction,
+  /// not the analysis results.
+  ///
+  /// @param[in] value  The schedule kind.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws SettingsError  The schedule is not recognized.
+  /// @{
+  Settings& apply_schedule(ApplySchedule value) noexcept {
+    apply_schedule_ = value;
+    return *this;
+  }
+  Settings& apply_schedule(std::string_view value);
+  /// @}
+
+  /// @returns The number of BDD computed-table entries
+  ///          kept between gate conversions.
+  int bdd_cache_limit() const { return bdd_cache_limit_; }
+
+  /// Sets the limit on the number of Apply results
+  /// reused across sibling gates in BDD construction.
+  /// The computed tables are cleared after a gate conversion
+  /// only if their combined size exceeds the limit.
+  ///
+  /// @param[in] entries  A non-negative number of table entries;
+  ///                     0 to clear the tables after every gate.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws SettingsError  The number is less than 0.
+  Settings& bdd_cache_limit(int entries);
+
   /// @returns The limit on the size of products.
   int limit_order() const { return limit_order_; }
 
@@ -220,7 +327,7 @@ class Settings {
   /// @returns Reference to this object.
   Settings& probability_analysis(bool flag) {
     if (!importance_analysis_ && !uncertainty_analysis_ &&
-        !safety_integrity_levels_) {
+        !safety_integrity_levels_ && sensitivity_parameters_.empty()) {
       probability_analysis_ = flag;
     }
     return *this;
@@ -274,6 +381,42 @@ class Settings {
     return *this;
   }
 
+  /// @returns true if uncertainty analysis trials use importance sampling.
+  bool importance_sampling() const { return importance_sampling_; }
+
+  /// Sets the flag for importance sampling in uncertainty analysis.
+  /// The trials are biased toward the upper tail
+  /// of the total probability distribution
+  /// and reweighted with likelihood ratios.
+  ///
+  /// @param[in] flag  True or false for turning on or off the technique.
+  ///
+  /// @returns Reference to this object.
+  Settings& importance_sampling(bool flag) {
+    importance_sampling_ = flag;
+    return *this;
+  }
+
+  /// @returns The parameters with their value grids for sensitivity analysis.
+  const std::vector<std::pair<std::string, std::vector<double>>>&
+  sensitivity_parameters() const {
+    return sensitivity_parameters_;
+  }
+
+  /// Requests the sensitivity analysis of the total probability
+  /// over the grid of values of a model parameter.
+  /// Sensitivity analysis implies probability analysis,
+  /// so the probability analysis is turned on implicitly.
+  ///
+  /// @param[in] id  The full id of the parameter in the model.
+  /// @param[in] values  The grid of the parameter values.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws SettingsError  The grid is empty
+  ///                        or the parameter is already requested.
+  Settings& sensitivity_parameter(std::string id, std::vector<double> values);
+
   /// @returns true if CCF groups must be incorporated into analysis.
   bool ccf_analysis() const { return ccf_analysis_; }
 
@@ -287,6 +430,47 @@ class Settings {
     return *this;
   }
 
+  /// @returns The directory for snapshots of preprocessed PDAGs.
+  ///          An empty path disables the snapshots.
+  const std::string& pdag_cache() const { return pdag_cache_; }
+
+  /// Sets the directory for snapshots of preprocessed PDAGs
+  /// to skip the preprocessing of unchanged fault trees in later runs.
+  ///
+  /// @param[in] directory  The cache directory (created on demand).
+  ///
+  /// @returns Reference to this object.
+  Settings& pdag_cache(std::string directory) {
+    pdag_cache_ = std::move(directory);
+    return *this;
+  }
+
+  /// @param[in] pass  The optional preprocessing pass.
+  ///
+  /// @returns The time budget in seconds for all runs of the pass.
+  ///          0 for no budget.
+  double preprocessing_budget(PreprocessorPass pass) const {
+    return preprocessing_budgets_[static_cast<int>(pass)];
+  }
+
+  /// Sets the time budget for an optional preprocessing pass.
+  /// Once the budget is spent,
+  /// the pass stops processing the graph,
+  /// and its later runs are skipped.
+  /// The graph remains valid but may be less simplified.
+  ///
+  /// @param[in] pass  The optional preprocessing pass.
+  /// @param[in] seconds  The total time for the pass; 0 for no budget.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws SettingsError  The pass is not recognized
+  ///                          or the budget is negative.
+  /// @{
+  Settings& preprocessing_budget(PreprocessorPass pass, double seconds);
+  Settings& preprocessing_budget(std::string_view pass, double seconds);
+  /// @}
+
 #ifndef NDEBUG
   bool preprocessor = false;  ///< Stop analysis after preprocessor.
   bool print = false;  ///< Print analysis results in a terminal friendly way.
@@ -297,12 +481,18 @@ class Settings {
   bool safety_integrity_levels_ = false;  ///< Calculation of the SIL metrics.
   bool importance_analysis_ = false;  ///< A flag for importance analysis.
   bool uncertainty_analysis_ = false;  ///< A flag for uncertainty analysis.
+  bool importance_sampling_ = false;  ///< Biased Monte Carlo sampling.
   bool ccf_analysis_ = false;  ///< A flag for common-cause analysis.
   bool prime_implicants_ = false;  ///< Calculation of prime implicants.
+  bool shared_sequence_bdd_ = false;  ///< One BDD for event tree sequences.
+  bool shared_top_event_bdd_ = false;  ///< One BDD for fault tree top events.
   /// Qualitative analysis algorithm.
   Algorithm algorithm_ = Algorithm::kBdd;
   /// The approximations for calculations.
   Approximation approximation_ = Approximation::kNone;
+  /// The strategy to combine gate arguments in BDD construction.
+  ApplySchedule apply_schedule_ = ApplySchedule::kBalanced;
+  int bdd_cache_limit_ = 0;  ///< The computed-table entries kept across gates.
   int limit_order_ = 20;  ///< Limit on the order of products.
   int seed_ = 0;  ///< The seed for the pseudo-random number generator.
   int num_trials_ = 1e3;  ///< The number of trials for Monte Carlo simulations.
@@ -311,6 +501,13 @@ class Settings {
   double mission_time_ = 8760;  ///< System mission time.
   double time_step_ = 0;  ///< The time step for probability analyses.
   double cut_off_ = 1e-8;  ///< The cut-off probability for products.
+  std::string pdag_cache_;  ///< The directory for preprocessed PDAGs.
+  /// The parameter value grids for sensitivity analysis.
+  std::vector<std::pair<std::string, std::vector<double>>>
+      sensitivity_parameters_;
+  /// The time budgets for optional preprocessing passes.
+  std::array<double, std::size(kPreprocessorPassToString)>
+      preprocessing_budgets_{};
 };
 
 }  // namespace scram::core
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of common snapshot facilities.
+
+#include "snapshot.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+
+#include <memory>
+
+#include <boost/exception/errinfo_errno.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+#include <boost/exception/errinfo_file_open_mode.hpp>
+#include <boost/filesystem.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace scram {
+
+namespace {
+
+const std::uint32_t kByteOrderMark = 0x01020304;  ///< Host byte order check.
+
+}  // namespace
+
+void SnapshotReader::GetHeader(std::string_view magic, std::uint32_t version,
+                               std::uint64_t key) {
+  assert(magic.size() == 8 && "Unexpected snapshot magic size.");
+  Ensure(magic.size());
+  if (magic.compare(0, magic.size(), cur_, magic.size()))
+    SCRAM_THROW(IOError("Mismatched snapshot format."));
+  cur_ += magic.size();
+  if (Get<std::uint32_t>() != version ||
+      Get<std::uint32_t>() != kByteOrderMark || Get<std::uint64_t>() != key) {
+    SCRAM_THROW(IOError("Mismatched snapshot header."));
+  }
+}
+
+void PutSnapshotHeader(std::string_view magic, std::uint32_t version,
+                       std::uint64_t key, SnapshotWriter* out) {
+  assert(magic.size() == 8 && "Unexpected snapshot magic size.");
+  for (char c : magic)
+    out->Put(c);
+  out->Put(version);
+  out->Put(kByteOrderMark);
+  out->Put(key);
+}
+
+std::string SnapshotPath(const std::string& directory, std::uint64_t key,
+                         std::string_view extension) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.",
+                static_cast<unsigned long long>(key));
+  return (fs::path(directory) / (name + std::string(extension))).string();
+}
+
+std::string LoadSnapshot(const std::string& path) noexcept {
+  std::string data;
+  std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
+      std::fopen(path.c_str(), "rb"), &std::fclose);
+  if (!fp)
+    return data;
+  // The snapshot is read with a single call
+  // to avoid the per-record cost of buffered stream reads.
+  if (std::fseek(fp.get(), 0, SEEK_END) == 0) {
+    long size = std::ftell(fp.get());
+    if (size > 0 && std::fseek(fp.get(), 0, SEEK_SET) == 0) {
+      data.resize(size);
+      data.resize(std::fread(data.data(), 1, data.size(), fp.get()));
+    }
+  }
+  return data;
+}
+
+void StoreSnapshot(const std::string& path, const std::string& data) {
+  fs::path snapshot(path);
+  boost::system::error_code ec;
+  fs::create_directories(snapshot.parent_path(), ec);
+  fs::path temp = snapshot;
+  temp += fs::unique_path(".%%%%-%%%%-%%%%.tmp");
+  {
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
+        std::fopen(temp.c_str(), "wb"), &std::fclose);
+    if (!fp) {
+      SCRAM_THROW(IOError("Cannot create the snapshot file."))
+          << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode("wb")
+          << boost::errinfo_file_name(temp.string());
+    }
+    if (std::fwrite(data.data(), 1, data.size(), fp.get()) != data.size() ||
+        std::fclose(fp.release())) {
+      fs::remove(temp, ec);
+      SCRAM_THROW(IOError("Failed to write the snapshot file."))
+          << boost::errinfo_errno(errno)
+          << boost::errinfo_file_name(temp.string());
+    }
+  }
+  fs::rename(temp, snapshot, ec);
+  if (ec) {
+    fs::remove(temp, ec);
+    SCRAM_THROW(IOError("Failed to store the snapshot file."))
+        << boost::errinfo_file_name(path);
+  }
+}
+
+}  // namespace scram
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Common facilities for persistent binary snapshots
+/// of analysis constructs.
+///
+/// The snapshot is a flat sequence of records in the host byte order.
+/// Snapshots are caches;
+/// they are not meant for the exchange between hosts or SCRAM versions.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "error.h"
+
+namespace scram {
+
+/// Appends records into the snapshot buffer.
+class SnapshotWriter {
+ public:
+  /// Writes the value in the host byte order.
+  template <typename T>
+  void Put(T value) {
+    static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  /// Writes the length-prefixed string.
+  void PutString(const std::string& str) {
+    Put<std::uint32_t>(str.size());
+    buffer_ += str;
+  }
+
+  /// @returns The snapshot data.
+  const std::string& data() const { return buffer_; }
+
+ private:
+  std::string buffer_;  ///< The snapshot data.
+};
+
+/// Consumes records from the snapshot data with bounds checking.
+class SnapshotReader {
+ public:
+  /// @param[in] data  The complete snapshot.
+  explicit SnapshotReader(const std::string& data)
+      : cur_(data.data()), end_(data.data() + data.size()) {}
+
+  /// @returns true if all the data has been consumed.
+  bool empty() const { return cur_ == end_; }
+
+  /// @returns The value in the host byte order.
+  ///
+  /// @throws IOError  The snapshot is truncated.
+  template <typename T>
+  T Get() {
+    static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+    Ensure(sizeof(T));
+    T value;
+    std::memcpy(&value, cur_, sizeof(value));
+    cur_ += sizeof(value);
+    return value;
+  }
+
+  /// @returns The number of records that follow.
+  ///
+  /// @throws IOError  The number exceeds the remaining data.
+  std::uint32_t GetCount() {
+    auto count = Get<std::uint32_t>();
+    Ensure(count);
+    return count;
+  }
+
+  /// @returns The index checked against the number of indexed elements.
+  ///
+  /// @throws IOError  The index is out of range.
+  std::uint32_t GetIndex(std::size_t size) {
+    auto index = Get<std::uint32_t>();
+    if (index >= size)
+      SCRAM_THROW(IOError("Invalid index in the snapshot."));
+    return index;
+  }
+
+  /// @returns The length-prefixed string.
+  std::string GetString() {
+    std::uint32_t size = GetCount();
+    std::string str(cur_, size);
+    cur_ += size;
+    return str;
+  }
+
+  /// Reads and verifies the snapshot header.
+  ///
+  /// @param[in] magic  The format identifier of exactly 8 characters.
+  /// @param[in] version  The format version.
+  /// @param[in] key  The unique key of the snapshot source.
+  ///
+  /// @throws IOError  The header does not match.
+  void GetHeader(std::string_view magic, std::uint32_t version,
+                 std::uint64_t key);
+
+ private:
+  /// Ensures the given number of bytes is available.
+  void Ensure(std::size_t num_bytes) {
+    if (static_cast<std::size_t>(end_ - cur_) < num_bytes)
+      SCRAM_THROW(IOError("Truncated snapshot."));
+  }
+
+  const char* cur_;  ///< The current position in the data.
+  const char* end_;  ///< The end of the data.
+};
+
+/// Computes the FNV-1a hash of snapshot sources.
+class SnapshotHash {
+ public:
+  /// Adds the data into the hash.
+  void Add(const char* data, std::size_t size) {
+    for (const char* end = data + size; data != end; ++data) {
+      value_ ^= static_cast<unsigned char>(*data);
+      value_ *= 0x100000001b3;
+    }
+  }
+
+  /// Adds the string with its length into the hash.
+  void Add(std::string_view str) {
+    Add(str.size());
+    Add(str.data(), str.size());
+  }
+
+  /// Adds the value representation into the hash.
+  template <typename T>
+  std::enable_if_t<std::is_arithmetic_v<T>> Add(T value) {
+    Add(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  /// @returns The hash value.
+  std::uint64_t value() const { return value_; }
+
+ private:
+  std::uint64_t value_ = 0xcbf29ce484222325;  ///< The FNV offset basis.
+};
+
+/// Writes the snapshot header.
+///
+/// @param[in] magic  The format identifier of exactly 8 characters.
+/// @param[in] version  The format version.
+/// @param[in] key  The unique key of the snapshot source.
+/// @param[in,out] out  The snapshot destination.
+void PutSnapshotHeader(std::string_view magic, std::uint32_t version,
+                       std::uint64_t key, SnapshotWriter* out);
+
+/// @returns The snapshot file name for the key.
+///
+/// @param[in] directory  The cache directory.
+/// @param[in] key  The unique key of the snapshot source.
+/// @param[in] extension  The file extension specific to the snapshot kind.
+std::string SnapshotPath(const std::string& directory, std::uint64_t key,
+                         std::string_view extension);
+
+/// Reads the whole snapshot file.
+///
+/// @param[in] path  The snapshot file.
+///
+/// @returns The snapshot data or an empty string if the file is not readable.
+std::string LoadSnapshot(const std::string& path) noexcept;
+
+/// Writes the snapshot file atomically.
+/// The data is written into a temporary file first
+/// so that concurrent runs never observe partial snapshots.
+///
+/// @param[in] path  The snapshot file (the directory is created on demand).
+/// @param[in] data  The complete snapshot.
+///
+/// @throws IOError  The snapshot cannot be written.
+void StoreSnapshot(const std::string& path, const std::string& data);
+
+}  // namespace scram
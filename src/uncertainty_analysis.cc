@@ -22,12 +22,17 @@
 
 #include <cmath>
 
+#include <algorithm>
+
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/density.hpp>
 #include <boost/accumulators/statistics/extended_p_square_quantile.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/variance.hpp>
+#include <boost/accumulators/statistics/weighted_density.hpp>
+#include <boost/accumulators/statistics/weighted_mean.hpp>
+#include <boost/accumulators/statistics/weighted_variance.hpp>
 
 #include "event.h"
 #include "expression.h"
@@ -35,6 +40,26 @@
 
 namespace scram::core {
 
+namespace {
+
+/// The number of the most probable products to score the samples.
+const int kNumDominantProducts = 32;
+
+/// The number of candidate samples competing for the best score
+/// in the biased component of the sampling mixture.
+const int kNumCandidates = 4;
+
+/// The probability of a product with the given variable probabilities.
+double ProductProbability(const std::vector<int>& product,
+                          const Pdag::IndexMap<double>& p_vars) noexcept {
+  double p = 1;
+  for (int literal : product)
+    p *= literal < 0 ? 1 - p_vars[-literal] : p_vars[literal];
+  return p;
+}
+
+}  // namespace
+
 UncertaintyAnalysis::UncertaintyAnalysis(
     const ProbabilityAnalysis* prob_analysis)
     : Analysis(prob_analysis->settings()),
@@ -47,15 +72,20 @@ void UncertaintyAnalysis::Analyze() noexcept {
   CLOCK(sample_time);
   LOG(DEBUG3) << "Sampling probabilities...";
   // Sample probabilities and generate data.
-  std::vector<double> samples = this->Sample();
-  LOG(DEBUG3) << "Finished sampling probabilities in " << DUR(sample_time);
+  std::vector<double> weights;
+  std::vector<double> samples = this->Sample(&weights);
+  double sampling_time = DUR(sample_time);
+  LOG(DEBUG3) << "Finished sampling probabilities in " << sampling_time;
+  if (sampling_time > 0)
+    Analysis::AddMetric("trials-per-second", samples.size() / sampling_time);
 
   {
     TIMER(DEBUG3, "Calculating statistics");
-    CalculateStatistics(samples);  // Perform statistical analysis.
+    CalculateStatistics(samples, weights);  // Perform statistical analysis.
   }
 
   Analysis::AddAnalysisTime(DUR(analysis_time));
+  Analysis::AddMetric("peak-memory", PeakMemory());
 }
 
 std::vector<std::pair<int, mef::Expression&>>
@@ -84,8 +114,103 @@ void UncertaintyAnalysis::SampleExpressions(
   }
 }
 
+void UncertaintyAnalysis::PrepareImportanceSampling(
+    const Zbdd& products,
+    const std::vector<std::pair<int, mef::Expression&>>& deviate_expressions,
+    Pdag::IndexMap<double>* p_vars) noexcept {
+  TIMER(DEBUG4, "Preparing importance sampling");
+  using Candidate = std::pair<double, std::vector<int>>;
+  auto by_probability = [](const Candidate& lhs, const Candidate& rhs) {
+    return lhs.first > rhs.first;
+  };
+  std::vector<Candidate> dominant;  // Min-heap of the most probable products.
+  for (const std::vector<int>& product : products) {
+    double p = ProductProbability(product, *p_vars);
+    if (dominant.size() == kNumDominantProducts) {
+      if (p <= dominant.front().first)
+        continue;
+      std::pop_heap(dominant.begin(), dominant.end(), by_probability);
+      dominant.pop_back();
+    }
+    dominant.emplace_back(p, product);
+    std::push_heap(dominant.begin(), dominant.end(), by_probability);
+  }
+  dominant_products_.clear();
+  for (Candidate& candidate : dominant)
+    dominant_products_.push_back(std::move(candidate.second));
+
+  pilot_scores_.clear();
+  pilot_scores_.reserve(Analysis::settings().num_trials());
+  for (int i = 0; i < Analysis::settings().num_trials(); ++i) {
+    SampleExpressions(deviate_expressions, p_vars);
+    pilot_scores_.push_back(Score(*p_vars));
+  }
+  std::sort(pilot_scores_.begin(), pilot_scores_.end());
+  num_biased_trials_ = 0;
+  LOG(DEBUG4) << "Dominant products for biasing: "
+              << dominant_products_.size();
+}
+
+double UncertaintyAnalysis::SampleImportance(
+    const std::vector<std::pair<int, mef::Expression&>>& deviate_expressions,
+    Pdag::IndexMap<double>* p_vars) noexcept {
+  assert(!pilot_scores_.empty() && "Importance sampling is not prepared.");
+  SampleExpressions(deviate_expressions, p_vars);
+  double score = Score(*p_vars);
+  // Deterministic defensive mixture:
+  // every other trial is drawn from the nominal distribution.
+  if (num_biased_trials_++ % 2) {
+    std::vector<double> best;  // The deviate values of the best candidate.
+    auto save = [&deviate_expressions, &p_vars, &best] {
+      best.clear();
+      for (const auto& expression : deviate_expressions)
+        best.push_back((*p_vars)[expression.first]);
+    };
+    save();
+    for (int i = 1; i < kNumCandidates; ++i) {
+      SampleExpressions(deviate_expressions, p_vars);
+      double candidate_score = Score(*p_vars);
+      if (candidate_score > score) {
+        score = candidate_score;
+        save();
+      }
+    }
+    for (int i = 0; i < deviate_expressions.size(); ++i)
+      (*p_vars)[deviate_expressions[i].first] = best[i];
+  }
+  return 1 / (0.5 + 0.5 * CandidateDensityRatio(score));
+}
+
+double UncertaintyAnalysis::Score(const Pdag::IndexMap<double>& p_vars) const
+    noexcept {
+  double score = 0;
+  for (const std::vector<int>& product : dominant_products_)
+    score += ProductProbability(product, p_vars);
+  return score;
+}
+
+double UncertaintyAnalysis::CandidateDensityRatio(double score) const
+    noexcept {
+  // The empirical CDF of the score from the pilot trials.
+  double num_pilots = pilot_scores_.size();
+  double lower = std::distance(pilot_scores_.begin(),
+                               std::lower_bound(pilot_scores_.begin(),
+                                                pilot_scores_.end(), score)) /
+                 num_pilots;
+  double upper = std::distance(pilot_scores_.begin(),
+                               std::upper_bound(pilot_scores_.begin(),
+                                                pilot_scores_.end(), score)) /
+                 num_pilots;
+  if (upper > lower)  // The atom of the score is shared by the tied samples.
+    return (std::pow(upper, kNumCandidates) -
+            std::pow(lower, kNumCandidates)) /
+           (upper - lower);
+  return kNumCandidates * std::pow(upper, kNumCandidates - 1);
+}
+
 void UncertaintyAnalysis::CalculateStatistics(
-    const std::vector<double>& samples) noexcept {
+    const std::vector<double>& samples,
+    const std::vector<double>& weights) noexcept {
   using namespace boost;  // NOLINT
   using namespace boost::accumulators;  // NOLINT
   using histogram_type =
@@ -97,27 +222,58 @@ void UncertaintyAnalysis::CalculateStatistics(
     quantiles_.push_back(delta * (i + 1));
   }
   int num_trials = Analysis::settings().num_trials();
-  accumulator_set<double, stats<tag::mean, tag::variance, tag::density,
-                                tag::extended_p_square_quantile>>
-      acc(tag::density::num_bins = Analysis::settings().num_bins(),
-          tag::density::cache_size = num_trials,
-          extended_p_square_probabilities = quantiles_);
-  for (double sample : samples) {
-    acc(sample);
-  }
-  histogram_type hist = density(acc);
-  for (int i = 1; i < hist.size(); i++) {
-    distribution_.push_back(hist[i]);
-  }
-  mean_ = boost::accumulators::mean(acc);
-  sigma_ = std::sqrt(num_trials * variance(acc) / (num_trials - 1));
-  error_factor_ = std::exp(1.96 * sigma_);
-  confidence_interval_.first = mean_ - sigma_ * 1.96 / std::sqrt(num_trials);
-  confidence_interval_.second = mean_ + sigma_ * 1.96 / std::sqrt(num_trials);
+  double num_samples = num_trials;  // The effective sample size.
+  double variance_value = 0;
+  std::vector<double> quantile_values;
+  auto gather = [&](auto& acc, const histogram_type& hist,
+                    auto mean_extractor, double var) {
+    for (int i = 1; i < hist.size(); i++) {
+      distribution_.push_back(hist[i]);
+    }
+    mean_ = mean_extractor(acc);
+    variance_value = var;
+    for (double probability : quantiles_) {
+      quantile_values.push_back(
+          quantile(acc, quantile_probability = probability));
+    }
+  };
 
-  for (int i = 0; i < num_quantiles; ++i) {
-    quantiles_[i] = quantile(acc, quantile_probability = quantiles_[i]);
+  if (weights.empty()) {
+    accumulator_set<double, stats<tag::mean, tag::variance, tag::density,
+                                  tag::extended_p_square_quantile>>
+        acc(tag::density::num_bins = Analysis::settings().num_bins(),
+            tag::density::cache_size = num_trials,
+            extended_p_square_probabilities = quantiles_);
+    for (double sample : samples) {
+      acc(sample);
+    }
+    gather(acc, density(acc), boost::accumulators::mean, variance(acc));
+  } else {
+    assert(weights.size() == samples.size());
+    accumulator_set<double,
+                    stats<tag::weighted_mean, tag::weighted_variance,
+                          tag::weighted_density,
+                          tag::weighted_extended_p_square_quantile>,
+                    double>
+        acc(tag::weighted_density::num_bins = Analysis::settings().num_bins(),
+            tag::weighted_density::cache_size = num_trials,
+            extended_p_square_probabilities = quantiles_);
+    double sum_weights = 0;
+    double sum_squares = 0;
+    for (int i = 0; i < samples.size(); ++i) {
+      acc(samples[i], weight = weights[i]);
+      sum_weights += weights[i];
+      sum_squares += weights[i] * weights[i];
+    }
+    num_samples = sum_weights * sum_weights / sum_squares;
+    gather(acc, weighted_density(acc), boost::accumulators::weighted_mean,
+           weighted_variance(acc));
   }
+  sigma_ = std::sqrt(num_samples * variance_value / (num_samples - 1));
+  error_factor_ = std::exp(1.96 * sigma_);
+  confidence_interval_.first = mean_ - sigma_ * 1.96 / std::sqrt(num_samples);
+  confidence_interval_.second = mean_ + sigma_ * 1.96 / std::sqrt(num_samples);
+  quantiles_ = std::move(quantile_values);
 }
 
 }  // namespace scram::core
@@ -92,18 +92,64 @@ class UncertaintyAnalysis : public Analysis {
       const std::vector<std::pair<int, mef::Expression&>>& deviate_expressions,
       Pdag::IndexMap<double>* p_vars) noexcept;
 
+  /// Prepares the biased sampling
+  /// toward the upper tail of the total probability distribution.
+  /// The dominant products with the nominal probabilities
+  /// score the sampled probabilities of variables,
+  /// and the reference distribution of the score
+  /// is gathered with unbiased pilot trials.
+  ///
+  /// @param[in] products  The products of the fault tree analysis.
+  /// @param[in] deviate_expressions  A collection of deviate expressions.
+  /// @param[in,out] p_vars  Indices to probabilities mapping with values.
+  void PrepareImportanceSampling(
+      const Zbdd& products,
+      const std::vector<std::pair<int, mef::Expression&>>& deviate_expressions,
+      Pdag::IndexMap<double>* p_vars) noexcept;
+
+  /// Samples uncertain probabilities
+  /// from the defensive mixture of the nominal distribution
+  /// and the best-of-candidates distribution of the score.
+  ///
+  /// @param[in] deviate_expressions  A collection of deviate expressions.
+  /// @param[in,out] p_vars  Indices to probabilities mapping with values.
+  ///
+  /// @returns The likelihood ratio (weight) of the sample.
+  ///
+  /// @pre The importance sampling is prepared.
+  double SampleImportance(
+      const std::vector<std::pair<int, mef::Expression&>>& deviate_expressions,
+      Pdag::IndexMap<double>* p_vars) noexcept;
+
  private:
   /// Performs Monte Carlo Simulation
   /// by sampling the probability distributions
   /// and providing the final sampled values of the final probability.
   ///
+  /// @param[out] weights  The likelihood ratios of the samples
+  ///                      if the sampling is biased.
+  ///
   /// @returns Sampled values.
-  virtual std::vector<double> Sample() noexcept = 0;
+  virtual std::vector<double> Sample(std::vector<double>* weights) noexcept = 0;
 
   /// Calculates statistical values from the final distribution.
   ///
   /// @param[in] samples  Gathered samples for statistical analysis.
-  void CalculateStatistics(const std::vector<double>& samples) noexcept;
+  /// @param[in] weights  The weights of the samples
+  ///                     or empty for equally weighted samples.
+  void CalculateStatistics(const std::vector<double>& samples,
+                           const std::vector<double>& weights) noexcept;
+
+  /// @param[in] p_vars  Indices to probabilities mapping with values.
+  ///
+  /// @returns The rare-event score of the dominant products.
+  double Score(const Pdag::IndexMap<double>& p_vars) const noexcept;
+
+  /// @param[in] score  The score of the selected sample.
+  ///
+  /// @returns The ratio of the best-of-candidates density
+  ///          to the nominal density at the given score.
+  double CandidateDensityRatio(double score) const noexcept;
 
   double mean_;  ///< The mean of the final distribution.
   double sigma_;  ///< The standard deviation of the final distribution.
@@ -114,6 +160,10 @@ class UncertaintyAnalysis : public Analysis {
   std::vector<std::pair<double, double>> distribution_;
   /// The quantiles of the distribution.
   std::vector<double> quantiles_;
+  /// The most probable products with the nominal probabilities.
+  std::vector<std::vector<int>> dominant_products_;
+  std::vector<double> pilot_scores_;  ///< The sorted unbiased scores.
+  int num_biased_trials_ = 0;  ///< The trial counter for the mixture.
 };
 
 /// Uncertainty analysis facility.
@@ -132,22 +182,35 @@ class UncertaintyAnalyzer : public UncertaintyAnalysis {
 
  private:
   /// @returns Samples of the total probability.
-  std::vector<double> Sample() noexcept override;
+  std::vector<double> Sample(std::vector<double>* weights) noexcept override;
 
   /// Calculator of the total probability.
   ProbabilityAnalyzer<Calculator>* prob_analyzer_;
 };
 
 template <class Calculator>
-std::vector<double> UncertaintyAnalyzer<Calculator>::Sample() noexcept {
+std::vector<double>
+UncertaintyAnalyzer<Calculator>::Sample(std::vector<double>* weights) noexcept {
   std::vector<std::pair<int, mef::Expression&>> deviate_expressions =
       UncertaintyAnalysis::GatherDeviateExpressions(prob_analyzer_->graph());
   Pdag::IndexMap<double> p_vars = prob_analyzer_->p_vars();  // Private copy!
   std::vector<double> samples;
   samples.reserve(Analysis::settings().num_trials());
 
+  bool biased = Analysis::settings().importance_sampling();
+  if (biased) {
+    UncertaintyAnalysis::PrepareImportanceSampling(
+        prob_analyzer_->products(), deviate_expressions, &p_vars);
+    weights->reserve(Analysis::settings().num_trials());
+  }
+
   for (int i = 0; i < Analysis::settings().num_trials(); ++i) {
-    UncertaintyAnalysis::SampleExpressions(deviate_expressions, &p_vars);
+    if (biased) {
+      weights->push_back(
+          UncertaintyAnalysis::SampleImportance(deviate_expressions, &p_vars));
+    } else {
+      UncertaintyAnalysis::SampleExpressions(deviate_expressions, &p_vars);
+    }
     double result = prob_analyzer_->CalculateTotalProbability(p_vars);
     assert(result >= 0 && result <= 1);
     samples.push_back(result);
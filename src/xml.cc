@@ -44,9 +44,135 @@ Document::Document(const std::string& file_path, Validator* validator)
     validator->validate(*this);
 }
 
+Reader::Reader(const std::string& file_path, Validator* validator)
+    : reader_(nullptr, &xmlFreeTextReader) {
+  xmlResetLastError();
+  reader_.reset(xmlReaderForFile(file_path.c_str(), nullptr, kParserOptions));
+  if (!reader_) {
+    xmlErrorPtr xml_error = xmlGetLastError();
+    if (!xml_error || xml_error->domain == xmlErrorDomain::XML_FROM_IO) {
+      SCRAM_THROW(IOError(xml_error ? xml_error->message
+                                    : "Cannot open the XML file."))
+          << boost::errinfo_file_name(file_path) << boost::errinfo_errno(errno)
+          << boost::errinfo_file_open_mode("r");
+    }
+    SCRAM_THROW(detail::GetError<LogicError>(xml_error));
+  }
+  if (validator &&
+      xmlTextReaderRelaxNGSetSchema(reader_.get(), validator->schema_.get())) {
+    SCRAM_THROW(detail::GetError<LogicError>());
+  }
+}
+
+void Reader::Validate() {
+  // Failed XInclude directives are reported as validity errors
+  // within the same read step as the XInclude error.
+  // The first non-validity error is intercepted to report the real cause.
+  struct ErrorTrap {
+    ErrorTrap() {
+      xmlSetStructuredErrorFunc(this, [](void* trap, xmlErrorPtr xml_error) {
+        xmlError& first = static_cast<ErrorTrap*>(trap)->first_error;
+        if (first.code == XML_ERR_OK &&
+            xml_error->domain != xmlErrorDomain::XML_FROM_RELAXNGV) {
+          xmlCopyError(xml_error, &first);
+        }
+        xmlGenericError(xmlGenericErrorContext, "%s:%d: %s",
+                        xml_error->file ? xml_error->file : "", xml_error->line,
+                        xml_error->message ? xml_error->message : "\n");
+      });
+    }
+    ~ErrorTrap() {
+      xmlSetStructuredErrorFunc(nullptr, nullptr);
+      xmlResetError(&first_error);
+    }
+    xmlError first_error = {};
+  } trap;
+
+  int ret;
+  while ((ret = xmlTextReaderRead(reader_.get())) == 1) {
+    // Any parser error is fatal like in the DOM document loading.
+    if (trap.first_error.code != XML_ERR_OK)
+      break;
+  }
+  if (trap.first_error.code != XML_ERR_OK || ret < 0)
+    ThrowError(trap.first_error.code != XML_ERR_OK ? &trap.first_error
+                                                   : nullptr);
+  if (xmlTextReaderIsValid(reader_.get()) == 0)
+    SCRAM_THROW(detail::GetError<ValidityError>());
+}
+
+std::optional<Element> Reader::NextChild() {
+  if (empty_parent_) {
+    empty_parent_ = false;
+    --depth_;
+    at_child_ = true;
+    return {};
+  }
+  for (;;) {
+    // Skipping empty elements with xmlTextReaderNext
+    // may prematurely end the XInclude-d content.
+    int ret = at_child_ && !xmlTextReaderIsEmptyElement(reader_.get())
+                  ? xmlTextReaderNext(reader_.get())
+                  : xmlTextReaderRead(reader_.get());
+    at_child_ = false;
+    if (ret < 0)
+      ThrowError();
+    if (ret == 0) {
+      assert(depth_ == -1 && "Premature end of the document.");
+      return {};
+    }
+    int depth = xmlTextReaderDepth(reader_.get());
+    if (depth <= depth_) {
+      assert(depth == depth_);
+      assert(xmlTextReaderNodeType(reader_.get()) ==
+             XML_READER_TYPE_END_ELEMENT);
+      --depth_;
+      return {};
+    }
+    if (depth == depth_ + 1 &&
+        xmlTextReaderNodeType(reader_.get()) == XML_READER_TYPE_ELEMENT) {
+      at_child_ = true;
+      return Element(reinterpret_cast<const xmlElement*>(
+          xmlTextReaderCurrentNode(reader_.get())));
+    }
+  }
+}
+
+void Reader::Enter() {
+  assert(at_child_ && "No element to enter.");
+  at_child_ = false;
+  depth_ = xmlTextReaderDepth(reader_.get());
+  empty_parent_ = xmlTextReaderIsEmptyElement(reader_.get()) == 1;
+}
+
+Element Reader::Expand() {
+  assert(at_child_ && "No element to expand.");
+  xmlNode* node = xmlTextReaderExpand(reader_.get());
+  if (!node)
+    ThrowError();
+  if (xmlXIncludeProcessTreeFlags(node, kParserOptions) < 0)
+    SCRAM_THROW(detail::GetError<XIncludeError>());
+  return Element(reinterpret_cast<const xmlElement*>(node));
+}
+
+void Reader::ThrowError(xmlErrorPtr xml_error) {
+  if (!xml_error)
+    xml_error = xmlGetLastError();
+  if (!xml_error)
+    SCRAM_THROW(ParseError("Unknown XML parsing failure."));
+  // The document file is already open,
+  // so any I/O failure comes from loading the included files.
+  if (xml_error->domain == xmlErrorDomain::XML_FROM_XINCLUDE ||
+      xml_error->domain == xmlErrorDomain::XML_FROM_IO) {
+    SCRAM_THROW(detail::GetError<XIncludeError>(xml_error));
+  }
+  SCRAM_THROW(detail::GetError<ParseError>(xml_error));
+}
+
 Validator::Validator(const std::string& rng_file)
     : schema_(nullptr, &xmlRelaxNGFree),
       valid_ctxt_(nullptr, &xmlRelaxNGFreeValidCtxt) {
+  xmlInitParser();  // The schema may be shared by concurrent readers.
   xmlResetLastError();
   std::unique_ptr<xmlRelaxNGParserCtxt, decltype(&xmlRelaxNGFreeParserCtxt)>
       parser_ctxt(xmlRelaxNGNewParserCtxt(rng_file.c_str()),
@@ -53,6 +53,7 @@
 #include <libxml/parser.h>
 #include <libxml/relaxng.h>
 #include <libxml/tree.h>
+#include <libxml/xmlreader.h>
 
 #include "error.h"
 
@@ -251,6 +252,14 @@ class Element {
     assert(element_);
   }
 
+  /// @returns true if both refer to the same node in the document.
+  bool operator==(const Element& other) const {
+    return element_ == other.element_;
+  }
+
+  /// @returns true if the elements refer to different nodes.
+  bool operator!=(const Element& other) const { return !(*this == other); }
+
   /// @returns The URI of the file containing the element.
   ///
   /// @pre The document has been loaded from a file.
@@ -433,8 +442,96 @@ class Document {
   std::unique_ptr<xmlDoc, decltype(&xmlFreeDoc)> doc_;  ///< The DOM document.
 };
 
+/// Streaming reader of XML documents.
+/// Unlike the DOM Document,
+/// the reader does not keep the whole document tree in memory.
+/// The elements are visited one at a time in the document order,
+/// and the subtrees of visited elements are released
+/// as soon as the reader moves past them.
+///
+/// The reader descends the element tree on demand:
+/// the children of the current element are visited only upon entering it;
+/// otherwise, the whole element subtree is skipped at once.
+///
+/// @note All XInclude directives are processed into the read data.
+///
+/// @note Readers may run concurrently in separate threads
+///       with their own validation contexts for the shared schema.
+///
+/// @warning The elements are valid only until the reader moves
+///          to the next sibling or the end of the parent element.
+class Reader {
+ public:
+  /// Opens the document for streaming.
+  ///
+  /// @param[in] file_path  The path to the document file.
+  /// @param[in] validator  Optional streaming validator against the RNG schema.
+  ///
+  /// @throws IOError  The file is not available.
+  /// @throws LogicError  The XML library functions have failed internally.
+  explicit Reader(const std::string& file_path,
+                  Validator* validator = nullptr);
+
+  /// Reads the document to the end
+  /// without exposing any elements to the caller,
+  /// for example, to check the document validity.
+  ///
+  /// @throws ParseError  There are XML parsing failures.
+  /// @throws XIncludeError  XInclude resolution has failed.
+  /// @throws ValidityError  The XML file is not valid.
+  void Validate();
+
+  /// Moves to the next child element of the current parent.
+  /// The subtree of the previously visited child is skipped
+  /// unless the reader has entered it.
+  /// The document root is the only child of the top level.
+  ///
+  /// @returns The child element with attributes only (no children yet),
+  ///          or None if the parent element has no more children.
+  ///
+  /// @post After None,
+  ///       the parent's parent becomes the current parent.
+  ///
+  /// @throws ParseError  There are XML parsing failures.
+  /// @throws XIncludeError  XInclude resolution has failed.
+  std::optional<Element> NextChild();
+
+  /// Makes the lastly visited child element the current parent
+  /// so that its children are visited next.
+  ///
+  /// @pre NextChild has returned an element.
+  void Enter();
+
+  /// Reads the whole subtree of the lastly visited child element.
+  ///
+  /// @returns The child element with all its descendants.
+  ///
+  /// @pre NextChild has returned an element.
+  ///
+  /// @throws ParseError  There are XML parsing failures.
+  /// @throws XIncludeError  XInclude resolution has failed.
+  Element Expand();
+
+ private:
+  /// Throws the error of the reader.
+  ///
+  /// @param[in] xml_error  The error to report instead of the last error.
+  ///
+  /// @throws ParseError  There are XML parsing failures.
+  /// @throws XIncludeError  XInclude resolution has failed.
+  [[noreturn]] void ThrowError(xmlErrorPtr xml_error = nullptr);
+
+  /// The XML library reader.
+  std::unique_ptr<xmlTextReader, decltype(&xmlFreeTextReader)> reader_;
+  int depth_ = -1;  ///< The depth of the current parent element.
+  bool at_child_ = false;  ///< The reader is at the visited child start.
+  bool empty_parent_ = false;  ///< The entered element has no children.
+};
+
 /// RelaxNG validator.
 class Validator {
+  friend class Reader;  // Streaming validation with the schema.
+
  public:
   /// @param[in] rng_file  The path to the schema file.
   ///
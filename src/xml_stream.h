@@ -22,12 +22,18 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cstring>
 
 #include <algorithm>
+#include <charconv>
 #include <exception>
+#include <memory>
+#include <new>
 #include <string>
+#include <system_error>
 
 #include <boost/exception/errinfo_errno.hpp>
+#include <zlib.h>
 
 #include "error.h"
 
@@ -99,48 +105,150 @@ class Indenter {
   char spaces[kMaxIndent + 1];  ///< The indentation and terminator.
 };
 
-/// Adaptor for stdio FILE stream with write generic interface.
+/// Buffered adaptor for stdio FILE stream with write generic interface.
+/// The data is accumulated in a user-space buffer
+/// and written into the file in large blocks,
+/// optionally compressed into the gzip format.
+/// Numbers are formatted with the shortest round-trip representation.
 ///
 /// @note Write operations do not return any error code or throw exceptions.
 ///       If any IO errors happen,
 ///       the FILE handler contains the error information.
 class FileStream {
  public:
+  static constexpr std::size_t kBufferSize = 1 << 16;  ///< In bytes.
+
   /// @param[in] file  The output file stream.
-  explicit FileStream(std::FILE* file) : file_(file) {}
+  /// @param[in] compress  The option to compress the output with gzip.
+  ///
+  /// @throws std::bad_alloc  The compressor cannot be initialized.
+  explicit FileStream(std::FILE* file, bool compress = false)
+      : file_(file), buffer_(new char[kBufferSize]), size_(0) {
+    if (compress) {
+      zstream_ = std::make_unique<z_stream>();  // Value-init for defaults.
+      // The window bits offset of 16 requests the gzip header and trailer.
+      if (deflateInit2(zstream_.get(), Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                       MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::bad_alloc();
+      }
+      compressed_.reset(new char[kBufferSize]);
+    }
+  }
+
+  FileStream(const FileStream&) = delete;
+  FileStream& operator=(const FileStream&) = delete;
+
+  /// Writes the remaining buffered data into the file.
+  ~FileStream() { close(); }
 
   /// @returns The destination file stream.
   std::FILE* file() { return file_; }
 
+  /// Writes the buffered data into the file.
+  void flush() {
+    if (size_) {
+      Put(buffer_.get(), size_);
+      size_ = 0;
+    }
+  }
+
+  /// Flushes the buffered data
+  /// and finalizes the compressed stream if any.
+  ///
+  /// @post No more writes are expected.
+  void close() {
+    flush();
+    if (zstream_) {
+      Deflate(nullptr, 0, Z_FINISH);
+      deflateEnd(zstream_.get());
+      zstream_.reset();
+    }
+  }
+
   /// Writes a value into file.
   /// @{
-  void write(const std::string& value) { write(value.c_str()); }
-  void write(const char* value) { std::fputs(value, file_); }
-  void write(const char value) { std::fputc(value, file_); }
-  void write(int value) {
-    if (value < 0) {
-      std::fputc('-', file_);
-      value = -value;
+  void write(const std::string& value) { Append(value.data(), value.size()); }
+  void write(const char* value) { Append(value, std::strlen(value)); }
+  void write(const char value) {
+    if (size_ == kBufferSize)
+      flush();
+    buffer_[size_++] = value;
+  }
+  void write(int value) { WriteNumber(value); }
+  void write(std::size_t value) { WriteNumber(value); }
+  void write(double value) { WriteNumber(value); }
+  /// @}
+
+ private:
+  /// Appends the data into the buffer
+  /// or directly into the file if the data is larger than the buffer.
+  ///
+  /// @param[in] data  The characters to write.
+  /// @param[in] size  The number of characters.
+  void Append(const char* data, std::size_t size) {
+    if (size_ + size > kBufferSize) {
+      flush();
+      if (size > kBufferSize) {
+        Put(data, size);
+        return;
+      }
     }
-    write(static_cast<std::size_t>(value));
+    std::memcpy(buffer_.get() + size_, data, size);
+    size_ += size;
+  }
+
+  /// Formats the number directly into the buffer.
+  ///
+  /// @param[in] value  The integer or floating-point number.
+  template <typename T>
+  void WriteNumber(T value) {
+    const std::size_t kMaxChars = 32;  // Enough for the shortest double.
+    if (size_ + kMaxChars > kBufferSize)
+      flush();
+    char* first = buffer_.get() + size_;
+    auto [last, ec] = std::to_chars(first, first + kMaxChars, value);
+    assert(ec == std::errc() && "Insufficient space for the number.");
+    (void)ec;
+    size_ = last - buffer_.get();
   }
-  void write(std::size_t value) {
-    char temp[20];
-    char* p = temp;
-    do {
-      *p++ = value % 10 + '0';
-      value /= 10;
-    } while (value > 0);
 
+  /// Passes the data to the file bypassing the buffer.
+  ///
+  /// @param[in] data  The characters to write.
+  /// @param[in] size  The number of characters.
+  void Put(const char* data, std::size_t size) {
+    if (zstream_) {
+      Deflate(data, size, Z_NO_FLUSH);
+    } else {
+      std::fwrite(data, 1, size, file_);
+    }
+  }
+
+  /// Compresses the data and writes the produced output into the file.
+  ///
+  /// @param[in] data  The characters to compress.
+  /// @param[in] size  The number of characters.
+  /// @param[in] mode  The zlib flush mode.
+  void Deflate(const char* data, std::size_t size, int mode) {
+    zstream_->next_in =
+        reinterpret_cast<Bytef*>(const_cast<char*>(data));  // Old zlib API.
+    zstream_->avail_in = size;
     do {
-      std::fputc(*--p, file_);
-    } while (p != temp);
+      zstream_->next_out = reinterpret_cast<Bytef*>(compressed_.get());
+      zstream_->avail_out = kBufferSize;
+      [[maybe_unused]] int ret = deflate(zstream_.get(), mode);
+      assert(ret != Z_STREAM_ERROR && "Corrupted compression state.");
+      std::fwrite(compressed_.get(), 1, kBufferSize - zstream_->avail_out,
+                  file_);
+    } while (zstream_->avail_out == 0);
+    assert(zstream_->avail_in == 0 && "Unconsumed data for compression.");
   }
-  void write(double value) { std::fprintf(file_, "%g", value); }
-  /// @}
 
- private:
   std::FILE* file_;  ///< The destination file.
+  std::unique_ptr<char[]> buffer_;  ///< The output buffer.
+  std::size_t size_;  ///< The number of buffered characters.
+  std::unique_ptr<z_stream> zstream_;  ///< The optional gzip compressor.
+  std::unique_ptr<char[]> compressed_;  ///< The compressor output buffer.
 };
 
 /// Convenience wrapper to provide C++ stream-like interface.
@@ -413,13 +521,14 @@ class Stream {
   ///
   /// @param[in] out  The stream destination.
   /// @param[in] indent  Option to indent output for readability.
+  /// @param[in] compress  Option to compress the document with gzip.
   ///
   /// @note This output file has clean error state.
-  explicit Stream(std::FILE* out, bool indent = true)
+  explicit Stream(std::FILE* out, bool indent = true, bool compress = false)
       : indenter_(indent),
         has_root_(false),
         uncaught_exceptions_(std::uncaught_exceptions()),
-        out_(out) {
+        out_(out, compress) {
     assert(!std::ferror(out) && "Unclean error state in output destination.");
     out_ << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
   }
@@ -428,6 +537,7 @@ class Stream {
   ///
   /// @post The exception is thrown only if no other exception is on flight.
   ~Stream() noexcept(false) {
+    out_.close();
     int err = std::ferror(out_.file());
     if (err && (std::uncaught_exceptions() == uncaught_exceptions_))
       SCRAM_THROW(IOError("FILE error on write")) << boost::errinfo_errno(err);
@@ -23,6 +23,7 @@
 #include <cstdlib>
 
 #include <algorithm>
+#include <string>
 
 #include <boost/range/algorithm.hpp>
 
@@ -59,6 +60,39 @@ void Zbdd::Log() noexcept {
   ClearMarks(root_, false);
 }
 
+void Zbdd::GatherMetrics(std::vector<Metric>* metrics) noexcept {
+  int num_nodes = 0;
+  int peak_table = 0;
+  int num_modules = 0;
+  TableStats stats;
+  std::vector<Metric> products;
+  std::vector<Zbdd*> zbdds = {this};
+  while (!zbdds.empty()) {
+    Zbdd* zbdd = zbdds.back();
+    zbdds.pop_back();
+    num_nodes += zbdd->set_id_ - 1;
+    peak_table = std::max(peak_table, zbdd->unique_table_.peak_size());
+    stats.lookups += zbdd->compute_stats_.lookups;
+    stats.hits += zbdd->compute_stats_.hits;
+    std::int64_t count = zbdd->CountProducts(zbdd->root_, false);
+    zbdd->ClearMarks(zbdd->root_, false);
+    products.push_back(
+        {zbdd == this ? "products/root"
+                      : "products/G" + std::to_string(zbdd->module_index_),
+         double(count)});
+    for (const ModuleEntry& module : zbdd->modules_) {
+      ++num_modules;
+      zbdds.push_back(module.second.get());
+    }
+  }
+  metrics->push_back({"zbdd-nodes", double(num_nodes)});
+  metrics->push_back({"zbdd-unique-table-peak", double(peak_table)});
+  metrics->push_back({"zbdd-compute-lookups", double(stats.lookups)});
+  metrics->push_back({"zbdd-compute-hit-rate", stats.hit_rate()});
+  metrics->push_back({"zbdd-modules", double(num_modules)});
+  metrics->insert(metrics->end(), products.begin(), products.end());
+}
+
 Zbdd::Zbdd(Bdd* bdd, const Settings& settings) noexcept
     : Zbdd(bdd->root(), bdd->coherent(), bdd, settings) {
   CHECK_ZBDD(true);
@@ -380,158 +414,18 @@ Triplet Zbdd::GetResultKey(const VertexPtr& arg_one, const VertexPtr& arg_two,
   return {min_id, max_id, order};
 }
 
-/// Forward declarations of interdependent Apply operation specializations.
-/// @{
-template <>
-Zbdd::VertexPtr Zbdd::Apply<kAnd>(const VertexPtr& arg_one,
-                                  const VertexPtr& arg_two,
-                                  int limit_order) noexcept;
-template <>
-Zbdd::VertexPtr Zbdd::Apply<kOr>(const VertexPtr& arg_one,
-                                 const VertexPtr& arg_two,
-                                 int limit_order) noexcept;
-/// @}
-
-/// Specialization of Apply for AND connective for non-terminal ZBDD vertices.
-template <>
-Zbdd::VertexPtr Zbdd::Apply<kAnd>(const SetNodePtr& arg_one,
-                                  const SetNodePtr& arg_two,
-                                  int limit_order) noexcept {
-  VertexPtr high;
-  VertexPtr low;
-  int limit_high = limit_order - !MayBeUnity(*arg_one);
-  if (arg_one->order() == arg_two->order() &&
-      arg_one->index() == arg_two->index()) {  // The same variable.
-    // (x*f1 + f0) * (x*g1 + g0) = x*(f1*(g1 + g0) + f0*g1) + f0*g0
-    high = Apply<kOr>(
-        Apply<kAnd>(arg_one->high(),
-                    Apply<kOr>(arg_two->high(), arg_two->low(), limit_high),
-                    limit_high),
-        Apply<kAnd>(arg_one->low(), arg_two->high(), limit_high), limit_high);
-    low = Apply<kAnd>(arg_one->low(), arg_two->low(), limit_order);
-  } else {
-    assert((arg_one->order() < arg_two->order() ||
-            arg_one->index() > arg_two->index()) &&
-           "Ordering contract failed.");
-    if (arg_one->order() == arg_two->order()) {
-      // (x*f1 + f0) * (~x*g1 + g0) = x*f1*g0 + f0*(~x*g1 + g0)
-      high = Apply<kAnd>(arg_one->high(), arg_two->low(), limit_high);
-    } else {
-      high = Apply<kAnd>(arg_one->high(), arg_two, limit_high);
-    }
-    low = Apply<kAnd>(arg_one->low(), arg_two, limit_order);
-  }
-  if (!high->terminal() && SetNode::Ref(high).order() == arg_one->order()) {
-    assert(SetNode::Ref(high).index() < arg_one->index());
-    high = SetNode::Ref(high).low();
-  }
-  return Minimize(GetReducedVertex(arg_one, high, low));
-}
-
-/// Specialization of Apply for AND connective for any ZBDD vertices.
 template <>
 Zbdd::VertexPtr Zbdd::Apply<kAnd>(const VertexPtr& arg_one,
                                   const VertexPtr& arg_two,
                                   int limit_order) noexcept {
-  if (limit_order < 0)
-    return kEmpty_;
-  if (arg_one->terminal()) {
-    if (Terminal<SetNode>::Ref(arg_one).value())
-      return Prune(arg_two, limit_order);
-    return kEmpty_;
-  }
-  if (arg_two->terminal()) {
-    if (Terminal<SetNode>::Ref(arg_two).value())
-      return Prune(arg_one, limit_order);
-    return kEmpty_;
-  }
-  if (arg_one->id() == arg_two->id())
-    return Prune(arg_one, limit_order);
-
-  VertexPtr& result = and_table_[GetResultKey(arg_one, arg_two, limit_order)];
-  if (result)
-    return result;  // Already computed.
-
-  SetNodePtr set_one = SetNode::Ptr(arg_one);
-  SetNodePtr set_two = SetNode::Ptr(arg_two);
-  if (set_one->order() > set_two->order()) {
-    std::swap(set_one, set_two);
-  } else if (set_one->order() == set_two->order() &&
-             set_one->index() < set_two->index()) {
-    std::swap(set_one, set_two);
-  }
-  result = Apply<kAnd>(set_one, set_two, limit_order);
-  assert(result->terminal() ||
-         SetNode::Ref(result).max_set_order() <= limit_order);
-  return result;
-}
-
-/// Specialization of Apply for OR connective for non-terminal ZBDD vertices.
-template <>
-Zbdd::VertexPtr Zbdd::Apply<kOr>(const SetNodePtr& arg_one,
-                                 const SetNodePtr& arg_two,
-                                 int limit_order) noexcept {
-  VertexPtr high;
-  VertexPtr low;
-  int limit_high = limit_order - !MayBeUnity(*arg_one);
-  if (arg_one->order() == arg_two->order() &&
-      arg_one->index() == arg_two->index()) {  // The same variable.
-    high = Apply<kOr>(arg_one->high(), arg_two->high(), limit_high);
-    low = Apply<kOr>(arg_one->low(), arg_two->low(), limit_order);
-  } else {
-    assert((arg_one->order() < arg_two->order() ||
-            arg_one->index() > arg_two->index()) &&
-           "Ordering contract failed.");
-    if (arg_one->order() == arg_two->order()) {
-      if (arg_one->high()->terminal() && arg_two->high()->terminal())
-        return kBase_;
-    }
-    high = Prune(arg_one->high(), limit_high);
-    low = Apply<kOr>(arg_one->low(), arg_two, limit_order);
-  }
-  if (!high->terminal() && SetNode::Ref(high).order() == arg_one->order()) {
-    assert(SetNode::Ref(high).index() < arg_one->index());
-    high = SetNode::Ref(high).low();
-  }
-  return Minimize(GetReducedVertex(arg_one, high, low));
+  return Run(Operation::kAnd, arg_one, arg_two, limit_order);
 }
 
-/// Specialization of Apply for OR connective for any ZBDD vertices.
 template <>
 Zbdd::VertexPtr Zbdd::Apply<kOr>(const VertexPtr& arg_one,
                                  const VertexPtr& arg_two,
                                  int limit_order) noexcept {
-  if (limit_order < 0)
-    return kEmpty_;
-  if (arg_one->terminal()) {
-    if (Terminal<SetNode>::Ref(arg_one).value())
-      return kBase_;
-    return Prune(arg_two, limit_order);
-  }
-  if (arg_two->terminal()) {
-    if (Terminal<SetNode>::Ref(arg_two).value())
-      return kBase_;
-    return Prune(arg_one, limit_order);
-  }
-  if (arg_one->id() == arg_two->id())
-    return Prune(arg_one, limit_order);
-
-  VertexPtr& result = or_table_[GetResultKey(arg_one, arg_two, limit_order)];
-  if (result)
-    return result;  // Already computed.
-
-  SetNodePtr set_one = SetNode::Ptr(arg_one);
-  SetNodePtr set_two = SetNode::Ptr(arg_two);
-  if (set_one->order() > set_two->order()) {
-    std::swap(set_one, set_two);
-  } else if (set_one->order() == set_two->order() &&
-             set_one->index() < set_two->index()) {
-    std::swap(set_one, set_two);
-  }
-  result = Apply<kOr>(set_one, set_two, limit_order);
-  assert(result->terminal() ||
-         SetNode::Ref(result).max_set_order() <= limit_order);
-  return result;
+  return Run(Operation::kOr, arg_one, arg_two, limit_order);
 }
 
 Zbdd::VertexPtr Zbdd::Apply(Connective type, const VertexPtr& arg_one,
@@ -611,91 +505,425 @@ Zbdd::VertexPtr Zbdd::EliminateConstantModule(const SetNodePtr& node,
 }
 
 Zbdd::VertexPtr Zbdd::Minimize(const VertexPtr& vertex) noexcept {
-  if (vertex->terminal())
-    return vertex;
-  SetNodePtr node = SetNode::Ptr(vertex);
-  if (node->minimal())
-    return vertex;
-  VertexPtr& result = minimal_results_[vertex->id()];
-  if (result)
-    return result;
-  VertexPtr high = Minimize(node->high());
-  VertexPtr low = Minimize(node->low());
-  high = Subsume(high, low);
-  assert(high->id() != low->id() && "Subsume failed!");
-  if (high->terminal() && !Terminal<SetNode>::Ref(high).value()) {
-    result = low;  // Reduction rule.
-    return result;
-  }
-  result = FindOrAddVertex(node, high, low);
-  SetNode::Ref(result).minimal(true);
-  return result;
+  return Run(Operation::kMinimize, vertex, nullptr, 0);
 }
 
 Zbdd::VertexPtr Zbdd::Subsume(const VertexPtr& high,
                               const VertexPtr& low) noexcept {
-  if (low->terminal())
-    return Terminal<SetNode>::Ref(low).value() ? kEmpty_ : high;
-  if (high->terminal())
-    return high;  // No need to reduce terminal sets.
-  VertexPtr& computed = subsume_table_[{high->id(), low->id()}];
-  if (computed)
-    return computed;
-
-  SetNodePtr high_node = SetNode::Ptr(high);
-  SetNodePtr low_node = SetNode::Ptr(low);
-  if (high_node->order() > low_node->order() ||
-      (high_node->order() == low_node->order() &&
-       high_node->index() < low_node->index())) {
-    computed = Subsume(high, low_node->low());
-    return computed;
-  }
-  VertexPtr subhigh;
-  VertexPtr sublow;
-  if (high_node->order() == low_node->order() &&
-      high_node->index() == low_node->index()) {
-    assert(high_node->index() == low_node->index());
-    subhigh = Subsume(high_node->high(), low_node->high());
-    subhigh = Subsume(subhigh, low_node->low());
-    sublow = Subsume(high_node->low(), low_node->low());
-  } else {
-    assert(high_node->order() < low_node->order() ||
-           (high_node->order() == low_node->order() &&
-            high_node->index() > low_node->index()));
-    subhigh = Subsume(high_node->high(), low);
-    sublow = Subsume(high_node->low(), low);
+  return Run(Operation::kSubsume, high, low, 0);
+}
+
+Zbdd::VertexPtr Zbdd::Prune(const VertexPtr& vertex, int limit_order) noexcept {
+  return Run(Operation::kPrune, vertex, nullptr, limit_order);
+}
+
+Zbdd::VertexPtr Zbdd::Run(Operation operation, const VertexPtr& arg_one,
+                          const VertexPtr& arg_two, int limit_order) noexcept {
+  VertexPtr result;
+  if (Call(operation, arg_one, arg_two, limit_order, &result))
+    return result;
+  int base = operation_stack_.size() - 1;  // Reentrant with the base.
+  do {
+    if (Resume(&operation_stack_.back(), &result))
+      operation_stack_.pop_back();
+  } while (operation_stack_.size() > base);
+  return result;
+}
+
+void Zbdd::Push(Operation operation, const VertexPtr& arg_one,
+                const VertexPtr& arg_two, int limit_order,
+                VertexPtr* result) noexcept {
+  int limit_high = limit_order;
+  if (operation != Operation::kMinimize && operation != Operation::kSubsume)
+    limit_high -= !MayBeUnity(SetNode::Ref(arg_one));
+  operation_stack_.push_back({operation, 0, arg_one, arg_two, limit_order,
+                              limit_high, result, nullptr, nullptr});
+}
+
+bool Zbdd::Call(Operation operation, const VertexPtr& arg_one,
+                const VertexPtr& arg_two, int limit_order,
+                VertexPtr* result) noexcept {
+  switch (operation) {
+    case Operation::kAnd:
+    case Operation::kOr:
+      return CallApply(operation == Operation::kAnd, arg_one, arg_two,
+                       limit_order, result);
+    case Operation::kMinimize:
+      return CallMinimize(arg_one, result);
+    case Operation::kSubsume:
+      return CallSubsume(arg_one, arg_two, result);
+    case Operation::kPrune:
+      return CallPrune(arg_one, limit_order, result);
+  }
+  assert(false && "Unknown ZBDD operation.");
+  return false;
+}
+
+bool Zbdd::CallApply(bool is_and, const VertexPtr& arg_one,
+                     const VertexPtr& arg_two, int limit_order,
+                     VertexPtr* result) noexcept {
+  if (limit_order < 0) {
+    *result = kEmpty_;
+    return true;
+  }
+  if (arg_one->terminal() || arg_two->terminal()) {
+    const VertexPtr& terminal = arg_one->terminal() ? arg_one : arg_two;
+    const VertexPtr& other = arg_one->terminal() ? arg_two : arg_one;
+    if (Terminal<SetNode>::Ref(terminal).value() == is_and)
+      return CallPrune(other, limit_order, result);
+    *result = is_and ? kEmpty_ : kBase_;
+    return true;
+  }
+  if (arg_one->id() == arg_two->id())
+    return CallPrune(arg_one, limit_order, result);
+
+  VertexPtr& computed = (is_and ? and_table_ : or_table_)[GetResultKey(
+      arg_one, arg_two, limit_order)];
+  ++compute_stats_.lookups;
+  if (computed) {
+    ++compute_stats_.hits;
+    *result = computed;
+    return true;
+  }
+  const VertexPtr* top = &arg_one;
+  const VertexPtr* other = &arg_two;
+  const SetNode* set_one = &SetNode::Ref(arg_one);
+  const SetNode* set_two = &SetNode::Ref(arg_two);
+  if (set_one->order() > set_two->order() ||
+      (set_one->order() == set_two->order() &&
+       set_one->index() < set_two->index())) {
+    std::swap(top, other);
+    std::swap(set_one, set_two);
   }
-  if (subhigh->terminal() && !Terminal<SetNode>::Ref(subhigh).value()) {
-    computed = sublow;
-    return computed;
+  if (!is_and && set_one->order() == set_two->order() &&
+      set_one->index() != set_two->index() && set_one->high()->terminal() &&
+      set_two->high()->terminal()) {
+    // (x + f0) + (~x + g0) = 1
+    computed = kBase_;
+    *result = kBase_;
+    return true;
   }
-  assert(subhigh->id() != sublow->id());
-  SetNodePtr new_high = FindOrAddVertex(high_node, subhigh, sublow);
-  new_high->minimal(high_node->minimal());
-  computed = new_high;
-  return computed;
+  Push(is_and ? Operation::kAnd : Operation::kOr, *top, *other, limit_order,
+       &computed);
+  return false;
 }
 
-Zbdd::VertexPtr Zbdd::Prune(const VertexPtr& vertex, int limit_order) noexcept {
-  if (limit_order < 0)
-    return kEmpty_;
-  if (vertex->terminal())
-    return vertex;
+bool Zbdd::CallMinimize(const VertexPtr& vertex, VertexPtr* result) noexcept {
+  if (vertex->terminal() || SetNode::Ref(vertex).minimal()) {
+    *result = vertex;
+    return true;
+  }
+  VertexPtr& computed = minimal_results_[vertex->id()];
+  if (computed) {
+    *result = computed;
+    return true;
+  }
+  Push(Operation::kMinimize, vertex, nullptr, 0, &computed);
+  return false;
+}
 
-  SetNodePtr node = SetNode::Ptr(vertex);
-  if (node->max_set_order() <= limit_order)
-    return node;
+bool Zbdd::CallSubsume(const VertexPtr& high, const VertexPtr& low_arg,
+                       VertexPtr* result) noexcept {
+  if (high->terminal()) {  // No need to reduce terminal sets.
+    *result = low_arg->terminal() && Terminal<SetNode>::Ref(low_arg).value()
+                  ? kEmpty_
+                  : high;
+    return true;
+  }
+  // The low sets with variables before the high variable
+  // cannot be subsets of the high sets.
+  const SetNode& high_node = SetNode::Ref(high);
+  const VertexPtr* low = &low_arg;
+  while (!(*low)->terminal()) {
+    const SetNode& low_node = SetNode::Ref(*low);
+    if (high_node.order() < low_node.order() ||
+        (high_node.order() == low_node.order() &&
+         high_node.index() >= low_node.index())) {
+      break;
+    }
+    low = &low_node.low();
+  }
+  if ((*low)->terminal()) {
+    *result = Terminal<SetNode>::Ref(*low).value() ? kEmpty_ : high;
+    return true;
+  }
+  VertexPtr& computed = subsume_table_[{high->id(), (*low)->id()}];
+  if (computed) {
+    *result = computed;
+    return true;
+  }
+  Push(Operation::kSubsume, high, *low, 0, &computed);
+  return false;
+}
 
-  VertexPtr& result = prune_results_[{node->id(), limit_order}];
-  if (result)
-    return result;
+bool Zbdd::CallPrune(const VertexPtr& vertex, int limit_order,
+                     VertexPtr* result) noexcept {
+  if (limit_order < 0) {
+    *result = kEmpty_;
+    return true;
+  }
+  if (vertex->terminal() ||
+      SetNode::Ref(vertex).max_set_order() <= limit_order) {
+    *result = vertex;
+    return true;
+  }
+  VertexPtr& computed = prune_results_[{vertex->id(), limit_order}];
+  if (computed) {
+    *result = computed;
+    return true;
+  }
+  Push(Operation::kPrune, vertex, nullptr, limit_order, &computed);
+  return false;
+}
 
-  int limit_high = limit_order - !MayBeUnity(*node);
-  result = GetReducedVertex(node, Prune(node->high(), limit_high),
-                            Prune(node->low(), limit_order));
-  if (!result->terminal())
-    SetNode::Ref(result).minimal(node->minimal());
-  return result;
+bool Zbdd::Resume(Frame* frame, VertexPtr* result) noexcept {
+  switch (frame->operation) {
+    case Operation::kAnd:
+      return ResumeAnd(frame, result);
+    case Operation::kOr:
+      return ResumeOr(frame, result);
+    case Operation::kMinimize:
+      return ResumeMinimize(frame, result);
+    case Operation::kSubsume:
+      return ResumeSubsume(frame, result);
+    case Operation::kPrune:
+      return ResumePrune(frame, result);
+  }
+  assert(false && "Unknown ZBDD operation.");
+  return true;
+}
+
+bool Zbdd::ResumeAnd(Frame* frame, VertexPtr* result) noexcept {
+  const SetNode& one = SetNode::Ref(frame->one);
+  const SetNode& two = SetNode::Ref(frame->two);
+  bool same_variable =
+      one.order() == two.order() && one.index() == two.index();
+  assert((same_variable || one.order() < two.order() ||
+          one.index() > two.index()) &&
+         "Ordering contract failed.");
+  VertexPtr& high = frame->high;
+  VertexPtr& low = frame->low;
+  int limit_high = frame->limit_high;
+  // (x*f1 + f0) * (x*g1 + g0) = x*(f1*(g1 + g0) + f0*g1) + f0*g0
+  // (x*f1 + f0) * (~x*g1 + g0) = x*f1*g0 + f0*(~x*g1 + g0)
+  // (x*f1 + f0) * g = x*f1*g + f0*g
+  for (;;) {
+    switch (frame->stage++) {
+      case 0:
+        if (same_variable) {
+          if (!CallApply(true, one.low(), two.high(), limit_high, result))
+            return false;
+          break;
+        }
+        frame->stage = 4;  // The high branch in a single operation.
+        if (!CallApply(true, one.high(),
+                       one.order() == two.order() ? two.low() : frame->two,
+                       limit_high, result)) {
+          return false;
+        }
+        break;
+      case 1:
+        low = std::move(*result);  // Temporary f0*g1.
+        if (!CallApply(false, two.high(), two.low(), limit_high, result))
+          return false;
+        break;
+      case 2:
+        high = std::move(*result);
+        if (!CallApply(true, one.high(), high, limit_high, result))
+          return false;
+        break;
+      case 3:
+        high = std::move(*result);
+        if (!CallApply(false, high, low, limit_high, result))
+          return false;
+        break;
+      case 4:
+        high = std::move(*result);
+        if (!CallApply(true, one.low(), same_variable ? two.low() : frame->two,
+                       frame->limit_order, result)) {
+          return false;
+        }
+        break;
+      case 5:
+        low = std::move(*result);
+        if (!CallReduce(frame, result))
+          return false;
+        break;
+      default:
+        *frame->result = *result;
+        assert((*result)->terminal() ||
+               SetNode::Ref(*result).max_set_order() <= frame->limit_order);
+        return true;
+    }
+  }
+}
+
+bool Zbdd::ResumeOr(Frame* frame, VertexPtr* result) noexcept {
+  const SetNode& one = SetNode::Ref(frame->one);
+  const SetNode& two = SetNode::Ref(frame->two);
+  bool same_variable =
+      one.order() == two.order() && one.index() == two.index();
+  assert((same_variable || one.order() < two.order() ||
+          one.index() > two.index()) &&
+         "Ordering contract failed.");
+  for (;;) {
+    switch (frame->stage++) {
+      case 0:
+        if (same_variable) {
+          if (!CallApply(false, one.high(), two.high(), frame->limit_high,
+                         result)) {
+            return false;
+          }
+        } else if (!CallPrune(one.high(), frame->limit_high, result)) {
+          return false;
+        }
+        break;
+      case 1:
+        frame->high = std::move(*result);
+        if (!CallApply(false, one.low(),
+                       same_variable ? two.low() : frame->two,
+                       frame->limit_order, result)) {
+          return false;
+        }
+        break;
+      case 2:
+        frame->low = std::move(*result);
+        if (!CallReduce(frame, result))
+          return false;
+        break;
+      default:
+        *frame->result = *result;
+        assert((*result)->terminal() ||
+               SetNode::Ref(*result).max_set_order() <= frame->limit_order);
+        return true;
+    }
+  }
+}
+
+bool Zbdd::CallReduce(Frame* frame, VertexPtr* result) noexcept {
+  SetNodePtr node = SetNode::Ptr(frame->one);
+  VertexPtr& high = frame->high;
+  if (!high->terminal() && SetNode::Ref(high).order() == node->order()) {
+    assert(SetNode::Ref(high).index() < node->index());
+    high = SetNode::Ref(high).low();
+  }
+  VertexPtr reduced = GetReducedVertex(node, high, frame->low);
+  return CallMinimize(reduced, result);
+}
+
+bool Zbdd::ResumeMinimize(Frame* frame, VertexPtr* result) noexcept {
+  const SetNode& node = SetNode::Ref(frame->one);
+  VertexPtr& high = frame->high;
+  VertexPtr& low = frame->low;
+  for (;;) {
+    switch (frame->stage++) {
+      case 0:
+        if (!CallMinimize(node.high(), result))
+          return false;
+        break;
+      case 1:
+        high = std::move(*result);
+        if (!CallMinimize(node.low(), result))
+          return false;
+        break;
+      case 2:
+        low = std::move(*result);
+        if (!CallSubsume(high, low, result))
+          return false;
+        break;
+      default:
+        high = std::move(*result);
+        assert(high->id() != low->id() && "Subsume failed!");
+        if (high->terminal() && !Terminal<SetNode>::Ref(high).value()) {
+          *result = low;  // Reduction rule.
+        } else {
+          SetNodePtr minimal =
+              FindOrAddVertex(SetNode::Ptr(frame->one), high, low);
+          minimal->minimal(true);
+          *result = std::move(minimal);
+        }
+        *frame->result = *result;
+        return true;
+    }
+  }
+}
+
+bool Zbdd::ResumeSubsume(Frame* frame, VertexPtr* result) noexcept {
+  const SetNode& high_node = SetNode::Ref(frame->one);
+  const SetNode& low_node = SetNode::Ref(frame->two);
+  bool same_variable = high_node.order() == low_node.order() &&
+                       high_node.index() == low_node.index();
+  VertexPtr& subhigh = frame->high;
+  VertexPtr& sublow = frame->low;
+  for (;;) {
+    switch (frame->stage++) {
+      case 0:
+        if (same_variable) {
+          if (!CallSubsume(high_node.high(), low_node.high(), result))
+            return false;
+          break;
+        }
+        assert(high_node.order() < low_node.order() ||
+               (high_node.order() == low_node.order() &&
+                high_node.index() > low_node.index()));
+        frame->stage = 2;  // The low branch is the same.
+        if (!CallSubsume(high_node.high(), frame->two, result))
+          return false;
+        break;
+      case 1:
+        subhigh = std::move(*result);
+        if (!CallSubsume(subhigh, low_node.low(), result))
+          return false;
+        break;
+      case 2:
+        subhigh = std::move(*result);
+        if (!CallSubsume(high_node.low(),
+                         same_variable ? low_node.low() : frame->two,
+                         result)) {
+          return false;
+        }
+        break;
+      case 3:
+        sublow = std::move(*result);
+        if (subhigh->terminal() && !Terminal<SetNode>::Ref(subhigh).value()) {
+          *result = sublow;
+        } else {
+          assert(subhigh->id() != sublow->id());
+          SetNodePtr new_high =
+              FindOrAddVertex(SetNode::Ptr(frame->one), subhigh, sublow);
+          new_high->minimal(high_node.minimal());
+          *result = std::move(new_high);
+        }
+        [[fallthrough]];
+      default:
+        *frame->result = *result;
+        return true;
+    }
+  }
+}
+
+bool Zbdd::ResumePrune(Frame* frame, VertexPtr* result) noexcept {
+  const SetNode& node = SetNode::Ref(frame->one);
+  for (;;) {
+    switch (frame->stage++) {
+      case 0:
+        if (!CallPrune(node.low(), frame->limit_order, result))
+          return false;
+        break;
+      case 1:
+        frame->low = std::move(*result);
+        if (!CallPrune(node.high(), frame->limit_high, result))
+          return false;
+        break;
+      default:
+        *result =
+            GetReducedVertex(SetNode::Ptr(frame->one), *result, frame->low);
+        if (!(*result)->terminal())
+          SetNode::Ref(*result).minimal(node.minimal());
+        *frame->result = *result;
+        return true;
+    }
+  }
 }
 
 bool Zbdd::MayBeUnity(const SetNode& node) noexcept {
@@ -745,40 +973,125 @@ void Zbdd::ApplySubstitutions(
     const std::vector<Pdag::Substitution>& substitutions) noexcept {
   if (substitutions.empty())
     return;
+  TIMER(DEBUG3, "Applying substitutions");
   ClearTables();
   unique_table_.clear();  // New ordering for nodes.
 
-  VertexPtr new_root = kEmpty_;
-  for (const std::vector<int>& product : *this) {
-    std::vector<int> to_add;
-    std::vector<int> to_remove;
-    for (const Pdag::Substitution& substitution : substitutions) {
-      if (ext::all_of(substitution.hypothesis, [&product](int id) {
-            return boost::find(product, id) != product.end();
-          })) {
-        to_remove.insert(to_remove.end(), substitution.source.begin(),
-                         substitution.source.end());
-        if (substitution.target)
-          to_add.push_back(substitution.target);
-      }
-    }
-    VertexPtr new_product = kBase_;
-    for (int id : product) {
-      if (boost::find(to_remove, id) != to_remove.end())
-        continue;
-      new_product = Apply<kAnd>(
-          new_product, FindOrAddVertex(id, kBase_, kEmpty_, std::abs(id)),
-          kSettings_.limit_order());
+  std::unordered_map<int, VertexPtr> results;
+  VertexPtr products = ExpandModules(root_, *this, &results);
+  results.clear();
+  root_ = Minimize(Substitute(products, substitutions, 0, {}, {}));
+}
+
+Zbdd::VertexPtr
+Zbdd::ExpandModules(const VertexPtr& vertex, const Zbdd& owner,
+                    std::unordered_map<int, VertexPtr>* results) noexcept {
+  if (vertex->terminal())
+    return Terminal<SetNode>::Ref(vertex).value() ? kBase_ : kEmpty_;
+  VertexPtr& result = (*results)[vertex->id()];
+  if (result)
+    return result;
+  const SetNode& node = SetNode::Ref(vertex);
+  VertexPtr high = ExpandModules(node.high(), owner, results);
+  VertexPtr low = ExpandModules(node.low(), owner, results);
+  VertexPtr sets;
+  if (node.module()) {
+    const Zbdd& module = *owner.modules_.find(node.index())->second;
+    std::unordered_map<int, VertexPtr> module_results;
+    sets = ExpandModules(module.root_, module, &module_results);
+  } else {
+    sets = FindOrAddVertex(node.index(), kBase_, kEmpty_,
+                           std::abs(node.index()));
+  }
+  int limit_order = kSettings_.limit_order();
+  result = Apply<kOr>(Apply<kAnd>(sets, high, limit_order), low, limit_order);
+  return result;
+}
+
+Zbdd::VertexPtr
+Zbdd::Substitute(const VertexPtr& vertex,
+                 const std::vector<Pdag::Substitution>& substitutions,
+                 int index, std::vector<int> source,
+                 std::vector<int> target) noexcept {
+  if (vertex->terminal() && !Terminal<SetNode>::Ref(vertex).value())
+    return kEmpty_;
+  int limit_order = kSettings_.limit_order();
+  if (index == substitutions.size()) {
+    VertexPtr result = vertex;
+    for (int id : source) {
+      std::unordered_map<int, VertexPtr> results;
+      result = Remove(result, id, &results);
     }
-    for (int id : to_add) {
-      new_product = Apply<kAnd>(
-          new_product, FindOrAddVertex(id, kBase_, kEmpty_, std::abs(id)),
-          kSettings_.limit_order());
+    for (int id : target) {
+      result = Apply<kAnd>(
+          result, FindOrAddVertex(id, kBase_, kEmpty_, std::abs(id)),
+          limit_order);
     }
-    new_root = Apply<kOr>(new_root, new_product, kSettings_.limit_order());
+    return result;
   }
-  root_ = std::move(new_root);
-  root_ = Minimize(root_);
+  const Pdag::Substitution& substitution = substitutions[index];
+  // The products without some hypothesis events are partitioned
+  // by the first missing event in the hypothesis.
+  VertexPtr hypothesis = vertex;
+  VertexPtr rest = kEmpty_;
+  for (int id : substitution.hypothesis) {
+    std::unordered_map<int, VertexPtr> without_results;
+    std::unordered_map<int, VertexPtr> with_results;
+    rest = Apply<kOr>(rest, Filter(hypothesis, id, false, &without_results),
+                      limit_order);
+    hypothesis = Filter(hypothesis, id, true, &with_results);
+  }
+  VertexPtr result = Substitute(rest, substitutions, index + 1, source, target);
+  if (hypothesis->terminal() && !Terminal<SetNode>::Ref(hypothesis).value())
+    return result;
+
+  source.insert(source.end(), substitution.source.begin(),
+                substitution.source.end());
+  if (substitution.target)
+    target.push_back(substitution.target);
+  return Apply<kOr>(result,
+                    Substitute(hypothesis, substitutions, index + 1,
+                               std::move(source), std::move(target)),
+                    limit_order);
+}
+
+Zbdd::VertexPtr
+Zbdd::Filter(const VertexPtr& vertex, int index, bool contains,
+             std::unordered_map<int, VertexPtr>* results) noexcept {
+  assert(index > 0 && "Only positive literals are filtered.");
+  if (vertex->terminal())
+    return contains ? kEmpty_ : vertex;
+  SetNodePtr node = SetNode::Ptr(vertex);
+  if (node->order() > index || (node->order() == index && node->index() < 0))
+    return contains ? kEmpty_ : vertex;  // The variable is not in sets.
+  if (node->index() == index)
+    return contains ? GetReducedVertex(node, node->high(), kEmpty_)
+                    : node->low();
+  VertexPtr& result = (*results)[vertex->id()];
+  if (result)
+    return result;
+  result = GetReducedVertex(node, Filter(node->high(), index, contains, results),
+                            Filter(node->low(), index, contains, results));
+  return result;
+}
+
+Zbdd::VertexPtr
+Zbdd::Remove(const VertexPtr& vertex, int index,
+             std::unordered_map<int, VertexPtr>* results) noexcept {
+  assert(index > 0 && "Only positive literals are removed.");
+  if (vertex->terminal())
+    return vertex;
+  SetNodePtr node = SetNode::Ptr(vertex);
+  if (node->order() > index || (node->order() == index && node->index() < 0))
+    return vertex;
+  if (node->index() == index)
+    return Apply<kOr>(node->high(), node->low(), kSettings_.limit_order());
+  VertexPtr& result = (*results)[vertex->id()];
+  if (result)
+    return result;
+  result = GetReducedVertex(node, Remove(node->high(), index, results),
+                            Remove(node->low(), index, results));
+  return result;
 }
 
 int Zbdd::CountSetNodes(const VertexPtr& vertex) noexcept {
@@ -163,7 +163,7 @@ class Zbdd : private boost::noncopyable {
             node_(node),
             zbdd_(zbdd) {
         if (!sentinel_) {
-          sentinel_ = !GenerateProduct(zbdd_.root());
+          sentinel_ = !GenerateProduct(&zbdd_.root());
           end_pos_ = it_.product_.size();
         }
       }
@@ -179,57 +179,66 @@ class Zbdd : private boost::noncopyable {
         if (sentinel_)
           return;
         assert(end_pos_ >= start_pos_ && "Corrupted sentinel.");
-        while (start_pos_ != it_.product_.size()) {
-          if (!module_stack_.empty() &&
-              it_.product_.size() == module_stack_.back().end_pos_) {
-            const SetNode* node = module_stack_.back().node_;
-            for (++module_stack_.back(); module_stack_.back();
-                 ++module_stack_.back()) {
-              if (GenerateProduct(node->high()))
-                goto outer_break;
-            }
-            module_stack_.pop_back();
-            if (GenerateProduct(node->low()))
-              break;
-
-          } else if (GenerateProduct(Pop()->low())) {
-            break;
-          }
-        }
-      outer_break:
+        GenerateProduct(nullptr);
         end_pos_ = it_.product_.size();
         sentinel_ = start_pos_ == end_pos_;
       }
 
      private:
-      /// Generates a next product in the ZBDD traversal.
+      /// Generates a next product in the ZBDD traversal
+      /// with the explicit product stack instead of recursion.
       ///
       /// @param[in] vertex  The vertex to start adding into the product.
+      ///                    nullptr to backtrack from the current product.
       ///
       /// @returns true if a new product has been generated.
       ///
       /// @post If the new product is generated,
       ///       the product and stack containers are updated accordingly.
-      bool GenerateProduct(const VertexPtr& vertex) noexcept {
-        if (vertex->terminal())
-          return Terminal<SetNode>::Ref(vertex).value();
-        if (it_.product_.size() >= it_.zbdd_.settings().limit_order())
-          return false;
-        const SetNode& node = SetNode::Ref(vertex);
-        if (node.module()) {
-          module_stack_.emplace_back(
-              &node, *zbdd_.modules_.find(node.index())->second, &it_);
-          for (; module_stack_.back(); ++module_stack_.back()) {
-            if (GenerateProduct(node.high()))
-              return true;
+      ///       Otherwise, the product is restored to the initial position.
+      bool GenerateProduct(const VertexPtr* vertex) noexcept {
+        const int base_pos = vertex ? it_.product_.size() : start_pos_;
+        for (;;) {
+          if (vertex) {  // Descend into the high branches.
+            if ((*vertex)->terminal()) {
+              if (Terminal<SetNode>::Ref(*vertex).value())
+                return true;
+            } else if (it_.product_.size() <
+                       it_.zbdd_.settings().limit_order()) {
+              const SetNode& node = SetNode::Ref(*vertex);
+              if (!node.module()) {
+                Push(&node);
+                vertex = &node.high();
+                continue;
+              }
+              module_stack_.emplace_back(
+                  &node, *zbdd_.modules_.find(node.index())->second, &it_);
+              if (module_stack_.back()) {
+                vertex = &node.high();
+                continue;
+              }
+              module_stack_.pop_back();
+              vertex = &node.low();
+              continue;
+            }
+          }
+          // Backtrack to the next alternative.
+          if (it_.product_.size() == base_pos)
+            return false;
+          if (!module_stack_.empty() &&
+              it_.product_.size() == module_stack_.back().end_pos_) {
+            const SetNode* node = module_stack_.back().node_;
+            ++module_stack_.back();
+            if (module_stack_.back()) {
+              vertex = &node->high();
+            } else {
+              assert(it_.product_.size() == module_stack_.back().start_pos_);
+              module_stack_.pop_back();
+              vertex = &node->low();
+            }
+          } else {
+            vertex = &Pop()->low();
           }
-          assert(it_.product_.size() == module_stack_.back().start_pos_);
-          module_stack_.pop_back();
-          return GenerateProduct(node.low());
-
-        } else {
-          Push(&node);
-          return GenerateProduct(node.high()) || GenerateProduct(Pop()->low());
         }
       }
 
@@ -364,6 +373,14 @@ class Zbdd : private boost::noncopyable {
   /// @returns true if the ZBDD represents a base/unity set.
   bool base() const { return root_ == kBase_; }
 
+  /// Appends the size and table statistics of the ZBDD and its modules
+  /// together with the number of products in each module.
+  ///
+  /// @param[in,out] metrics  The collection of analysis metrics.
+  ///
+  /// @pre The analysis is done.
+  void GatherMetrics(std::vector<Metric>* metrics) noexcept;
+
  protected:
   /// The common constructor to initialize member variables.
   ///
@@ -457,21 +474,6 @@ class Zbdd : private boost::noncopyable {
   VertexPtr Apply(Connective type, const VertexPtr& arg_one,
                   const VertexPtr& arg_two, int limit_order) noexcept;
 
-  /// Applies Boolean operation to ZBDD graph non-terminal vertices.
-  ///
-  /// @tparam Type  The connective enum.
-  ///
-  /// @param[in] arg_one  First argument set vertex.
-  /// @param[in] arg_two  Second argument set vertex.
-  /// @param[in] limit_order  The limit on the order for the computations.
-  ///
-  /// @returns The resulting ZBDD vertex.
-  ///
-  /// @pre Argument vertices are ordered.
-  template <Connective Type>
-  VertexPtr Apply(const SetNodePtr& arg_one, const SetNodePtr& arg_two,
-                  int limit_order) noexcept;
-
   /// Removes complements of variables from products.
   /// This procedure only needs to be performed for non-coherent graphs
   /// with minimal cut sets as output.
@@ -518,11 +520,66 @@ class Zbdd : private boost::noncopyable {
                     std::map<int, std::pair<bool, int>>* modules) noexcept;
 
   /// Applies non-declarative substitutions at the end of analysis.
+  /// The substitutions are applied with set operations on the ZBDD
+  /// instead of rebuilding the ZBDD product by product.
   ///
   /// @param[in] substitutions  The substitutions defined in PDAG.
+  ///
+  /// @post The modules are expanded,
+  ///       and the variables are ordered by their indices.
   void ApplySubstitutions(
       const std::vector<Pdag::Substitution>& substitutions) noexcept;
 
+  /// Expands modules into sets of variables
+  /// ordered by the variable indices.
+  ///
+  /// @param[in] vertex  The root vertex of the ZBDD or module.
+  /// @param[in] owner  The ZBDD or module with the vertex.
+  /// @param[in,out] results  Memoization of the owner's expanded vertices.
+  ///
+  /// @returns The expanded vertex registered in this ZBDD.
+  VertexPtr ExpandModules(const VertexPtr& vertex, const Zbdd& owner,
+                          std::unordered_map<int, VertexPtr>* results) noexcept;
+
+  /// Applies the substitutions to sets
+  /// by partitioning the sets with the hypotheses.
+  /// The hypotheses are checked against the original sets,
+  /// so the substitutions do not affect each other.
+  ///
+  /// @param[in] vertex  The expanded sets.
+  /// @param[in] substitutions  The substitutions defined in PDAG.
+  /// @param[in] index  The current substitution to partition the sets.
+  /// @param[in] source  The events to remove by satisfied hypotheses.
+  /// @param[in] target  The events to add by satisfied hypotheses.
+  ///
+  /// @returns The sets with applied substitutions.
+  VertexPtr Substitute(const VertexPtr& vertex,
+                       const std::vector<Pdag::Substitution>& substitutions,
+                       int index, std::vector<int> source,
+                       std::vector<int> target) noexcept;
+
+  /// Selects sets by the presence of a variable.
+  ///
+  /// @param[in] vertex  The expanded sets.
+  /// @param[in] index  The positive index of the variable.
+  /// @param[in] contains  The flag to select sets with the variable
+  ///                      or sets without the variable.
+  /// @param[in,out] results  Memoization of the selection results.
+  ///
+  /// @returns The selected sets.
+  VertexPtr Filter(const VertexPtr& vertex, int index, bool contains,
+                   std::unordered_map<int, VertexPtr>* results) noexcept;
+
+  /// Removes a variable from all sets.
+  ///
+  /// @param[in] vertex  The expanded sets.
+  /// @param[in] index  The positive index of the variable.
+  /// @param[in,out] results  Memoization of the removal results.
+  ///
+  /// @returns The sets without the variable (may be non-minimal).
+  VertexPtr Remove(const VertexPtr& vertex, int index,
+                   std::unordered_map<int, VertexPtr>* results) noexcept;
+
   /// Clears all memoization tables.
   void ClearTables() noexcept {
     and_table_.clear();
@@ -789,6 +846,119 @@ class Zbdd : private boost::noncopyable {
   /// @returns true for modules by default.
   virtual bool IsGate(const SetNode& node) noexcept { return node.module(); }
 
+  /// Operations on ZBDD graphs with the explicit stack.
+  enum class Operation : std::uint8_t {
+    kAnd,  ///< Apply with the AND connective.
+    kOr,  ///< Apply with the OR connective.
+    kMinimize,  ///< Removal of subsets.
+    kSubsume,  ///< Removal of low branch paths from the high branch.
+    kPrune  ///< Truncation with the limit order.
+  };
+
+  /// Pending operation on the explicit stack
+  /// with the sub-operations completed so far.
+  struct Frame {
+    Operation operation;  ///< The kind of the operation.
+    int stage;  ///< The next step of the operation.
+    VertexPtr one;  ///< The first (top) argument.
+    VertexPtr two;  ///< The second argument if any.
+    int limit_order;  ///< The limit on the set order.
+    int limit_high;  ///< The limit order for the high branch.
+    VertexPtr* result;  ///< The memoization table entry for the result.
+    VertexPtr high;  ///< The intermediate result for the high branch.
+    VertexPtr low;  ///< The intermediate result for the low branch.
+  };
+
+  /// Runs an operation and its sub-operations with the explicit stack
+  /// instead of recursion,
+  /// so the depth of the ZBDD does not limit the computation.
+  ///
+  /// @param[in] operation  The kind of the operation.
+  /// @param[in] arg_one  The first argument.
+  /// @param[in] arg_two  The second argument (nullptr for unary operations).
+  /// @param[in] limit_order  The limit on the set order if applicable.
+  ///
+  /// @returns The resulting ZBDD vertex.
+  VertexPtr Run(Operation operation, const VertexPtr& arg_one,
+                const VertexPtr& arg_two, int limit_order) noexcept;
+
+  /// Starts an operation by finding its result
+  /// with terminal cases, reduction rules, and memoization tables,
+  /// or by pushing it onto the explicit stack.
+  ///
+  /// @param[in] operation  The kind of the operation.
+  /// @param[in] arg_one  The first argument.
+  /// @param[in] arg_two  The second argument (nullptr for unary operations).
+  /// @param[in] limit_order  The limit on the set order if applicable.
+  /// @param[out] result  The result if found.
+  ///
+  /// @returns true if the result is found without decomposition.
+  bool Call(Operation operation, const VertexPtr& arg_one,
+            const VertexPtr& arg_two, int limit_order,
+            VertexPtr* result) noexcept;
+
+  /// Typed versions of Call for the sub-operations of the stack frames.
+  ///
+  /// @param[in] is_and  The AND connective instead of OR for Apply.
+  /// @param[in] arg_one  The first argument.
+  /// @param[in] arg_two  The second argument.
+  /// @param[in] vertex  The argument of the unary operation.
+  /// @param[in] high  The high branch to be subsumed.
+  /// @param[in] low  The low branch with the subsuming sets.
+  /// @param[in] limit_order  The limit on the set order.
+  /// @param[out] result  The result if found.
+  ///
+  /// @returns true if the result is found without decomposition.
+  ///
+  /// @{
+  bool CallApply(bool is_and, const VertexPtr& arg_one,
+                 const VertexPtr& arg_two, int limit_order,
+                 VertexPtr* result) noexcept;
+  bool CallMinimize(const VertexPtr& vertex, VertexPtr* result) noexcept;
+  bool CallSubsume(const VertexPtr& high, const VertexPtr& low,
+                   VertexPtr* result) noexcept;
+  bool CallPrune(const VertexPtr& vertex, int limit_order,
+                 VertexPtr* result) noexcept;
+  /// @}
+
+  /// Pushes an operation onto the explicit stack.
+  ///
+  /// @param[in] operation  The kind of the operation.
+  /// @param[in] arg_one  The first (top) non-terminal argument.
+  /// @param[in] arg_two  The second argument if any.
+  /// @param[in] limit_order  The limit on the set order if applicable.
+  /// @param[in] result  The memoization table entry for the result.
+  void Push(Operation operation, const VertexPtr& arg_one,
+            const VertexPtr& arg_two, int limit_order,
+            VertexPtr* result) noexcept;
+
+  /// Continues the operation on the top of the stack.
+  ///
+  /// @param[in,out] frame  The top frame of the stack.
+  /// @param[in,out] result  The result of the last sub-operation,
+  ///                        or the result of the operation if finished.
+  ///
+  /// @returns true if the operation is finished.
+  ///          false if a sub-operation is pushed onto the stack.
+  ///
+  /// @{
+  bool Resume(Frame* frame, VertexPtr* result) noexcept;
+  bool ResumeAnd(Frame* frame, VertexPtr* result) noexcept;
+  bool ResumeOr(Frame* frame, VertexPtr* result) noexcept;
+  bool ResumeMinimize(Frame* frame, VertexPtr* result) noexcept;
+  bool ResumeSubsume(Frame* frame, VertexPtr* result) noexcept;
+  bool ResumePrune(Frame* frame, VertexPtr* result) noexcept;
+  /// @}
+
+  /// Starts the minimization of the reduced vertex
+  /// with the computed branches of an Apply operation.
+  ///
+  /// @param[in,out] frame  The Apply operation frame.
+  /// @param[out] result  The result if found.
+  ///
+  /// @returns true if the result is found without decomposition.
+  bool CallReduce(Frame* frame, VertexPtr* result) noexcept;
+
   /// Checks if a node have a possibility to represent Unity.
   ///
   /// @param[in] node  SetNode to test for possibility of Unity.
@@ -864,6 +1034,7 @@ class Zbdd : private boost::noncopyable {
   ComputeTable and_table_;
   ComputeTable or_table_;
   /// @}
+  TableStats compute_stats_;  ///< Lookups in the computation tables.
 
   /// Memoization of minimal ZBDD vertices.
   std::unordered_map<int, VertexPtr> minimal_results_;
@@ -871,6 +1042,7 @@ class Zbdd : private boost::noncopyable {
   PairTable<VertexPtr> subsume_table_;
   /// The results of pruning operations.
   PairTable<VertexPtr> prune_results_;
+  std::vector<Frame> operation_stack_;  ///< Pending operations.
 
   std::map<int, std::unique_ptr<Zbdd>> modules_;  ///< Module graphs.
   int set_id_;  ///< Identification assignment for new set graphs.
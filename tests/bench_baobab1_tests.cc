@@ -42,6 +42,22 @@ TEST_F(RiskAnalysisTest, Baobab1) {
   EXPECT_EQ(distr, ProductDistribution());
 }
 
+// The BDD construction schedules must not change the results.
+TEST_F(RiskAnalysisTest, Baobab1ApplySchedules) {
+  std::string schedule =
+      GENERATE(as<std::string>(), "sequential", "smallest-first", "balanced");
+  int cache_limit = GENERATE(0, 100000);
+  INFO("schedule: " << schedule << ", cache limit: " << cache_limit);
+  std::vector<std::string> input_files = {
+      "input/Baobab/baobab1.xml", "input/Baobab/baobab1-basic-events.xml"};
+  settings.algorithm("bdd").probability_analysis(true);
+  settings.apply_schedule(schedule).bdd_cache_limit(cache_limit);
+  ASSERT_NO_THROW(ProcessInputFiles(input_files));
+  ASSERT_NO_THROW(analysis->Analyze());
+  EXPECT_NEAR(1.2823e-6, p_total(), 1e-8);
+  EXPECT_EQ(46188, products().size());
+}
+
 TEST_P(RiskAnalysisTest, Baobab1L8) {
   std::vector<std::string> input_files = {
       "input/Baobab/baobab1.xml", "input/Baobab/baobab1-basic-events.xml"};
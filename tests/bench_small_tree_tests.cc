@@ -41,4 +41,20 @@ TEST_P(RiskAnalysisTest, SmallTree) {
   }
 }
 
+// The importance sampling must agree with the plain Monte Carlo.
+TEST_P(RiskAnalysisTest, SmallTreeImportanceSampling) {
+  std::string tree_input = "input/SmallTree/SmallTree.xml";
+  settings.uncertainty_analysis(true).importance_sampling(true);
+  settings.num_trials(10000);
+  ASSERT_NO_THROW(ProcessInputFiles({tree_input}));
+  ASSERT_NO_THROW(analysis->Analyze());
+  if (settings.approximation() == Approximation::kRareEvent) {
+    EXPECT_NEAR(0.0255, mean(), 1e-3);
+    EXPECT_NEAR(0.0225, sigma(), 2e-3);
+  } else {
+    EXPECT_NEAR(0.0253, mean(), 1e-3);
+    EXPECT_NEAR(0.022, sigma(), 2e-3);
+  }
+}
+
 }  // namespace scram::core::test
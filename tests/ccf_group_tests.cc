@@ -17,6 +17,9 @@
 
 #include "ccf_group.h"
 
+#include <algorithm>
+#include <vector>
+
 #include <catch.hpp>
 
 #include "error.h"
@@ -46,4 +49,36 @@ TEST_CASE("CcfGroupTest.AddMemberAfterDistribution", "[mef::ccf_group]") {
   CHECK_THROWS_AS(ccf_group.AddMember(&member_three), LogicError);
 }
 
+TEST_CASE("CcfGroupTest.ApplyModelMemberEvents", "[mef::ccf_group]") {
+  AlphaFactorModel ccf_group("general");
+  BasicEvent member_one("one");
+  BasicEvent member_two("two");
+  BasicEvent member_three("three");
+  for (BasicEvent* member : {&member_one, &member_two, &member_three})
+    REQUIRE_NOTHROW(ccf_group.AddMember(member));
+  ConstantExpression distribution(0.1);
+  ConstantExpression factor(0.5);
+  REQUIRE_NOTHROW(ccf_group.AddDistribution(&distribution));
+  REQUIRE_NOTHROW(ccf_group.AddFactor(&factor, 1));
+  REQUIRE_NOTHROW(ccf_group.AddFactor(&factor, 2));
+  REQUIRE_NOTHROW(ccf_group.AddFactor(&factor, 3));
+  REQUIRE_NOTHROW(ccf_group.ApplyModel());
+
+  for (BasicEvent* member : {&member_one, &member_two, &member_three}) {
+    REQUIRE(member->HasCcf());
+    CHECK(&member->ccf_group() == &ccf_group);
+    const std::vector<CcfEvent*>& events = ccf_group.ccf_events(*member);
+    REQUIRE(events.size() == 4);  // The single, two pairs, and the triple.
+    for (const CcfEvent* event : events) {
+      CHECK(&event->ccf_group() == &ccf_group);
+      CHECK(std::count(event->members().begin(), event->members().end(),
+                       member) == 1);
+    }
+    CHECK(events.front()->members().size() == 1);
+    CHECK(events.back()->members().size() == 3);
+  }
+  CHECK(ccf_group.ccf_events(member_one).back() ==
+        ccf_group.ccf_events(member_three).back());
+}
+
 }  // namespace scram::mef::test
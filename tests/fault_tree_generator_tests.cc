@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fault_tree_generator.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+#include <boost/filesystem.hpp>
+
+#include <catch.hpp>
+
+#include "initializer.h"
+#include "risk_analysis.h"
+#include "serialization.h"
+
+namespace fs = boost::filesystem;
+
+namespace scram::mef::test {
+
+namespace {
+
+/// @returns The number of gate levels in the longest path from the gate.
+int GetDepth(const Gate& gate, std::unordered_map<const Gate*, int>* depths) {
+  if (auto it = depths->find(&gate); it != depths->end())
+    return it->second;
+  int depth = 0;
+  for (const Formula::Arg& arg : gate.formula().args()) {
+    if (const Gate* const* child = std::get_if<Gate*>(&arg.event))
+      depth = std::max(depth, GetDepth(**child, depths));
+  }
+  return depths->emplace(&gate, depth + 1).first->second;
+}
+
+/// @returns The number of products and the total probability.
+std::pair<int, double> Analyze(Model* model, const core::Settings& settings) {
+  core::RiskAnalysis analysis(model, settings);
+  analysis.Analyze();
+  REQUIRE(analysis.results().size() == 1);
+  const core::RiskAnalysis::Result& result = analysis.results().front();
+  return {result.fault_tree_analysis->products().size(),
+          result.probability_analysis->p_total()};
+}
+
+}  // namespace
+
+TEST_CASE("FaultTreeGeneratorTest.Defaults", "[fault_tree_generator]") {
+  GeneratorFactors factors;
+  auto model = GenerateFaultTree(factors);
+  CHECK(model->basic_events().size() == factors.num_basic);
+  CHECK(model->gates().size() > 10);
+  CHECK(model->ccf_groups().empty());
+  REQUIRE(model->fault_trees().size() == 1);
+  const FaultTree& fault_tree = *model->fault_trees().begin();
+  CHECK(fault_tree.name() == factors.ft_name);
+  REQUIRE(fault_tree.top_events().size() == 1);
+  CHECK(fault_tree.top_events().front()->name() == factors.root);
+
+  auto same_seed = GenerateFaultTree(factors);
+  CHECK(same_seed->gates().size() == model->gates().size());
+
+  core::Settings settings;
+  settings.probability_analysis(true);
+  auto bdd = Analyze(model.get(), settings);
+  auto zbdd = Analyze(same_seed.get(), settings.algorithm("zbdd"));
+  CHECK(bdd.first > 0);
+  CHECK(zbdd.first == bdd.first);
+}
+
+TEST_CASE("FaultTreeGeneratorTest.Size", "[fault_tree_generator]") {
+  GeneratorFactors factors;
+  factors.num_basic = 10000;
+  factors.num_gates = 3000;
+  auto model = GenerateFaultTree(factors);
+  CHECK(model->basic_events().size() == factors.num_basic);
+  CHECK(model->gates().size() == factors.num_gates);
+
+  factors.max_depth = 4;
+  model = GenerateFaultTree(factors);
+  CHECK(model->basic_events().size() == factors.num_basic);
+  std::unordered_map<const Gate*, int> depths;
+  const FaultTree& fault_tree = *model->fault_trees().begin();
+  REQUIRE(fault_tree.top_events().size() == 1);
+  CHECK(GetDepth(*fault_tree.top_events().front(), &depths) ==
+        factors.max_depth);
+}
+
+TEST_CASE("FaultTreeGeneratorTest.ComplexGatesAndCcf",
+          "[fault_tree_generator]") {
+  GeneratorFactors factors;
+  factors.num_basic = 200;
+  factors.weights = {1, 1, 1, 0.1, 0.1};
+  factors.num_ccf = 10;
+  auto model = GenerateFaultTree(factors);
+  CHECK(model->basic_events().size() == factors.num_basic);
+  CHECK(model->ccf_groups().size() == factors.num_ccf);
+  CHECK(std::any_of(model->gates().begin(), model->gates().end(),
+                    [](const Gate& gate) {
+                      return gate.formula().connective() == kAtleast;
+                    }));
+
+  core::Settings settings;
+  settings.probability_analysis(true).ccf_analysis(true).limit_order(4);
+  auto result = Analyze(model.get(), settings);
+
+  fs::path temp_file =
+      fs::temp_directory_path() / ("scram_test-" + fs::unique_path().string());
+  INFO("temp file: " + temp_file.string());
+  REQUIRE_NOTHROW(Serialize(*model, temp_file.string()));
+  std::unique_ptr<Model> loaded;
+  REQUIRE_NOTHROW(loaded = Initializer({temp_file.string()}, settings).model());
+  fs::remove(temp_file);
+  CHECK(loaded->gates().size() == model->gates().size());
+  CHECK(loaded->basic_events().size() == model->basic_events().size());
+  CHECK(loaded->ccf_groups().size() == model->ccf_groups().size());
+  auto loaded_result = Analyze(loaded.get(), settings);
+  CHECK(loaded_result.first == result.first);
+  CHECK(loaded_result.second == Approx(result.second));
+}
+
+TEST_CASE("FaultTreeGeneratorTest.InvalidFactors", "[fault_tree_generator]") {
+  auto check = [](auto modify) {
+    GeneratorFactors factors;
+    modify(&factors);
+    CHECK_THROWS_AS(GenerateFaultTree(factors), SettingsError);
+  };
+  check([](GeneratorFactors* factors) { factors->num_basic = 0; });
+  check([](GeneratorFactors* factors) { factors->num_basic = 5; });
+  check([](GeneratorFactors* factors) { factors->num_gates = -1; });
+  check([](GeneratorFactors* factors) { factors->num_args = 1.5; });
+  check([](GeneratorFactors* factors) { factors->common_b = -0.1; });
+  check([](GeneratorFactors* factors) {
+    factors->common_b = 0.5;
+    factors->common_g = 0.5;
+  });
+  check([](GeneratorFactors* factors) {
+    factors->common_b = 0.4;
+    factors->common_g = 0.4;
+  });
+  check([](GeneratorFactors* factors) { factors->weights = {0, 0, 0, 1, 1}; });
+  check([](GeneratorFactors* factors) { factors->weights = {-1, 1, 0, 0, 0}; });
+  check([](GeneratorFactors* factors) { factors->max_depth = -1; });
+  check([](GeneratorFactors* factors) { factors->num_ccf = -1; });
+  check([](GeneratorFactors* factors) { factors->max_prob = 1.1; });
+  check([](GeneratorFactors* factors) {
+    factors->min_prob = 0.5;
+    factors->max_prob = 0.1;
+  });
+}
+
+}  // namespace scram::mef::test
@@ -76,6 +76,19 @@ TEST_CASE("InitializerTest.FailSchemaValidation", "[mef::initializer]") {
   }
 }
 
+// The files are validated concurrently,
+// but the error is reported for the first failing file in the input order.
+TEST_CASE("InitializerTest.FailValidationInInputOrder", "[mef::initializer]") {
+  std::string dir = "tests/input/";
+  std::string correct = dir + "fta/correct_tree_input.xml";
+  std::string invalid = dir + "schema_fail.xml";
+  std::string malformed = dir + "xml_formatting_error.xml";
+  CHECK_THROWS_AS(Initializer({correct, invalid, malformed}, core::Settings()),
+                  xml::ValidityError);
+  CHECK_THROWS_AS(Initializer({correct, malformed, invalid}, core::Settings()),
+                  xml::ParseError);
+}
+
 // Unsupported operations.
 TEST_CASE("InitializerTest.UnsupportedFeature", "[mef::initializer]") {
   std::string dir = "tests/input/";
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "model_cache.h"
+
+#include <type_traits>
+#include <typeinfo>
+#include <variant>
+
+#include <boost/filesystem.hpp>
+
+#include <catch.hpp>
+
+#include "initializer.h"
+#include "risk_analysis.h"
+#include "settings.h"
+
+namespace fs = boost::filesystem;
+
+namespace scram::mef::test {
+
+namespace {
+
+/// Temporary cache directory removed at the end of tests.
+struct TempDirectory {
+  TempDirectory()
+      : path(fs::temp_directory_path() /
+             ("scram_test-" + fs::unique_path().string())) {}
+  ~TempDirectory() { fs::remove_all(path); }
+
+  fs::path path;  ///< The directory path (not created).
+};
+
+/// Initializes the model with the cache.
+std::unique_ptr<Model> Initialize(const std::vector<std::string>& input,
+                                  const core::Settings& settings,
+                                  const TempDirectory& cache_dir) {
+  return Initializer(input, settings, false, nullptr, cache_dir.path.string())
+      .model();
+}
+
+/// Checks the common properties of elements with the same id.
+template <class T>
+void CheckElements(const T& lhs, const T& rhs) {
+  REQUIRE(lhs.size() == rhs.size());
+  for (const auto& element : lhs) {
+    auto it = rhs.find(element.id());
+    REQUIRE(it != rhs.end());
+    INFO("element: " + element.id());
+    CHECK(it->base_path() == element.base_path());
+    CHECK(it->role() == element.role());
+    CHECK(it->label() == element.label());
+    CHECK(it->attributes().size() == element.attributes().size());
+    if constexpr (std::is_base_of_v<Usage, typename T::value_type>)
+      CHECK(it->usage() == element.usage());
+  }
+}
+
+/// Checks the equivalence of the models.
+void CheckEqual(const Model& model, const Model& cached_model) {
+  CHECK(cached_model.name() == model.name());
+  CHECK(cached_model.label() == model.label());
+  CHECK(cached_model.attributes().size() == model.attributes().size());
+
+  CheckElements(model.parameters(), cached_model.parameters());
+  for (const Parameter& parameter : model.parameters()) {
+    const Parameter& cached = *cached_model.parameters().find(parameter.id());
+    CHECK(cached.unit() == parameter.unit());
+    CHECK(cached.args().front()->value() == parameter.args().front()->value());
+  }
+
+  CheckElements(model.house_events(), cached_model.house_events());
+  for (const HouseEvent& house_event : model.house_events())
+    CHECK(cached_model.house_events().find(house_event.id())->state() ==
+          house_event.state());
+
+  CheckElements(model.basic_events(), cached_model.basic_events());
+  for (const BasicEvent& basic_event : model.basic_events()) {
+    const BasicEvent& cached = *cached_model.basic_events().find(
+        basic_event.id());
+    REQUIRE(cached.HasExpression() == basic_event.HasExpression());
+    if (basic_event.HasExpression())
+      CHECK(cached.expression().value() == basic_event.expression().value());
+  }
+
+  CheckElements(model.gates(), cached_model.gates());
+  for (const Gate& gate : model.gates()) {
+    const Formula& formula = gate.formula();
+    const Formula& cached =
+        cached_model.gates().find(gate.id())->formula();
+    CHECK(cached.connective() == formula.connective());
+    CHECK(cached.min_number() == formula.min_number());
+    CHECK(cached.max_number() == formula.max_number());
+    REQUIRE(cached.args().size() == formula.args().size());
+    for (int i = 0; i < formula.args().size(); ++i) {
+      CHECK(cached.args()[i].complement == formula.args()[i].complement);
+      CHECK(std::visit([](auto* arg) { return arg->id(); },
+                       cached.args()[i].event) ==
+            std::visit([](auto* arg) { return arg->id(); },
+                       formula.args()[i].event));
+    }
+  }
+
+  CheckElements(model.ccf_groups(), cached_model.ccf_groups());
+  for (const CcfGroup& ccf_group : model.ccf_groups()) {
+    const CcfGroup& cached = *cached_model.ccf_groups().find(ccf_group.id());
+    CHECK(typeid(cached) == typeid(ccf_group));
+    CHECK(cached.members().size() == ccf_group.members().size());
+    CHECK(cached.factors().size() == ccf_group.factors().size());
+  }
+
+  REQUIRE(cached_model.fault_trees().size() == model.fault_trees().size());
+  for (const FaultTree& fault_tree : model.fault_trees()) {
+    const FaultTree& cached =
+        *cached_model.fault_trees().find(fault_tree.name());
+    CHECK(cached.top_events().size() == fault_tree.top_events().size());
+    CHECK(cached.components().size() == fault_tree.components().size());
+    CHECK(cached.basic_events().size() == fault_tree.basic_events().size());
+    CHECK(cached.gates().size() == fault_tree.gates().size());
+  }
+}
+
+}  // namespace
+
+TEST_CASE("ModelCacheTest.RoundTrip", "[mef::model_cache]") {
+  std::vector<std::vector<std::string>> inputs = {
+      {"tests/input/fta/correct_tree_input.xml"},
+      {"tests/input/fta/correct_expressions.xml"},
+      {"tests/input/fta/correct_formulas.xml"},
+      {"tests/input/fta/component_definition.xml"},
+      {"tests/input/fta/labels_and_attributes.xml"},
+      {"tests/input/fta/mixed_roles.xml"},
+      {"tests/input/core/beta_factor_ccf.xml"},
+      {"tests/input/core/mgl_ccf.xml"},
+      {"tests/input/core/alpha_factor_ccf.xml"},
+      {"tests/input/core/phi_factor_ccf.xml"},
+      {"input/Baobab/baobab2.xml", "input/Baobab/baobab2-basic-events.xml"}};
+
+  core::Settings settings;
+  for (const auto& input : inputs) {
+    INFO("inputs: " +
+         Catch::StringMaker<std::vector<std::string>>::convert(input));
+    TempDirectory cache_dir;
+    ModelCache cache(cache_dir.path.string(), input, settings);
+    REQUIRE(cache.enabled());
+    CHECK_FALSE(cache.Load());
+
+    std::unique_ptr<Model> model;
+    REQUIRE_NOTHROW(model = Initialize(input, settings, cache_dir));
+    REQUIRE(fs::exists(cache.snapshot()));
+    std::unique_ptr<Model> cached_model;
+    REQUIRE_NOTHROW(cached_model = Initialize(input, settings, cache_dir));
+    CheckEqual(*model, *cached_model);
+  }
+}
+
+TEST_CASE("ModelCacheTest.CachedAnalysis", "[mef::model_cache]") {
+  std::vector<std::vector<std::string>> inputs = {
+      {"tests/input/core/beta_factor_ccf.xml"},
+      {"tests/input/core/mgl_ccf.xml"},
+      {"tests/input/core/alpha_factor_ccf.xml"},
+      {"tests/input/core/phi_factor_ccf.xml"},
+      {"input/TwoTrain/two_train.xml"},
+      {"input/ThreeMotor/three_motor.xml"}};
+
+  core::Settings settings;
+  settings.probability_analysis(true).ccf_analysis(true);
+  for (const auto& input : inputs) {
+    INFO("inputs: " +
+         Catch::StringMaker<std::vector<std::string>>::convert(input));
+    TempDirectory cache_dir;
+    std::unique_ptr<Model> model = Initialize(input, settings, cache_dir);
+    std::unique_ptr<Model> cached_model =
+        Initialize(input, settings, cache_dir);
+    core::RiskAnalysis analysis(model.get(), settings);
+    core::RiskAnalysis cached_analysis(cached_model.get(), settings);
+    analysis.Analyze();
+    cached_analysis.Analyze();
+    REQUIRE(analysis.results().size() == cached_analysis.results().size());
+    for (int i = 0; i < analysis.results().size(); ++i) {
+      const auto& result = analysis.results()[i];
+      const auto& cached_result = cached_analysis.results()[i];
+      REQUIRE(result.probability_analysis);
+      REQUIRE(cached_result.probability_analysis);
+      CHECK(cached_result.probability_analysis->p_total() ==
+            Approx(result.probability_analysis->p_total()));
+      CHECK(cached_result.fault_tree_analysis->products().size() ==
+            result.fault_tree_analysis->products().size());
+    }
+  }
+}
+
+TEST_CASE("ModelCacheTest.Key", "[mef::model_cache]") {
+  std::vector<std::string> input = {"input/TwoTrain/two_train.xml"};
+  core::Settings settings;
+  ModelCache cache("cache", input, settings);
+  REQUIRE(cache.enabled());
+  CHECK(ModelCache("cache", input, settings).snapshot() == cache.snapshot());
+  CHECK(ModelCache("other", input, settings).snapshot() != cache.snapshot());
+  CHECK(ModelCache("cache", {"tests/input/fta/correct_tree_input.xml"},
+                   settings)
+            .snapshot() != cache.snapshot());
+  settings.mission_time(42);
+  CHECK(ModelCache("cache", input, settings).snapshot() != cache.snapshot());
+  CHECK_THROWS_AS(
+      ModelCache("cache", {"tests/input/nonexistent_file.xml"}, settings),
+      IOError);
+}
+
+TEST_CASE("ModelCacheTest.UnsupportedInputs", "[mef::model_cache]") {
+  core::Settings settings;
+  TempDirectory cache_dir;
+  CHECK_FALSE(ModelCache(cache_dir.path.string(), {"tests/input/xinclude.xml"},
+                         settings)
+                  .enabled());
+
+  std::vector<std::string> input = {"tests/input/eta/collect_formula.xml"};
+  ModelCache cache(cache_dir.path.string(), input, settings);
+  REQUIRE(cache.enabled());
+  REQUIRE_NOTHROW(Initialize(input, settings, cache_dir));
+  CHECK_FALSE(fs::exists(cache.snapshot()));
+}
+
+TEST_CASE("ModelCacheTest.CorruptSnapshot", "[mef::model_cache]") {
+  std::vector<std::string> input = {"input/TwoTrain/two_train.xml"};
+  core::Settings settings;
+  TempDirectory cache_dir;
+  ModelCache cache(cache_dir.path.string(), input, settings);
+  REQUIRE_NOTHROW(Initialize(input, settings, cache_dir));
+  REQUIRE(cache.Load());
+
+  auto snapshot_size = fs::file_size(cache.snapshot());
+  fs::resize_file(cache.snapshot(), snapshot_size / 2);
+  CHECK_FALSE(cache.Load());
+  // The corrupt snapshot is replaced with the valid one.
+  REQUIRE_NOTHROW(Initialize(input, settings, cache_dir));
+  CHECK(fs::file_size(cache.snapshot()) == snapshot_size);
+  CHECK(cache.Load());
+}
+
+}  // namespace scram::mef::test
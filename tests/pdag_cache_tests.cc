@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pdag_cache.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include <catch.hpp>
+
+#include "initializer.h"
+#include "risk_analysis.h"
+
+namespace fs = boost::filesystem;
+
+namespace scram::core::test {
+
+namespace {
+
+/// Temporary cache directory removed at the end of tests.
+struct TempDirectory {
+  TempDirectory()
+      : path(fs::temp_directory_path() /
+             ("scram_test-" + fs::unique_path().string())) {}
+  ~TempDirectory() { fs::remove_all(path); }
+
+  /// @returns The snapshot files in the directory.
+  std::vector<fs::path> snapshots() const {
+    std::vector<fs::path> files;
+    if (fs::exists(path)) {
+      for (const fs::directory_entry& entry : fs::directory_iterator(path))
+        files.push_back(entry.path());
+    }
+    return files;
+  }
+
+  fs::path path;  ///< The directory path (not created).
+};
+
+/// The products and total probability of the analysis.
+struct Results {
+  std::set<std::set<std::string>> products;  ///< Products with event IDs.
+  double p_total = 0;  ///< The total probability.
+};
+
+/// Runs the analysis of the model.
+Results Analyze(mef::Model* model, const Settings& settings) {
+  RiskAnalysis analysis(model, settings);
+  analysis.Analyze();
+  REQUIRE(analysis.results().size() == 1);
+  const RiskAnalysis::Result& result = analysis.results().front();
+  Results results;
+  for (const Product& product : result.fault_tree_analysis->products()) {
+    std::set<std::string> ids;
+    for (const Literal& literal : product)
+      ids.insert((literal.complement ? "not " : "") + literal.event.id());
+    results.products.insert(std::move(ids));
+  }
+  if (result.probability_analysis)
+    results.p_total = result.probability_analysis->p_total();
+  return results;
+}
+
+}  // namespace
+
+TEST_CASE("PdagCacheTest.CachedAnalysis", "[pdag_cache]") {
+  struct Input {
+    std::vector<std::string> files;
+    Settings settings;
+  };
+  Settings settings;
+  settings.probability_analysis(true);
+  Settings zbdd = settings;
+  zbdd.algorithm(Algorithm::kZbdd);
+  Settings mocus = settings;
+  mocus.algorithm(Algorithm::kMocus);
+  Settings ccf = settings;
+  ccf.ccf_analysis(true);
+  Settings rare_event = settings;
+  rare_event.approximation(Approximation::kRareEvent);
+  Settings prime_implicants = settings;
+  prime_implicants.prime_implicants(true);
+  std::vector<std::string> baobab = {"input/Baobab/baobab1.xml",
+                                     "input/Baobab/baobab1-basic-events.xml"};
+  std::vector<Input> inputs = {
+      {baobab, settings},
+      {baobab, zbdd},
+      {baobab, mocus},
+      {{"input/ThreeMotor/three_motor.xml"}, ccf},
+      {{"input/TwoTrain/substitutions.xml"}, settings},
+      {{"input/TwoTrain/nondeclarative_substitutions.xml"}, rare_event},
+      {{"tests/input/fta/correct_non_coherent.xml"}, prime_implicants},
+      {{"tests/input/core/null.xml"}, settings},
+      {{"tests/input/core/unity.xml"}, settings}};
+
+  for (Input& input : inputs) {
+    INFO("inputs: " +
+         Catch::StringMaker<std::vector<std::string>>::convert(input.files));
+    auto model = mef::Initializer(input.files, input.settings).model();
+    Results results = Analyze(model.get(), input.settings);
+
+    TempDirectory cache_dir;
+    input.settings.pdag_cache(cache_dir.path.string());
+    Results stored = Analyze(model.get(), input.settings);
+    REQUIRE(cache_dir.snapshots().size() == 1);
+    Results loaded = Analyze(model.get(), input.settings);
+    CHECK(cache_dir.snapshots().size() == 1);
+
+    CHECK(stored.products == results.products);
+    CHECK(loaded.products == results.products);
+    CHECK(loaded.p_total == Approx(results.p_total));
+  }
+}
+
+TEST_CASE("PdagCacheTest.Key", "[pdag_cache]") {
+  auto model = mef::Initializer({"input/ThreeMotor/three_motor.xml"},
+                                Settings())
+                   .model();
+  const mef::Gate& top_gate = *model->gates().find("E1");
+  Settings settings;
+  PdagCache cache("cache", top_gate, settings, model.get(), "bdd");
+  CHECK(PdagCache("cache", top_gate, settings, model.get(), "bdd")
+            .snapshot() == cache.snapshot());
+  CHECK(PdagCache("other", top_gate, settings, model.get(), "bdd")
+            .snapshot() != cache.snapshot());
+  CHECK(PdagCache("cache", top_gate, settings, model.get(), "zbdd")
+            .snapshot() != cache.snapshot());
+  Settings ccf = settings;
+  ccf.ccf_analysis(true);
+  CHECK(PdagCache("cache", top_gate, ccf, model.get(), "bdd").snapshot() !=
+        cache.snapshot());
+  // The mission time and probabilities do not affect the graph.
+  Settings mission_time = settings;
+  mission_time.mission_time(42);
+  CHECK(PdagCache("cache", top_gate, mission_time, model.get(), "bdd")
+            .snapshot() == cache.snapshot());
+
+  const mef::Gate& sub_gate = *model->gates().find("E2");
+  CHECK(PdagCache("cache", sub_gate, settings, model.get(), "bdd")
+            .snapshot() != cache.snapshot());
+}
+
+TEST_CASE("PdagCacheTest.CorruptSnapshot", "[pdag_cache]") {
+  Settings settings;
+  settings.probability_analysis(true);
+  auto model = mef::Initializer({"input/TwoTrain/two_train.xml"}, settings)
+                   .model();
+  Results results = Analyze(model.get(), settings);
+
+  TempDirectory cache_dir;
+  settings.pdag_cache(cache_dir.path.string());
+  Analyze(model.get(), settings);
+  REQUIRE(cache_dir.snapshots().size() == 1);
+  fs::path snapshot = cache_dir.snapshots().front();
+  auto snapshot_size = fs::file_size(snapshot);
+
+  fs::resize_file(snapshot, snapshot_size / 2);
+  Results loaded = Analyze(model.get(), settings);
+  CHECK(loaded.products == results.products);
+  CHECK(loaded.p_total == Approx(results.p_total));
+  // The corrupt snapshot is replaced with the valid one.
+  CHECK(fs::file_size(snapshot) == snapshot_size);
+}
+
+}  // namespace scram::core::test
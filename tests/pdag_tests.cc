@@ -17,11 +17,18 @@
 
 #include "pdag.h"
 
+#include <algorithm>
+#include <iterator>
+#include <string>
+
 #include <catch.hpp>
 
+#include "bdd.h"
 #include "fault_tree.h"
+#include "fault_tree_analysis.h"
 #include "initializer.h"
 #include "model.h"
+#include "preprocessor.h"
 #include "settings.h"
 
 /// @todo: Replace w/ proper Catch macros.
@@ -41,6 +48,73 @@ TEST_CASE("PdagTest.Print", "[mef::pdag]") {
   graph.Print();
 }
 
+TEST_CASE("PdagTest.SharedStructures", "[mef::pdag]") {
+  std::unique_ptr<mef::Model> model =
+      mef::Initializer({"tests/input/fta/shared_top_events.xml"}, Settings())
+          .model();
+  auto gate = [&model](const std::string& id) -> const mef::Gate* {
+    return &*model->table<mef::Gate>().find(id);
+  };
+  std::vector<GatePtr> root_gates;
+  Pdag graph({gate("TopA"), gate("SupportA"), gate("SupportB"), gate("TopA")},
+             false, &root_gates);
+  REQUIRE(root_gates.size() == 4);
+  CHECK(root_gates[0] == root_gates[3]);
+  CHECK(root_gates[1] == root_gates[2]);  // Identical structures.
+  CHECK(root_gates[0]->args<Gate>().begin()->second == root_gates[1]);
+  CHECK(graph.root()->args().size() == 2);
+}
+
+TEST_CASE("PdagTest.PreprocessingStats", "[mef::pdag]") {
+  std::unique_ptr<mef::Model> model =
+      mef::Initializer({"input/Baobab/baobab1.xml",
+                        "input/Baobab/baobab1-basic-events.xml"},
+                       Settings())
+          .model();
+  const mef::Gate& top_event = *model->fault_trees().begin()->top_events()[0];
+  auto num_products = [&model, &top_event](const Settings& settings) {
+    FaultTreeAnalyzer<Bdd> analysis(top_event, settings, model.get());
+    analysis.Analyze();
+    return analysis.products().size();
+  };
+  auto partial = [](const std::vector<PassStats>& stats) {
+    return std::any_of(stats.begin(), stats.end(), [](const PassStats& pass) {
+      return pass.skipped || pass.aborted;
+    });
+  };
+
+  Settings settings;
+  Pdag graph(top_event);
+  CustomPreprocessor<Bdd> preprocessor(&graph, settings);
+  preprocessor();
+  const std::vector<PassStats>& stats = preprocessor.stats();
+  REQUIRE_FALSE(stats.empty());
+  CHECK(stats.front().before.gates > 0);
+  CHECK_FALSE(partial(stats));
+  for (auto it = stats.begin(); it != stats.end(); ++it) {
+    INFO(it->name);
+    CHECK(it->runs > 0);
+    CHECK(it->time >= 0);
+    if (it != stats.begin()) {
+      CHECK(std::string(it->name) != std::prev(it)->name);
+      CHECK(it->before.gates == std::prev(it)->after.gates);
+      CHECK(it->before.args == std::prev(it)->after.args);
+    }
+  }
+  CHECK(std::any_of(stats.begin(), stats.end(), [](const PassStats& pass) {
+    return std::string(pass.name) == "module-detection" && pass.after.modules;
+  }));
+
+  Settings budget = settings;
+  for (const char* pass : kPreprocessorPassToString)
+    budget.preprocessing_budget(pass, 1e-12);
+  Pdag budget_graph(top_event);
+  CustomPreprocessor<Bdd> budget_preprocessor(&budget_graph, budget);
+  budget_preprocessor();
+  CHECK(partial(budget_preprocessor.stats()));
+  CHECK(num_products(budget) == num_products(settings));
+}
+
 TEST_CASE("PdagTest.Cardinality", "[mef::pdag]") {
   mef::BasicEvent one("one"), two("two");
   mef::Formula::ArgSet arg_set = {&one, &two};
@@ -65,9 +65,11 @@ TEST_CASE("ProjectTest.FullSettings", "[config]") {
   const core::Settings& settings = config.settings();
   CHECK(settings.algorithm() == core::Algorithm::kBdd);
   CHECK_FALSE(settings.prime_implicants());
+  CHECK(settings.apply_schedule() == core::ApplySchedule::kSmallestFirst);
   CHECK(settings.probability_analysis());
   CHECK(settings.importance_analysis());
   CHECK(settings.uncertainty_analysis());
+  CHECK(settings.importance_sampling());
   CHECK(settings.ccf_analysis());
   CHECK(settings.safety_integrity_levels());
   CHECK(settings.approximation() == core::Approximation::kRareEvent);
@@ -79,6 +81,11 @@ TEST_CASE("ProjectTest.FullSettings", "[config]") {
   CHECK(settings.num_quantiles() == 13);
   CHECK(settings.num_bins() == 31);
   CHECK(settings.seed() == 97531);
+  CHECK(settings.bdd_cache_limit() == 5000);
+  using core::PreprocessorPass;
+  CHECK(settings.preprocessing_budget(PreprocessorPass::kDistributivity) == 0.5);
+  CHECK(settings.preprocessing_budget(PreprocessorPass::kDecomposition) == 2);
+  CHECK(settings.preprocessing_budget(PreprocessorPass::kMergeCommonArgs) == 0);
 }
 
 TEST_CASE("ProjectTest.PrimeImplicantsSettings", "[config]") {
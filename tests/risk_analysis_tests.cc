@@ -17,9 +17,19 @@
 
 #include "risk_analysis_tests.h"
 
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
 #include <utility>
 
 #include <boost/filesystem.hpp>
+#include <zlib.h>
 
 #include "env.h"
 #include "error.h"
@@ -440,6 +450,94 @@ TEST_P(RiskAnalysisTest, AnalyzeEventTree) {
   }
 }
 
+TEST_F(RiskAnalysisTest, AnalyzeEventTreeSharedBdd) {
+  const char* tree_input = "input/EventTrees/bcd.xml";
+  settings.probability_analysis(true).shared_sequence_bdd(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  CHECK(analysis->event_tree_results().size() == 1);
+  const auto& results = sequences();
+  REQUIRE(results.size() == 2);
+  std::map<std::string, double> expected = {{"Success", 0.594},
+                                            {"Failure", 0.406}};
+  for (const auto& result : expected) {
+    INFO("state: " + result.first);
+    REQUIRE(results.count(result.first));
+    CHECK(results.at(result.first) == Approx(result.second));
+  }
+}
+
+TEST_F(RiskAnalysisTest, AnalyzeSharedTopEventBdd) {
+  const char* tree_input = "tests/input/fta/shared_top_events.xml";
+  settings.probability_analysis(true).shared_top_event_bdd(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  REQUIRE(analysis->results().size() == 3);
+  std::map<std::string, double> expected = {
+      {"TopA", 0.084}, {"TopB", 0.112}, {"TopC", 0.496}};
+  for (const RiskAnalysis::Result& result : analysis->results()) {
+    const auto* target = std::get<const mef::Gate*>(result.id.target);
+    INFO("top event: " + target->id());
+    CHECK_FALSE(result.fault_tree_analysis);
+    REQUIRE(result.probability_analysis);
+    REQUIRE(expected.count(target->id()));
+    CHECK(result.probability_analysis->p_total() ==
+          Approx(expected.at(target->id())));
+  }
+}
+
+// Sweeps of parameters over the products of a single qualitative analysis.
+TEST_P(RiskAnalysisTest, AnalyzeSensitivity) {
+  const char* tree_input = "tests/input/fta/sensitivity.xml";
+  settings.sensitivity_parameter("PumpFailure", {0.01, 0.1, 0.5})
+      .sensitivity_parameter("ValveFailure", {0.1, 0.3})
+      .importance_analysis(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  REQUIRE(analysis->results().size() == 1);
+  const RiskAnalysis::Result& result = analysis->results().front();
+  CHECK(result.probability_analysis->p_total() == Approx(0.136));
+  REQUIRE(result.sensitivity_analysis);
+  const auto& curves = result.sensitivity_analysis->curves();
+  REQUIRE(curves.size() == 2);
+
+  CHECK(curves[0].parameter.id() == "PumpFailure");
+  REQUIRE(curves[0].points.size() == 3);
+  std::vector<double> expected = {0.0496, 0.136, 0.52};
+  for (int i = 0; i < expected.size(); ++i) {
+    INFO("point: " + std::to_string(i));
+    CHECK(curves[0].points[i].p_total == Approx(expected[i]));
+  }
+  const SensitivityAnalysis::Point& point = curves[0].points[2];
+  CHECK(point.value == 0.5);
+  REQUIRE(point.importance.size() == 3);
+  for (const auto& [record, p_var] : point.importance) {
+    INFO("event: " + record.event.id());
+    if (record.event.id() == "Pump") {
+      CHECK(p_var == Approx(0.5));
+      CHECK(record.factors.mif == Approx(0.96));
+    } else {
+      CHECK(p_var == Approx(0.2));
+      CHECK(record.factors.mif == Approx(0.1));
+    }
+  }
+
+  CHECK(curves[1].parameter.id() == "ValveFailure");
+  REQUIRE(curves[1].points.size() == 2);
+  CHECK(curves[1].points[0].p_total == Approx(0.109));
+  CHECK(curves[1].points[1].p_total == Approx(0.181));
+
+  // The parameters are restored to the nominal values.
+  for (const mef::BasicEvent& event : basic_events())
+    CHECK(event.p() == Approx(event.id() == "Pump" ? 0.1 : 0.2));
+}
+
+TEST_F(RiskAnalysisTest, SensitivityUndefinedParameter) {
+  const char* tree_input = "tests/input/fta/sensitivity.xml";
+  settings.sensitivity_parameter("PipeFailure", {0.1});
+  CHECK_THROWS_AS(ProcessInputFiles({tree_input}), mef::UndefinedElement);
+}
+
 TEST_P(RiskAnalysisTest, AnalyzeTestEventDefault) {
   const char* tree_input = "tests/input/eta/test_event_default.xml";
   settings.probability_analysis(true);
@@ -503,6 +601,31 @@ TEST_P(RiskAnalysisTest, ReportDefaultMCS) {
   CheckReport({"tests/input/fta/correct_tree_input.xml"});
 }
 
+// Metrics of analysis internals for performance diagnostics.
+TEST_P(RiskAnalysisTest, AnalysisMetrics) {
+  settings.probability_analysis(true);
+  REQUIRE_NOTHROW(
+      ProcessInputFiles({"tests/input/fta/correct_tree_input_with_probs.xml"}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  const RiskAnalysis::Result& result = analysis->results().front();
+  auto find = [](const Analysis& target, const std::string& name) {
+    auto it = std::find_if(
+        target.metrics().begin(), target.metrics().end(),
+        [&name](const Metric& metric) { return metric.name == name; });
+    return it == target.metrics().end() ? -1 : it->value;
+  };
+  const FaultTreeAnalysis& fta = *result.fault_tree_analysis;
+  CHECK(find(fta, "pdag-gates") > 0);
+  CHECK(find(fta, "pdag-variables") > 0);
+  CHECK(find(fta, "zbdd-nodes") > 0);
+  CHECK(find(fta, "zbdd-modules") >= 0);
+  CHECK(find(fta, "products/root") > 0);
+  CHECK(find(fta, "zbdd-compute-hit-rate") >= 0);
+  CHECK(find(fta, "zbdd-compute-hit-rate") <= 1);
+  CHECK(find(fta, "peak-memory") >= 0);
+  CHECK(find(*result.probability_analysis, "peak-memory") >= 0);
+}
+
 // Reporting of analysis for MCS with probability results.
 TEST_F(RiskAnalysisTest, ReportProbability) {
   std::string tree_input = "tests/input/fta/correct_tree_input_with_probs.xml";
@@ -529,6 +652,14 @@ TEST_F(RiskAnalysisTest, ReportImportanceFactors) {
   CheckReport({tree_input});
 }
 
+// Reporting of sensitivity analysis.
+TEST_F(RiskAnalysisTest, ReportSensitivity) {
+  std::string tree_input = "tests/input/fta/sensitivity.xml";
+  settings.sensitivity_parameter("PumpFailure", {0.01, 0.1})
+      .importance_analysis(true);
+  CheckReport({tree_input});
+}
+
 // Reporting of uncertainty analysis.
 TEST_F(RiskAnalysisTest, ReportUncertaintyResults) {
   std::string tree_input = "tests/input/fta/correct_tree_input_with_probs.xml";
@@ -536,6 +667,13 @@ TEST_F(RiskAnalysisTest, ReportUncertaintyResults) {
   CheckReport({tree_input});
 }
 
+// Reporting of uncertainty analysis with importance sampling.
+TEST_F(RiskAnalysisTest, ReportImportanceSamplingResults) {
+  std::string tree_input = "tests/input/fta/correct_tree_input_with_probs.xml";
+  settings.uncertainty_analysis(true).importance_sampling(true);
+  CheckReport({tree_input});
+}
+
 // Reporting event tree analysis with an initiating event.
 TEST_F(RiskAnalysisTest, ReportInitiatingEventAnalysis) {
   const char* tree_input = "input/EventTrees/bcd.xml";
@@ -599,6 +737,84 @@ TEST_F(RiskAnalysisTest, ReportAlignmentEventTree) {
   CheckReport({dir + "attack_alignment.xml", dir + "attack.xml"});
 }
 
+TEST_F(RiskAnalysisTest, ReportSharedSequenceBdd) {
+  std::string dir = "input/EventTrees/";
+  settings.probability_analysis(true).shared_sequence_bdd(true).time_step(24);
+  CheckReport({dir + "attack_alignment.xml", dir + "attack.xml"});
+}
+
+// Reporting into the compressed XML.
+TEST_F(RiskAnalysisTest, ReportXmlGzip) {
+  static xml::Validator validator(env::report_schema());
+  std::string tree_input = "tests/input/fta/correct_tree_input_with_probs.xml";
+  settings.probability_analysis(true).importance_analysis(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  fs::path unique_name = "scram_report_test-" + fs::unique_path().string();
+  fs::path temp_file = fs::temp_directory_path() / unique_name;
+  INFO("output: " + temp_file.string());
+  REQUIRE_NOTHROW(Reporter().Report(*analysis, temp_file.string(), true,
+                                    Reporter::Format::kXmlGzip));
+  std::string content;
+  {
+    std::unique_ptr<gzFile_s, decltype(&gzclose)> gz(
+        gzopen(temp_file.string().c_str(), "rb"), &gzclose);
+    REQUIRE(gz);
+    REQUIRE(gzdirect(gz.get()) == 0);  // Not a plain file.
+    char buffer[4096];
+    for (int len; (len = gzread(gz.get(), buffer, sizeof(buffer))) > 0;)
+      content.append(buffer, len);
+  }
+  std::FILE* fp = std::fopen(temp_file.string().c_str(), "w");
+  REQUIRE(fp);
+  std::fwrite(content.data(), 1, content.size(), fp);
+  std::fclose(fp);
+  CHECK_NOTHROW(xml::Document(temp_file.string(), &validator));
+  fs::remove(temp_file);
+}
+
+// Reporting into the binary container.
+TEST_F(RiskAnalysisTest, ReportBinary) {
+  std::string tree_input = "tests/input/fta/correct_tree_input_with_probs.xml";
+  settings.probability_analysis(true).importance_analysis(true);
+  settings.uncertainty_analysis(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  fs::path unique_name = "scram_report_test-" + fs::unique_path().string();
+  fs::path temp_file = fs::temp_directory_path() / unique_name;
+  INFO("output: " + temp_file.string());
+  REQUIRE_NOTHROW(Reporter().Report(*analysis, temp_file.string(), true,
+                                    Reporter::Format::kBinary));
+  std::stringstream str_stream;
+  str_stream << std::ifstream(temp_file.string(), std::ios::binary).rdbuf();
+  std::string content = str_stream.str();
+  fs::remove(temp_file);
+
+  REQUIRE(content.size() >= 16);
+  CHECK(content.substr(0, 8) == "SCRAMRES");
+  auto read = [&content](std::size_t pos, auto value) {
+    REQUIRE(pos + sizeof(value) <= content.size());
+    std::memcpy(&value, content.data() + pos, sizeof(value));
+    return value;
+  };
+  CHECK(read(8, std::uint32_t()) == 1);
+  CHECK(read(12, std::uint32_t()) == 0x01020304);
+  std::vector<std::uint32_t> sections;
+  std::size_t pos = 16;
+  while (pos < content.size()) {
+    sections.push_back(read(pos, std::uint32_t()));
+    std::uint64_t size = read(pos + 8, std::uint64_t());
+    CHECK(size % 8 == 0);
+    pos += 32 + size;
+  }
+  CHECK(pos == content.size());
+  // Products, probability, importance, uncertainty, and strings.
+  CHECK(sections == std::vector<std::uint32_t>{2, 3, 4, 5, 1});
+  // The product count in the products section.
+  CHECK(read(16 + 32, std::uint64_t()) ==
+        analysis->results().front().fault_tree_analysis->products().size());
+}
+
 // NAND and NOR as a child cases.
 TEST_P(RiskAnalysisTest, ChildNandNorGates) {
   std::string tree_input = "tests/input/fta/children_nand_nor.xml";
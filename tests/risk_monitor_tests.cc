@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "risk_monitor.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <catch.hpp>
+
+#include "error.h"
+#include "initializer.h"
+
+namespace scram::core::test {
+
+namespace {
+
+/// @returns The current probabilities of the targets by their names.
+std::map<std::string, double> Probabilities(const RiskMonitor& monitor) {
+  std::map<std::string, double> results;
+  for (const RiskMonitor::Target& target : monitor.targets()) {
+    if (const auto* gate = std::get_if<const mef::Gate*>(&target.id)) {
+      results.emplace((*gate)->id(), target.p_total);
+    } else {
+      results.emplace(std::get<1>(target.id).second->name(), target.p_total);
+    }
+  }
+  return results;
+}
+
+}  // namespace
+
+TEST_CASE("RiskMonitorTest.Requantification", "[monitor]") {
+  Settings settings;
+  std::unique_ptr<mef::Model> model =
+      mef::Initializer({"tests/input/fta/monitor_house_event.xml"}, settings)
+          .model();
+  RiskMonitor monitor(model.get(), settings);
+  monitor.Analyze();
+  REQUIRE(monitor.targets().size() == 2);
+  auto p = Probabilities(monitor);
+  CHECK(p.at("TopA") == Approx(0.084));
+  CHECK(p.at("TopB") == Approx(0.7));
+
+  SECTION("Probability change") {
+    REQUIRE_NOTHROW(monitor.SetProbability("PumpA", 0.5));
+    CHECK(Probabilities(monitor).at("TopA") == Approx(0.084));  // Pending.
+    CHECK(monitor.Update() == 0);
+    p = Probabilities(monitor);
+    CHECK(p.at("TopA") == Approx(0.14));
+    CHECK(p.at("TopB") == Approx(0.7));
+  }
+
+  SECTION("House event change") {
+    REQUIRE_NOTHROW(monitor.SetHouseEvent("Maintenance", true));
+    CHECK(monitor.Update() == 1);  // Only TopA depends on the house event.
+    p = Probabilities(monitor);
+    CHECK(p.at("TopA") == Approx(0.3));
+    CHECK(p.at("TopB") == Approx(0.7));
+    REQUIRE_NOTHROW(monitor.SetHouseEvent("Maintenance", true));
+    CHECK(monitor.Update() == 0);  // No change in the state.
+  }
+
+  SECTION("Invalid requests") {
+    CHECK_THROWS_AS(monitor.SetProbability("Pump", 0.5),
+                    mef::UndefinedElement);
+    CHECK_THROWS_AS(monitor.SetProbability("PumpA", 1.5), mef::DomainError);
+    CHECK_THROWS_AS(monitor.SetHouseEvent("PumpA", true),
+                    mef::UndefinedElement);
+    CHECK(monitor.Update() == 0);
+    CHECK(Probabilities(monitor).at("TopA") == Approx(0.084));
+  }
+}
+
+TEST_CASE("RiskMonitorTest.EventTreeSequences", "[monitor]") {
+  Settings settings;
+  std::unique_ptr<mef::Model> model =
+      mef::Initializer({"input/EventTrees/bcd.xml"}, settings).model();
+  RiskMonitor monitor(model.get(), settings);
+  monitor.Analyze();
+  auto p = Probabilities(monitor);
+  REQUIRE(p.size() == 2);
+  CHECK(p.at("Success") == Approx(0.594));
+  CHECK(p.at("Failure") == Approx(0.406));
+}
+
+}  // namespace scram::core::test
@@ -0,0 +1,509 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Benchmark runner over the model corpus in the input directory.
+///
+/// Every model is analyzed with the requested algorithms and approximations
+/// with warm-up and repeated runs.
+/// The timing statistics, peak memory, and analysis metrics
+/// are written in JSON,
+/// which can be compared against a stored baseline to flag regressions.
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <regex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/exception/errinfo_errno.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+#include <boost/exception/errinfo_file_open_mode.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <libxml/parser.h>
+
+#include "error.h"
+#include "ext/scope_guard.h"
+#include "fault_tree_generator.h"
+#include "initializer.h"
+#include "json_writer.h"
+#include "risk_analysis.h"
+#include "settings.h"
+
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+
+namespace {
+
+/// The corpus directories relative to the input directory.
+const char* const kCorpus[] = {"Aralia", "Baobab", "CEA9601", "Autogenerated"};
+
+/// The suffix of files with basic event definitions
+/// that complement the fault tree file with the same stem.
+const char kBasicEventsSuffix[] = "-basic-events.xml";
+
+/// Timing differences below this resolution (seconds) are noise.
+const double kTimeResolution = 5e-3;
+
+/// Relative tolerance for the total probability in the baseline comparison.
+const double kProbabilityTolerance = 1e-6;
+
+/// A model of the corpus.
+struct Model {
+  std::string name;  ///< The directory and file stem, e.g., Aralia/das9201.
+  std::vector<std::string> files;  ///< The input files.
+  int synthetic = 0;  ///< The number of basic events in a generated model.
+};
+
+/// The median and the median absolute deviation of samples.
+struct Statistics {
+  /// @param[in] samples  The non-empty set of measurements.
+  explicit Statistics(std::vector<double> samples) {
+    auto get_median = [](std::vector<double>* values) {
+      auto middle = values->begin() + values->size() / 2;
+      std::nth_element(values->begin(), middle, values->end());
+      if (values->size() % 2)
+        return *middle;
+      return (*middle + *std::max_element(values->begin(), middle)) / 2;
+    };
+    auto [low, high] = std::minmax_element(samples.begin(), samples.end());
+    min = *low;
+    max = *high;
+    median = get_median(&samples);
+    for (double& sample : samples)
+      sample = std::abs(sample - median);
+    mad = get_median(&samples);
+  }
+
+  double median;  ///< The median of samples.
+  double mad;  ///< The median absolute deviation from the median.
+  double min;  ///< The smallest sample.
+  double max;  ///< The largest sample.
+};
+
+/// The measurements of a benchmark case.
+struct Case {
+  const Model* model;  ///< The analyzed model.
+  std::string algorithm;  ///< The qualitative analysis algorithm.
+  std::string approximation;  ///< The quantitative approximation.
+  std::vector<double> times;  ///< The total analysis time of each repetition.
+  std::vector<double> products_times;  ///< The qualitative analysis times.
+  std::vector<double> probability_times;  ///< The quantitative times.
+  int products = 0;  ///< The number of products.
+  double p_total = 0;  ///< The total probability.
+  double peak_memory = 0;  ///< The process peak memory (MB) after the case.
+  std::vector<scram::core::Metric> metrics;  ///< The last run metrics.
+  std::optional<std::string> error;  ///< The failure message.
+};
+
+/// @returns Command-line option descriptions.
+po::options_description ConstructOptions() {
+  using path = std::string;
+  using regex = std::string;
+
+  po::options_description desc("Options");
+  // clang-format off
+  desc.add_options()
+      ("help", "Display this help message")
+      ("list", "List the corpus models without running benchmarks")
+      ("input-dir", po::value<path>()->value_name("path")
+                        ->default_value(SCRAM_BENCH_INPUT_DIR),
+       "Directory with the model corpus")
+      ("synthetic", po::value<std::vector<int>>()->composing()
+                        ->value_name("int"),
+       "Add a generated model with the number of basic events")
+      ("filter", po::value<regex>()->value_name("regex"),
+       "Run only models with matching names, e.g., 'Aralia/das.*'")
+      ("algorithm", po::value<std::vector<std::string>>()->composing()
+                        ->value_name("name"),
+       "Qualitative analysis algorithm: bdd, zbdd, mocus (default: all)")
+      ("approximation", po::value<std::vector<std::string>>()->composing()
+                            ->value_name("name"),
+       "Quantitative approximation: none, rare-event, mcub (default: all)")
+      ("limit-order,l", po::value<int>()->value_name("int"),
+       "Upper limit for the product order")
+      ("warmup", po::value<int>()->value_name("int")->default_value(1),
+       "Number of discarded runs before measurements")
+      ("repetitions", po::value<int>()->value_name("int")->default_value(5),
+       "Number of measured runs")
+      ("output,o", po::value<path>()->value_name("path"),
+       "Output JSON file (default: the standard output)")
+      ("baseline", po::value<path>()->value_name("path"),
+       "Stored JSON output to compare against")
+      ("tolerance", po::value<double>()->value_name("double")
+                        ->default_value(0.1),
+       "Allowed relative slowdown against the baseline");
+  // clang-format on
+  return desc;
+}
+
+/// Discovers the models in the corpus directories.
+///
+/// @param[in] input_dir  The root directory of the corpus.
+/// @param[in] filter  The pattern for model names.
+///
+/// @returns The models sorted by name.
+std::vector<Model> FindModels(const fs::path& input_dir,
+                              const std::optional<std::regex>& filter) {
+  std::vector<Model> models;
+  for (const char* corpus : kCorpus) {
+    fs::path dir = input_dir / corpus;
+    if (!fs::is_directory(dir))
+      continue;
+    std::vector<fs::path> files;
+    for (const fs::directory_entry& entry : fs::directory_iterator(dir))
+      files.push_back(entry.path());
+    std::sort(files.begin(), files.end());
+    for (const fs::path& file : files) {
+      std::string name = file.filename().string();
+      if (boost::ends_with(name, kBasicEventsSuffix))
+        continue;
+      std::string stem;
+      if (boost::ends_with(name, ".xml")) {
+        stem = name.substr(0, name.size() - 4);
+      } else if (boost::ends_with(name, ".xml.gz")) {
+        stem = name.substr(0, name.size() - 7);
+      } else {
+        continue;
+      }
+      Model model{std::string(corpus) + "/" + stem, {file.string()}};
+      if (filter && !std::regex_match(model.name, *filter))
+        continue;
+      fs::path basic_events = dir / (stem + kBasicEventsSuffix);
+      if (fs::exists(basic_events))
+        model.files.push_back(basic_events.string());
+      models.push_back(std::move(model));
+    }
+  }
+  return models;
+}
+
+/// Runs the analysis repeatedly and gathers the measurements.
+///
+/// @param[in] model  The initialized model.
+/// @param[in] settings  The analysis settings.
+/// @param[in] warmup  The number of discarded runs.
+/// @param[in] repetitions  The number of measured runs.
+/// @param[in,out] bench  The case to fill with the measurements.
+void Run(scram::mef::Model* model, const scram::core::Settings& settings,
+         int warmup, int repetitions, Case* bench) {
+  using Clock = std::chrono::steady_clock;
+  for (int i = 0; i < warmup + repetitions; ++i) {
+    scram::core::RiskAnalysis analysis(model, settings);
+    auto start = Clock::now();
+    analysis.Analyze();
+    std::chrono::duration<double> time = Clock::now() - start;
+    if (i < warmup)
+      continue;
+    bench->times.push_back(time.count());
+    bench->products_times.push_back(0);
+    bench->probability_times.push_back(0);
+    bench->products = 0;
+    bench->p_total = 0;
+    bench->metrics.clear();
+    for (const scram::core::RiskAnalysis::Result& result : analysis.results()) {
+      if (result.fault_tree_analysis) {
+        bench->products_times.back() +=
+            result.fault_tree_analysis->analysis_time();
+        bench->products += result.fault_tree_analysis->products().size();
+        for (const scram::core::Metric& metric :
+             result.fault_tree_analysis->metrics()) {
+          bench->metrics.push_back(metric);
+        }
+      }
+      if (result.probability_analysis) {
+        bench->probability_times.back() +=
+            result.probability_analysis->analysis_time();
+        bench->p_total += result.probability_analysis->p_total();
+      }
+    }
+  }
+  bench->peak_memory = scram::core::PeakMemory();
+}
+
+/// Writes the timing statistics of samples into the current JSON object.
+void PutStatistics(const char* key, const std::vector<double>& samples,
+                   scram::JsonWriter* json) {
+  Statistics stats(samples);
+  json->BeginObject(key)
+      .Put("median", stats.median)
+      .Put("mad", stats.mad)
+      .Put("min", stats.min)
+      .Put("max", stats.max)
+      .End();
+}
+
+/// Writes the benchmark results in JSON.
+void Report(const std::vector<Case>& cases, const po::variables_map& vm,
+            std::FILE* out) {
+  scram::JsonWriter json(out);
+  json.BeginObject()
+      .Put("warmup", vm["warmup"].as<int>())
+      .Put("repetitions", vm["repetitions"].as<int>());
+  if (vm.count("limit-order"))
+    json.Put("limit-order", vm["limit-order"].as<int>());
+  json.BeginArray("cases");
+  for (const Case& bench : cases) {
+    json.BeginObject()
+        .Put("model", bench.model->name)
+        .Put("algorithm", bench.algorithm)
+        .Put("approximation", bench.approximation);
+    if (bench.error) {
+      json.Put("error", *bench.error).End();
+      continue;
+    }
+    PutStatistics("time", bench.times, &json);
+    json.BeginObject("phases");
+    PutStatistics("products", bench.products_times, &json);
+    PutStatistics("probability", bench.probability_times, &json);
+    json.End()
+        .Put("products", bench.products)
+        .Put("p-total", bench.p_total)
+        .Put("peak-memory", bench.peak_memory)
+        .BeginObject("metrics");
+    for (const scram::core::Metric& metric : bench.metrics)
+      json.Put(metric.name, metric.value);
+    json.End().End();
+  }
+  json.End().End();
+  std::fputc('\n', out);
+}
+
+/// Compares the results against the baseline.
+///
+/// @param[in] cases  The benchmark results.
+/// @param[in] file  The baseline JSON file.
+/// @param[in] tolerance  The allowed relative slowdown.
+///
+/// @returns The number of regressions.
+int Compare(const std::vector<Case>& cases, const std::string& file,
+            double tolerance) {
+  namespace pt = boost::property_tree;
+  pt::ptree baseline;
+  pt::read_json(file, baseline);
+  using Key = std::tuple<std::string, std::string, std::string>;
+  std::map<Key, const pt::ptree*> entries;
+  for (const auto& entry : baseline.get_child("cases")) {
+    const pt::ptree& node = entry.second;
+    entries.emplace(Key{node.get<std::string>("model"),
+                        node.get<std::string>("algorithm"),
+                        node.get<std::string>("approximation")},
+                    &node);
+  }
+
+  int regressions = 0;
+  for (const Case& bench : cases) {
+    std::string label = bench.model->name + " " + bench.algorithm + " " +
+                        bench.approximation;
+    auto it = entries.find(
+        Key{bench.model->name, bench.algorithm, bench.approximation});
+    if (it == entries.end()) {
+      std::cerr << "NEW        " << label << "\n";
+      continue;
+    }
+    const pt::ptree& base = *it->second;
+    if (bench.error || base.count("error")) {
+      if (bench.error && !base.count("error")) {
+        std::cerr << "FAILED     " << label << ": " << *bench.error << "\n";
+        ++regressions;
+      }
+      continue;
+    }
+    int products = base.get<int>("products");
+    double p_total = base.get<double>("p-total");
+    if (products != bench.products ||
+        std::abs(p_total - bench.p_total) >
+            kProbabilityTolerance * std::max(p_total, bench.p_total)) {
+      std::cerr << "CHANGED    " << label << ": products " << products
+                << " -> " << bench.products << ", p-total " << p_total
+                << " -> " << bench.p_total << "\n";
+      ++regressions;
+    }
+    Statistics stats(bench.times);
+    double median = base.get<double>("time.median");
+    double mad = base.get<double>("time.mad");
+    double slowdown = stats.median - median;
+    if (slowdown > tolerance * median &&
+        slowdown > std::max({3 * mad, 3 * stats.mad, kTimeResolution})) {
+      std::cerr << "SLOWER     " << label << ": " << median << " -> "
+                << stats.median << " s\n";
+      ++regressions;
+    }
+  }
+  return regressions;
+}
+
+/// Runs the benchmarks with the command-line options.
+///
+/// @returns The process exit code.
+int RunBench(const po::variables_map& vm) {
+  std::optional<std::regex> filter;
+  if (vm.count("filter"))
+    filter.emplace(vm["filter"].as<std::string>());
+  std::vector<Model> models =
+      FindModels(vm["input-dir"].as<std::string>(), filter);
+  if (vm.count("synthetic")) {
+    for (int num_basic : vm["synthetic"].as<std::vector<int>>()) {
+      Model model{"Synthetic/" + std::to_string(num_basic), {}, num_basic};
+      if (!filter || std::regex_match(model.name, *filter))
+        models.push_back(std::move(model));
+    }
+  }
+  if (vm.count("list")) {
+    for (const Model& model : models)
+      std::cout << model.name << "\n";
+    return 0;
+  }
+
+  auto get_names = [&vm](const char* option, const auto& all) {
+    if (vm.count(option))
+      return vm[option].as<std::vector<std::string>>();
+    return std::vector<std::string>(std::begin(all), std::end(all));
+  };
+  std::vector<std::string> algorithms =
+      get_names("algorithm", scram::core::kAlgorithmToString);
+  std::vector<std::string> approximations =
+      get_names("approximation", scram::core::kApproximationToString);
+  for (const std::string& algorithm : algorithms)
+    scram::core::Settings().algorithm(algorithm);  // Validation.
+  for (const std::string& approximation : approximations)
+    scram::core::Settings().approximation(approximation);
+  int warmup = vm["warmup"].as<int>();
+  int repetitions = vm["repetitions"].as<int>();
+  if (warmup < 0 || repetitions < 1) {
+    std::cerr << "The number of warm-up runs must be non-negative, "
+                 "and at least one repetition is required.\n";
+    return 1;
+  }
+
+  scram::core::Settings base_settings;
+  base_settings.probability_analysis(true);
+  if (vm.count("limit-order"))
+    base_settings.limit_order(vm["limit-order"].as<int>());
+
+  std::vector<Case> cases;
+  for (const Model& model : models) {
+    std::unique_ptr<scram::mef::Model> mef_model;
+    std::optional<std::string> error;
+    try {
+      if (model.synthetic) {
+        scram::mef::GeneratorFactors factors;
+        factors.num_basic = model.synthetic;
+        mef_model = scram::mef::GenerateFaultTree(factors);
+      } else {
+        mef_model =
+            scram::mef::Initializer(model.files, base_settings).model();
+      }
+    } catch (const scram::Error& err) {
+      error = err.what();
+    }
+    for (const std::string& algorithm : algorithms) {
+      for (const std::string& approximation : approximations) {
+        Case& bench =
+            cases.emplace_back(Case{&model, algorithm, approximation});
+        bench.error = error;
+        if (error)
+          continue;
+        scram::core::Settings settings = base_settings;
+        settings.algorithm(algorithm).approximation(approximation);
+        try {
+          Run(mef_model.get(), settings, warmup, repetitions, &bench);
+        } catch (const scram::Error& err) {
+          bench.error = err.what();
+        }
+        std::cerr << model.name << " " << algorithm << " " << approximation;
+        if (bench.error) {
+          std::cerr << ": error\n";
+        } else {
+          Statistics stats(bench.times);
+          std::cerr << ": " << stats.median << " s (+/- " << stats.mad
+                    << ")\n";
+        }
+      }
+    }
+  }
+
+  if (vm.count("output")) {
+    std::string file = vm["output"].as<std::string>();
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> out(
+        std::fopen(file.c_str(), "w"), &std::fclose);
+    if (!out) {
+      SCRAM_THROW(scram::IOError("Cannot open the output file."))
+          << boost::errinfo_errno(errno) << boost::errinfo_file_name(file)
+          << boost::errinfo_file_open_mode("w");
+    }
+    Report(cases, vm, out.get());
+  } else {
+    Report(cases, vm, stdout);
+  }
+
+  if (vm.count("baseline")) {
+    int regressions = Compare(cases, vm["baseline"].as<std::string>(),
+                              vm["tolerance"].as<double>());
+    if (regressions) {
+      std::cerr << regressions << " regression(s) against the baseline.\n";
+      return 1;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  LIBXML_TEST_VERSION
+  xmlInitParser();
+  SCOPE_EXIT(&xmlCleanupParser);
+
+  po::options_description desc = ConstructOptions();
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+  } catch (const std::exception& err) {
+    std::cerr << "Option error: " << err.what() << "\n\n"
+              << "Usage:    scram_bench [options]\n"
+              << desc << "\n";
+    return 1;
+  }
+  if (vm.count("help")) {
+    std::cout << "Usage:    scram_bench [options]\n" << desc << "\n";
+    return 0;
+  }
+
+  try {
+    return RunBench(vm);
+  } catch (const std::exception& err) {
+    std::cerr << "Error: " << err.what() << std::endl;
+    return 1;
+  }
+}
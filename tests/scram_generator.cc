@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Command-line front-end of the native fault tree generator.
+///
+/// The options mirror scripts/fault_tree_generator.py.
+
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "fault_tree_generator.h"
+#include "serialization.h"
+
+namespace po = boost::program_options;
+
+namespace {
+
+/// @returns Command-line option descriptions.
+po::options_description ConstructOptions() {
+  po::options_description desc("Options");
+  // clang-format off
+  desc.add_options()
+      ("help", "Display this help message")
+      ("ft-name", po::value<std::string>()->value_name("ncname")
+                      ->default_value("Autogenerated"),
+       "Name for the fault tree")
+      ("root", po::value<std::string>()->value_name("ncname")
+                   ->default_value("root"),
+       "Name for the root gate")
+      ("seed", po::value<std::uint32_t>()->value_name("int")
+                   ->default_value(123),
+       "Seed for the PRNG")
+      ("num-basic,b", po::value<int>()->value_name("int")->default_value(100),
+       "# of basic events")
+      ("num-gate,g", po::value<int>()->value_name("int")->default_value(0),
+       "Target # of gates (0 to estimate)")
+      ("num-args,a", po::value<double>()->value_name("float")
+                         ->default_value(3),
+       "Avg. # of gate arguments")
+      ("weights-g", po::value<std::vector<double>>()->multitoken()
+                        ->value_name("float"),
+       "Weights for [AND, OR, K/N, NOT, XOR] gates (default: 1 1 0 0 0)")
+      ("common-b", po::value<double>()->value_name("float")
+                       ->default_value(0.1),
+       "Fraction of gate arguments with shared basic events")
+      ("common-g", po::value<double>()->value_name("float")
+                       ->default_value(0.1),
+       "Fraction of gate arguments with shared gates")
+      ("max-depth", po::value<int>()->value_name("int")->default_value(0),
+       "Maximum depth of gates (0 for no limit)")
+      ("num-ccf", po::value<int>()->value_name("int")->default_value(0),
+       "# of CCF groups")
+      ("min-prob", po::value<double>()->value_name("float")
+                       ->default_value(0.01),
+       "Minimum probability for basic events")
+      ("max-prob", po::value<double>()->value_name("float")
+                       ->default_value(0.1),
+       "Maximum probability for basic events")
+      ("out,o", po::value<std::string>()->value_name("path"),
+       "File to write the fault tree in the MEF format");
+  // clang-format on
+  return desc;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  po::options_description desc = ConstructOptions();
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+  } catch (const std::exception& err) {
+    std::cerr << "Option error: " << err.what() << "\n\n"
+              << "Usage:    scram_generator [options]\n"
+              << desc << "\n";
+    return 1;
+  }
+  if (vm.count("help")) {
+    std::cout << "Usage:    scram_generator [options]\n" << desc << "\n";
+    return 0;
+  }
+
+  scram::mef::GeneratorFactors factors;
+  factors.ft_name = vm["ft-name"].as<std::string>();
+  factors.root = vm["root"].as<std::string>();
+  factors.seed = vm["seed"].as<std::uint32_t>();
+  factors.num_basic = vm["num-basic"].as<int>();
+  factors.num_gates = vm["num-gate"].as<int>();
+  factors.num_args = vm["num-args"].as<double>();
+  factors.common_b = vm["common-b"].as<double>();
+  factors.common_g = vm["common-g"].as<double>();
+  factors.max_depth = vm["max-depth"].as<int>();
+  factors.num_ccf = vm["num-ccf"].as<int>();
+  factors.min_prob = vm["min-prob"].as<double>();
+  factors.max_prob = vm["max-prob"].as<double>();
+  if (vm.count("weights-g")) {
+    const auto& weights = vm["weights-g"].as<std::vector<double>>();
+    if (weights.size() > factors.weights.size()) {
+      std::cerr << "Too many gate weights.\n";
+      return 1;
+    }
+    factors.weights.fill(0);
+    std::copy(weights.begin(), weights.end(), factors.weights.begin());
+  }
+
+  try {
+    auto start = std::chrono::steady_clock::now();
+    auto model = scram::mef::GenerateFaultTree(factors);
+    std::chrono::duration<double> time =
+        std::chrono::steady_clock::now() - start;
+    std::cout << "Gates: " << model->gates().size()
+              << "\nBasic events: " << model->basic_events().size()
+              << "\nCCF groups: " << model->ccf_groups().size()
+              << "\nGeneration time: " << time.count() << " s\n";
+    if (vm.count("out"))
+      scram::mef::Serialize(*model, vm["out"].as<std::string>());
+  } catch (const std::exception& err) {
+    std::cerr << "Error: " << err.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
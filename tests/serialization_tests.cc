@@ -21,6 +21,7 @@
 
 #include <catch.hpp>
 
+#include "ccf_group.h"
 #include "env.h"
 #include "initializer.h"
 #include "settings.h"
@@ -59,4 +60,30 @@ TEST_CASE("SerializationTest.InputOutput", "[mef::serialization]") {
   }
 }
 
+TEST_CASE("SerializationTest.CcfGroups", "[mef::serialization]") {
+  core::Settings settings;
+  settings.ccf_analysis(true);
+  auto model =
+      mef::Initializer({"input/TwoTrain/common_cause.xml"}, settings).model();
+  fs::path temp_file =
+      fs::temp_directory_path() / ("scram_test-" + fs::unique_path().string());
+  INFO("temp file: " + temp_file.string());
+  REQUIRE_NOTHROW(Serialize(*model, temp_file.string()));
+  std::unique_ptr<Model> loaded;
+  REQUIRE_NOTHROW(loaded =
+                      mef::Initializer({temp_file.string()}, settings).model());
+  fs::remove(temp_file);
+  CHECK(loaded->basic_events().size() == model->basic_events().size());
+  REQUIRE(loaded->ccf_groups().size() == model->ccf_groups().size());
+  for (const CcfGroup& ccf_group : model->ccf_groups()) {
+    auto it = loaded->ccf_groups().find(ccf_group.name());
+    REQUIRE(it != loaded->ccf_groups().end());
+    const CcfGroup& copy = *it;
+    CHECK(copy.members().size() == ccf_group.members().size());
+    CHECK(copy.distribution()->value() == ccf_group.distribution()->value());
+    REQUIRE(copy.factors().size() == ccf_group.factors().size());
+    CHECK(copy.factors().front().first == ccf_group.factors().front().first);
+  }
+}
+
 }  // namespace scram::mef::test
@@ -55,6 +55,12 @@ TEST_CASE("SettingsTest IncorrectSetup", "[settings]") {
   CHECK_NOTHROW(s.time_step(1));
   CHECK_NOTHROW(s.safety_integrity_levels(true));
   CHECK_THROWS_AS(s.time_step(0), SettingsError);
+  // Incorrect preprocessing budget.
+  CHECK_THROWS_AS(s.preprocessing_budget("coalescing", 1), SettingsError);
+  CHECK_THROWS_AS(s.preprocessing_budget("decomposition", -1), SettingsError);
+  // Incorrect BDD construction options.
+  CHECK_THROWS_AS(s.apply_schedule("random"), SettingsError);
+  CHECK_THROWS_AS(s.bdd_cache_limit(-1), SettingsError);
 }
 
 TEST_CASE("SettingsTest CorrectSetup", "[settings]") {
@@ -106,6 +112,18 @@ TEST_CASE("SettingsTest CorrectSetup", "[settings]") {
   // Correct request for the SIL.
   CHECK_NOTHROW(s.safety_integrity_levels(true));
   CHECK_NOTHROW(s.safety_integrity_levels(false));
+
+  // Correct preprocessing budget.
+  CHECK_NOTHROW(s.preprocessing_budget("merge-common-args", 0));
+  CHECK_NOTHROW(s.preprocessing_budget("decomposition", 0.5));
+  CHECK(s.preprocessing_budget(PreprocessorPass::kDecomposition) == 0.5);
+
+  // Correct BDD construction options.
+  CHECK_NOTHROW(s.apply_schedule("balanced"));
+  CHECK_NOTHROW(s.apply_schedule("smallest-first"));
+  CHECK(s.apply_schedule() == ApplySchedule::kSmallestFirst);
+  CHECK_NOTHROW(s.bdd_cache_limit(0));
+  CHECK_NOTHROW(s.bdd_cache_limit(1e6));
 }
 
 TEST_CASE("SettingsTest SetupForPrimeImplicants", "[settings]") {
@@ -122,4 +140,43 @@ TEST_CASE("SettingsTest SetupForPrimeImplicants", "[settings]") {
   CHECK_THROWS_AS(s.approximation("mcub"), SettingsError);
 }
 
+TEST_CASE("SettingsTest SetupForSharedSequenceBdd", "[settings]") {
+  Settings s;
+  // Incorrect request for the shared sequence BDD.
+  CHECK_NOTHROW(s.algorithm("zbdd"));
+  CHECK_THROWS_AS(s.shared_sequence_bdd(true), SettingsError);
+  // Correct request for the shared sequence BDD.
+  REQUIRE_NOTHROW(s.algorithm("bdd"));
+  REQUIRE_NOTHROW(s.shared_sequence_bdd(true));
+  CHECK_THROWS_AS(s.approximation("rare-event"), SettingsError);
+  // Switching the algorithm cancels the request.
+  REQUIRE_NOTHROW(s.algorithm("mocus"));
+  CHECK_FALSE(s.shared_sequence_bdd());
+}
+
+TEST_CASE("SettingsTest SetupForSharedTopEventBdd", "[settings]") {
+  Settings s;
+  CHECK_NOTHROW(s.algorithm("zbdd"));
+  CHECK_THROWS_AS(s.shared_top_event_bdd(true), SettingsError);
+  REQUIRE_NOTHROW(s.algorithm("bdd"));
+  REQUIRE_NOTHROW(s.shared_top_event_bdd(true));
+  CHECK_THROWS_AS(s.approximation("mcub"), SettingsError);
+  REQUIRE_NOTHROW(s.algorithm("zbdd"));
+  CHECK_FALSE(s.shared_top_event_bdd());
+}
+
+TEST_CASE("SettingsTest SetupForSensitivity", "[settings]") {
+  Settings s;
+  CHECK_THROWS_AS(s.sensitivity_parameter("lambda", {}), SettingsError);
+  CHECK_FALSE(s.probability_analysis());
+  REQUIRE_NOTHROW(s.sensitivity_parameter("lambda", {1e-3, 1e-2}));
+  CHECK(s.probability_analysis());
+  CHECK_NOTHROW(s.probability_analysis(false));
+  CHECK(s.probability_analysis());
+  CHECK_THROWS_AS(s.sensitivity_parameter("lambda", {1}), SettingsError);
+  REQUIRE_NOTHROW(s.sensitivity_parameter("mu", {1}));
+  REQUIRE(s.sensitivity_parameters().size() == 2);
+  CHECK(s.sensitivity_parameters().front().second.size() == 2);
+}
+
 }  // namespace scram::core::test
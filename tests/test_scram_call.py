@@ -14,8 +14,9 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 """Tests to command-line SCRAM with correct and incorrect arguments."""
 
+import json
 import os
-from subprocess import call
+from subprocess import PIPE, call, run
 
 import pytest
 
@@ -79,7 +80,24 @@ def test_fta_no_prob(tmpdir):
         # Test calls for prime implicants
         (["--prime-implicants", "--mocus"], False),
         (["--prime-implicants", "--rare-event"], False),
-        (["--prime-implicants", "--mcub"], False)
+        (["--prime-implicants", "--mcub"], False),
+        # Test the report output formats
+        (["--output-format", "xml"], True),
+        (["--output-format", "xml.gz"], True),
+        (["--output-format", "binary"], True),
+        (["--output-format", "json"], False),
+        # Test the preprocessing budgets
+        (["--preprocessing-budget", "decomposition=0.5",
+          "--preprocessing-budget", "distributivity=0"], True),
+        (["--preprocessing-budget", "decomposition"], False),
+        (["--preprocessing-budget", "decomposition=0.5s"], False),
+        (["--preprocessing-budget", "decomposition=-1"], False),
+        (["--preprocessing-budget", "normalization=1"], False),
+        # Test the BDD construction options
+        (["--apply-schedule", "smallest-first", "--bdd-cache-limit", "1000"],
+         True),
+        (["--apply-schedule", "random"], False),
+        (["--bdd-cache-limit", "-1"], False)
     ])
 def test_fta_calls(cmd, status):
     """Tests calls for full fault tree analysis."""
@@ -93,6 +111,103 @@ def test_fta_calls(cmd, status):
         assert ret != 0
 
 
+@pytest.mark.parametrize(
+    'cmd, status',
+    [
+        (["--sensitivity", "PumpFailure=0.01,0.1,0.5"], True),
+        (["--sensitivity", "PumpFailure=0.01", "--sensitivity",
+          "ValveFailure=0.1,0.3", "--importance", "--zbdd"], True),
+        (["--sensitivity", "PumpFailure"], False),
+        (["--sensitivity", "PumpFailure="], False),
+        (["--sensitivity", "PumpFailure=0.1,"], False),
+        (["--sensitivity", "PumpFailure=0.1;0.2"], False),
+        (["--sensitivity", "=0.1"], False),
+        (["--sensitivity", "PipeFailure=0.1"], False),
+    ])
+def test_sensitivity_calls(cmd, status):
+    """Tests calls for parametric sensitivity analysis."""
+    fta_input = "./input/fta/sensitivity.xml"
+    ret = call(["scram", fta_input] + cmd)
+    if status:
+        assert ret == 0
+    else:
+        assert ret != 0
+
+
+def test_model_cache(tmpdir):
+    """Tests the reuse of the initialized model snapshots."""
+    fta_input = "./input/fta/correct_tree_input_with_probs.xml"
+    cache_dir = tmpdir / "cache"
+    cmd = ["scram", fta_input, "--model-cache", str(cache_dir)]
+    assert call(cmd + ["-o", str(tmpdir / "first.xml")]) == 0
+    assert len(cache_dir.listdir()) == 1
+    assert call(cmd + ["-o", str(tmpdir / "second.xml")]) == 0
+    assert len(cache_dir.listdir()) == 1
+
+
+def test_pdag_cache(tmpdir):
+    """Tests the reuse of the preprocessed PDAG snapshots."""
+    fta_input = "./input/fta/correct_tree_input_with_probs.xml"
+    cache_dir = tmpdir / "cache"
+    cmd = ["scram", fta_input, "--probability", "--pdag-cache", str(cache_dir)]
+    assert call(cmd + ["-o", str(tmpdir / "first.xml")]) == 0
+    assert len(cache_dir.listdir()) == 1
+    assert call(cmd + ["-o", str(tmpdir / "second.xml")]) == 0
+    assert len(cache_dir.listdir()) == 1
+    assert call(cmd + ["--mocus", "-o", str(tmpdir / "third.xml")]) == 0
+    assert len(cache_dir.listdir()) == 2
+
+
+def test_metrics_output(tmpdir):
+    """Tests the JSON output of performance metrics."""
+    fta_input = "./input/fta/correct_tree_input_with_probs.xml"
+    metrics_file = str(tmpdir / "metrics.json")
+    cmd = [
+        "scram", fta_input, "--probability", "--uncertainty", "--metrics",
+        metrics_file, "-o",
+        str(tmpdir / "report.xml")
+    ]
+    assert call(cmd) == 0
+    with open(metrics_file) as json_file:
+        metrics = json.load(json_file)
+    assert len(metrics["results"]) == 1
+    result = metrics["results"][0]
+    assert result["name"] == "TopEvent"
+    assert result["products"]["metrics"]["pdag-gates"] > 0
+    assert result["products"]["preprocessing"]
+    assert result["probability"]["time"] >= 0
+    assert result["uncertainty"]["metrics"]["trials-per-second"] > 0
+
+
+def test_monitor():
+    """Tests the re-quantification requests on the standard input/output."""
+    requests = [
+        {"command": "recompute"},
+        {"command": "set-house-event", "event": "Maintenance", "value": True},
+        {"command": "set-probability", "event": "PumpA", "value": 0.5},
+        {"command": "set-probability", "event": "PumpA", "value": 2},
+        {"command": "unknown"},
+        {"command": "recompute"},
+        {"command": "quit"},
+    ]
+    cmd = ["scram", "--monitor", "./input/fta/monitor_house_event.xml"]
+    proc = run(cmd,
+               input="\n".join(json.dumps(x) for x in requests),
+               stdout=PIPE,
+               universal_newlines=True)
+    assert proc.returncode == 0
+    responses = [json.loads(line) for line in proc.stdout.splitlines()]
+    assert [x["status"] for x in responses] == [
+        "ok", "ok", "ok", "error", "error", "ok", "ok"
+    ]
+    initial = {x["name"]: x["probability"] for x in responses[0]["results"]}
+    assert initial["TopA"] == pytest.approx(0.084)
+    assert responses[5]["rebuilt"] == 1
+    final = {x["name"]: x["probability"] for x in responses[5]["results"]}
+    assert final["TopA"] == pytest.approx(0.5)
+    assert final["TopB"] == pytest.approx(initial["TopB"])
+
+
 def test_config_file_output(tmpdir):
     """Tests calls with configuration files."""
     # Test with a configuration file
@@ -156,4 +156,68 @@ TEST_CASE("XmlStreamTest.Full", "[xml_stream]") {
   fs::remove(temp_file);
 }
 
+TEST_CASE("XmlStreamTest.Numbers", "[xml_stream]") {
+  fs::path unique_name = "scram_xml_test-" + fs::unique_path().string();
+  fs::path temp_file = fs::temp_directory_path() / unique_name;
+  INFO("XML temp file: " + temp_file.string());
+  const int kNumElements = 10000;  // The output is larger than the buffer.
+  {
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
+        std::fopen(temp_file.string().c_str(), "w"), &std::fclose);
+    Stream xml_stream(fp.get(), /*indent=*/false);
+    StreamElement root = xml_stream.root("root");
+    for (int i = 0; i < kNumElements; ++i) {
+      root.AddChild("number")
+          .SetAttribute("index", i)
+          .SetAttribute("count", static_cast<std::size_t>(i))
+          .SetAttribute("value", 0.123456789 + i);
+    }
+    root.AddChild("value").AddText(-42).AddText(" ").AddText(1e-5).AddText(
+        " ").AddText(0.1);
+  }
+  std::stringstream str_stream;
+  str_stream << std::fstream(temp_file.string()).rdbuf();
+  std::string content = str_stream.str();
+  CHECK(content.find("<number index=\"0\" count=\"0\" "
+                     "value=\"0.123456789\"/>") != std::string::npos);
+  CHECK(content.find("<number index=\"9999\" count=\"9999\" "
+                     "value=\"9999.123456789\"/>") != std::string::npos);
+  CHECK(content.find("<value>-42 1e-05 0.1</value>") != std::string::npos);
+  CHECK(content.substr(content.size() - 8) == "</root>\n");
+  fs::remove(temp_file);
+}
+
+TEST_CASE("XmlStreamTest.Compressed", "[xml_stream]") {
+  fs::path unique_name = "scram_xml_test-" + fs::unique_path().string();
+  fs::path temp_file = fs::temp_directory_path() / unique_name;
+  INFO("XML temp file: " + temp_file.string());
+  auto write = [&temp_file](bool compress) {
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
+        std::fopen(temp_file.string().c_str(), "wb"), &std::fclose);
+    Stream xml_stream(fp.get(), /*indent=*/true, compress);
+    StreamElement root = xml_stream.root("root");
+    for (int i = 0; i < 10000; ++i)
+      root.AddChild("element").SetAttribute("value", 0.5 * i).AddText(i);
+  };
+  write(false);
+  std::stringstream str_stream;
+  str_stream << std::fstream(temp_file.string()).rdbuf();
+  std::string plain = str_stream.str();
+
+  write(true);
+  CHECK(fs::file_size(temp_file) < plain.size() / 4);
+  std::string content;
+  {
+    std::unique_ptr<gzFile_s, decltype(&gzclose)> gz(
+        gzopen(temp_file.string().c_str(), "rb"), &gzclose);
+    REQUIRE(gz);
+    CHECK(gzdirect(gz.get()) == 0);
+    char buffer[4096];
+    for (int len; (len = gzread(gz.get(), buffer, sizeof(buffer))) > 0;)
+      content.append(buffer, len);
+  }
+  CHECK(content == plain);
+  fs::remove(temp_file);
+}
+
 }  // namespace scram::xml::test